@@ -0,0 +1,107 @@
+/**
+ * @file BinaryRecord.hpp Compact, versioned binary encoding of SourceIDs, ComponentRequests and headers
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_BINARYRECORD_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_BINARYRECORD_HPP_
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/TimeSliceHeader.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Kind of object in a binary record, stored in the low four bits of its first byte
+ */
+enum class BinaryRecordType : uint8_t // NOLINT(build/unsigned)
+{
+  kSourceID = 1,
+  kComponentRequest = 2,
+  kFragmentHeader = 3,
+  kTriggerRecordHeaderData = 4,
+  kTimeSliceHeader = 5
+};
+
+/**
+ * @brief Version of the binary record encoding, stored in the high four bits of the first byte of each record
+ */
+constexpr uint8_t s_binary_record_version = 1; // NOLINT(build/unsigned)
+
+namespace detail {
+template<typename T>
+struct BinaryRecordTraits;
+} // namespace detail
+
+/**
+ * @brief Largest encoded size of one binary record of type T (SourceID, ComponentRequest or one of the headers)
+ */
+template<typename T>
+constexpr size_t s_binary_record_max_size = detail::BinaryRecordTraits<T>::s_max_size;
+
+/**
+ * @brief Append the binary record of an object to a buffer
+ * @param value SourceID, ComponentRequest, FragmentHeader, TriggerRecordHeaderData or TimeSliceHeader to encode
+ * @param out Buffer to append to
+ *
+ * Fields are stored as LEB128 varints in the order described in BinaryRecordV1.md; timestamps are stored as
+ * differences from the previous timestamp of the record, so that a typical FragmentHeader takes about 30 bytes instead
+ * of 72. Marker words and padding are not stored.
+ */
+template<typename T>
+void
+encode_binary(const T& value, std::vector<uint8_t>& out); // NOLINT(build/unsigned)
+
+/**
+ * @brief Append the binary records of an array of objects to a buffer
+ * @param values Objects to encode
+ * @param count Number of objects
+ * @param out Buffer to append to
+ */
+template<typename T>
+void
+encode_binary_all(const T* values, size_t count, std::vector<uint8_t>& out); // NOLINT(build/unsigned)
+
+/**
+ * @brief Decode one binary record
+ * @param first Start of the record
+ * @param last End of the buffer
+ * @param value Object to fill. Marker words and padding are set to their default values. It is only modified if
+ * decoding succeeds.
+ * @return One past the last byte of the record
+ * @throws std::invalid_argument if the record is truncated, is not of type T, has an unsupported version, or holds a
+ * value too large for its field. The message gives the offset of the offending byte from first.
+ */
+template<typename T>
+const uint8_t* // NOLINT(build/unsigned)
+decode_binary(const uint8_t* first, const uint8_t* last, T& value); // NOLINT(build/unsigned)
+
+/**
+ * @brief Decode a buffer of back-to-back binary records of the same type
+ * @param data Start of the buffer
+ * @param size Size of the buffer
+ * @return The decoded objects
+ * @throws std::invalid_argument as decode_binary does, with the offset from data
+ */
+template<typename T>
+std::vector<T>
+decode_binary_all(const uint8_t* data, size_t size); // NOLINT(build/unsigned)
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/BinaryRecord.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_BINARYRECORD_HPP_
@@ -0,0 +1,152 @@
+/**
+ * @file CharReader.hpp Bounded text reader used by the from_chars parsers
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHARREADER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHARREADER_HPP_
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Reads literal text and integers from a char range, without allocating
+ *
+ * The counterpart of CharWriter: parsing the output of a CharWriter with the same sequence of calls gives back the
+ * values written. The first failure is sticky, and result() reports where it happened: std::errc::invalid_argument if
+ * the text does not match, std::errc::result_out_of_range if an integer does not fit its type.
+ */
+class CharReader
+{
+public:
+  /**
+   * @brief Construct a CharReader over [first, last)
+   */
+  CharReader(const char* first, const char* last) noexcept
+    : m_position(first)
+    , m_last(last)
+  {}
+
+  /**
+   * @brief Consume a literal string
+   */
+  CharReader& expect(std::string_view text) noexcept
+  {
+    if (m_ec != std::errc())
+      return *this;
+    if (std::string_view(m_position, m_last - m_position).substr(0, text.size()) != text) {
+      m_ec = std::errc::invalid_argument;
+      return *this;
+    }
+    m_position += text.size();
+    return *this;
+  }
+
+  /**
+   * @brief Read an unsigned integer in decimal
+   */
+  template<typename T>
+  CharReader& read_dec(T& value) noexcept
+  {
+    static_assert(std::is_unsigned_v<T>, "CharReader only reads unsigned integers");
+    return read_integer_(value, 10);
+  }
+
+  /**
+   * @brief Read an unsigned integer in hexadecimal, without prefix
+   */
+  template<typename T>
+  CharReader& read_hex(T& value) noexcept
+  {
+    static_assert(std::is_unsigned_v<T>, "CharReader only reads unsigned integers");
+    return read_integer_(value, 16);
+  }
+
+  /**
+   * @brief Read a name made of letters, digits and underscores
+   */
+  CharReader& read_name(std::string_view& name) noexcept
+  {
+    if (m_ec != std::errc())
+      return *this;
+    auto end = m_position;
+    while (end != m_last && ((*end >= 'a' && *end <= 'z') || (*end >= 'A' && *end <= 'Z') ||
+                             (*end >= '0' && *end <= '9') || *end == '_'))
+      ++end;
+    if (end == m_position) {
+      m_ec = std::errc::invalid_argument;
+      return *this;
+    }
+    name = std::string_view(m_position, end - m_position);
+    m_position = end;
+    return *this;
+  }
+
+  /**
+   * @brief Read an object with its daqdataformats from_chars overload (SourceID, ComponentRequest, ...)
+   */
+  template<typename T>
+  CharReader& read_object(T& value) noexcept
+  {
+    if (m_ec != std::errc())
+      return *this;
+    auto parsed = from_chars(m_position, m_last, value); // Found by argument-dependent lookup
+    m_position = parsed.ptr;
+    m_ec = parsed.ec;
+    return *this;
+  }
+
+  /**
+   * @brief Mark the text just read as invalid, e.g. a name that is not in a table
+   * @param position Start of the invalid text
+   */
+  CharReader& fail(const char* position) noexcept
+  {
+    if (m_ec == std::errc()) {
+      m_position = position;
+      m_ec = std::errc::invalid_argument;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Whether everything read so far matched
+   */
+  bool ok() const noexcept { return m_ec == std::errc(); }
+
+  /**
+   * @brief Get the std::from_chars-style result: one past the last character read and no error, or the position of
+   * the first mismatch and its error
+   */
+  std::from_chars_result result() const noexcept { return { m_position, m_ec }; }
+
+private:
+  template<typename T>
+  CharReader& read_integer_(T& value, int base) noexcept
+  {
+    if (m_ec != std::errc())
+      return *this;
+    auto parsed = std::from_chars(m_position, m_last, value, base);
+    if (parsed.ec != std::errc())
+      m_ec = parsed.ec; // Leave m_position at the start of the integer
+    else
+      m_position = parsed.ptr;
+    return *this;
+  }
+
+  const char* m_position;
+  const char* m_last;
+  std::errc m_ec{};
+};
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHARREADER_HPP_
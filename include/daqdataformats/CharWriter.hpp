@@ -0,0 +1,132 @@
+/**
+ * @file CharWriter.hpp Bounded text writer used by the to_chars formatters
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHARWRITER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHARWRITER_HPP_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Buffer size sufficient for the output of any of the daqdataformats to_chars overloads
+ */
+constexpr size_t s_to_chars_max_size = 512;
+
+/**
+ * @brief Writes text and integers into a caller-supplied char range, without allocating
+ *
+ * Integers are written as std::ostream writes them with default flags. Once the range is full, further writes are
+ * dropped and result() reports std::errc::value_too_large, as std::to_chars does.
+ */
+class CharWriter
+{
+public:
+  /**
+   * @brief Construct a CharWriter over [first, last)
+   */
+  CharWriter(char* first, char* last) noexcept
+    : m_position(first)
+    , m_last(last)
+  {}
+
+  /**
+   * @brief Write a string, without terminating null character
+   */
+  CharWriter& write(std::string_view text) noexcept
+  {
+    if (m_failed || static_cast<size_t>(m_last - m_position) < text.size()) {
+      m_failed = true;
+      return *this;
+    }
+    std::memcpy(m_position, text.data(), text.size());
+    m_position += text.size();
+    return *this;
+  }
+
+  /**
+   * @brief Write an unsigned integer in decimal
+   */
+  template<typename T>
+  CharWriter& write_dec(T value) noexcept
+  {
+    static_assert(std::is_unsigned_v<T>, "CharWriter only writes unsigned integers");
+    return write_integer_(value, 10);
+  }
+
+  /**
+   * @brief Write an unsigned integer in lowercase hexadecimal, without prefix
+   * @param value Integer to write
+   * @param min_width Pad with leading zeros to at least this many digits
+   */
+  template<typename T>
+  CharWriter& write_hex(T value, size_t min_width = 0) noexcept
+  {
+    static_assert(std::is_unsigned_v<T>, "CharWriter only writes unsigned integers");
+    char digits[2 * sizeof(T)];
+    auto end = std::to_chars(digits, digits + sizeof(digits), value, 16).ptr;
+    for (auto num_digits = static_cast<size_t>(end - digits); num_digits < min_width; ++num_digits)
+      write("0");
+    return write(std::string_view(digits, end - digits));
+  }
+
+  /**
+   * @brief Write an object with its daqdataformats to_chars overload (SourceID, ComponentRequest, ...)
+   */
+  template<typename T>
+  CharWriter& write_object(const T& value) noexcept
+  {
+    if (m_failed)
+      return *this;
+    auto converted = to_chars(m_position, m_last, value); // Found by argument-dependent lookup
+    if (converted.ec != std::errc())
+      m_failed = true;
+    else
+      m_position = converted.ptr;
+    return *this;
+  }
+
+  /**
+   * @brief Get the std::to_chars-style result: one past the last character written and no error, or last and
+   * std::errc::value_too_large if the output did not fit
+   */
+  std::to_chars_result result() const noexcept
+  {
+    if (m_failed)
+      return { m_last, std::errc::value_too_large };
+    return { m_position, std::errc() };
+  }
+
+private:
+  template<typename T>
+  CharWriter& write_integer_(T value, int base) noexcept
+  {
+    if (m_failed)
+      return *this;
+    auto converted = std::to_chars(m_position, m_last, value, base);
+    if (converted.ec != std::errc())
+      m_failed = true;
+    else
+      m_position = converted.ptr;
+    return *this;
+  }
+
+  char* m_position;
+  char* m_last;
+  bool m_failed{ false };
+};
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHARWRITER_HPP_
@@ -0,0 +1,107 @@
+/**
+ * @file Checksum.hpp CRC32C checksums of Fragment images, kept in a side table
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHECKSUM_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHECKSUM_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Compute the CRC32C (Castagnoli) of a buffer
+ * @param data Start of the buffer
+ * @param size Size of the buffer
+ * @param crc CRC32C of the data preceding the buffer, to checksum a sequence of buffers piece by piece
+ * @return CRC32C of the preceding data followed by the buffer
+ *
+ * Uses the SSE4.2 crc32 instruction, on three interleaved streams, when the CPU supports it (more than 10 GB/s per
+ * core on large buffers), and a slicing-by-8 table implementation otherwise.
+ */
+inline uint32_t                                                  // NOLINT(build/unsigned)
+crc32c(const void* data, size_t size, uint32_t crc = 0) noexcept; // NOLINT(build/unsigned)
+
+/**
+ * @brief CRC32C of a Fragment image (header and payload), as stored in a checksum side table
+ *
+ * FragmentHeader has no integrity field, so checksums travel next to the Fragments, e.g. one entry per Fragment of a
+ * TriggerRecord, in Fragment order. The checksum covers the header too, so it must be computed after the last header
+ * change.
+ */
+struct FragmentChecksum
+{
+  /**
+   * @brief The current version of the FragmentChecksum
+   */
+  static constexpr uint32_t s_fragment_checksum_version = 1; // NOLINT(build/unsigned)
+
+  uint32_t version{ s_fragment_checksum_version }; ///< Version of this structure // NOLINT(build/unsigned)
+  uint32_t crc32c{ 0 };                            ///< CRC32C of the Fragment image // NOLINT(build/unsigned)
+  SourceID element_id;                             ///< element_id of the Fragment, to match the entry
+  fragment_size_t size{ 0 };                       ///< Size of the Fragment image
+};
+
+static_assert(sizeof(FragmentChecksum) == 24, "FragmentChecksum struct size different than expected!");
+static_assert(offsetof(FragmentChecksum, version) == 0, "FragmentChecksum version field not at expected offset!");
+static_assert(offsetof(FragmentChecksum, crc32c) == 4, "FragmentChecksum crc32c field not at expected offset!");
+static_assert(offsetof(FragmentChecksum, element_id) == 8, "FragmentChecksum element_id field not at expected offset!");
+static_assert(offsetof(FragmentChecksum, size) == 16, "FragmentChecksum size field not at expected offset!");
+
+/**
+ * @brief Compute the checksum of a Fragment
+ */
+inline FragmentChecksum
+compute_checksum(const Fragment& fragment);
+
+/**
+ * @brief Check a Fragment against its checksum
+ * @return Whether the Fragment size and CRC32C match the checksum
+ * @throws std::invalid_argument if the checksum version is not supported
+ */
+inline bool
+verify(const Fragment& fragment, const FragmentChecksum& checksum);
+
+/**
+ * @brief Compute the checksums of the Fragments of a TriggerRecord, in Fragment order
+ * @param record TriggerRecord to checksum
+ * @param n_threads Number of threads to spread the Fragments over, 0 for one per hardware thread. The calling thread
+ * is one of them.
+ */
+inline std::vector<FragmentChecksum>
+compute_checksums(const TriggerRecord& record, size_t n_threads = 1);
+
+/**
+ * @brief Check the Fragments of a TriggerRecord against their checksums
+ * @param record TriggerRecord to check
+ * @param checksums Checksums of the Fragments, in Fragment order
+ * @param n_threads Number of threads to spread the Fragments over, as in compute_checksums
+ * @return Indices of the Fragments that do not match their checksum, in increasing order
+ * @throws std::length_error if the number of checksums differs from the number of Fragments
+ * @throws std::invalid_argument if a checksum version is not supported
+ */
+inline std::vector<size_t>
+verify(const TriggerRecord& record, const std::vector<FragmentChecksum>& checksums, size_t n_threads = 1);
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/Checksum.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CHECKSUM_HPP_
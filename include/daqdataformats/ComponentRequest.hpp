@@ -9,9 +9,12 @@
 #ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_COMPONENTREQUEST_HPP_
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_COMPONENTREQUEST_HPP_
 
+#include "daqdataformats/CharReader.hpp"
+#include "daqdataformats/CharWriter.hpp"
 #include "daqdataformats/SourceID.hpp"
 #include "daqdataformats/Types.hpp"
 
+#include <charconv>
 #include <cstddef>
 #include <iostream>
 #include <ostream>
@@ -73,6 +76,48 @@ operator<<(std::ostream& o, ComponentRequest const& cr)
   return o << cr.component << ", begin: " << cr.window_begin << ", end: " << cr.window_end;
 }
 
+/**
+ * @brief Write a ComponentRequest into a buffer, as operator<< streams it, without allocating
+ * @param first Start of the buffer
+ * @param last End of the buffer
+ * @param cr ComponentRequest to write
+ * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+ */
+inline std::to_chars_result
+to_chars(char* first, char* last, ComponentRequest const& cr) noexcept
+{
+  return CharWriter(first, last)
+    .write_object(cr.component)
+    .write(", begin: ")
+    .write_dec(cr.window_begin)
+    .write(", end: ")
+    .write_dec(cr.window_end)
+    .result();
+}
+
+/**
+ * @brief Parse a ComponentRequest from the text written by operator<< and to_chars, without allocating
+ * @param first Start of the text
+ * @param last End of the text
+ * @param cr ComponentRequest to fill. It is only modified if parsing succeeds.
+ * @return One past the last character parsed, or the position of the first mismatch and std::errc::invalid_argument
+ * (or std::errc::result_out_of_range for a number too large for its field)
+ */
+inline std::from_chars_result
+from_chars(const char* first, const char* last, ComponentRequest& cr) noexcept
+{
+  ComponentRequest parsed = cr;
+  CharReader reader(first, last);
+  reader.read_object(parsed.component)
+    .expect(", begin: ")
+    .read_dec(parsed.window_begin)
+    .expect(", end: ")
+    .read_dec(parsed.window_end);
+  if (reader.ok())
+    cr = parsed;
+  return reader.result();
+}
+
 /**
  * @brief Read a ComponentRequest from a string stream
  * @param is Input stream
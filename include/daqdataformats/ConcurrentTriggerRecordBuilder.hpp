@@ -0,0 +1,139 @@
+/**
+ * @file ConcurrentTriggerRecordBuilder.hpp Lock-free assembly of a TriggerRecord from Fragments added by many threads
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CONCURRENTTRIGGERRECORDBUILDER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CONCURRENTTRIGGERRECORDBUILDER_HPP_
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/SourceIDIndex.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Assembles a TriggerRecord from Fragments added concurrently, without locks
+ *
+ * There is one slot per ComponentRequest of the TriggerRecordHeader. add_fragment() finds the slot of the Fragment's
+ * element_id in a SourceIDIndex built at construction, and claims it with a compare-and-swap, so producers of
+ * different components never wait for each other. When a SourceID is requested more than once, its Fragments fill
+ * the slots of the requests in order. An atomic countdown of the empty slots tells the producer of the last Fragment
+ * that the record is complete.
+ *
+ * finalize() moves the Fragments into a TriggerRecord in request order. It may run concurrently with add_fragment(),
+ * e.g. when the record times out: each Fragment is then either in the TriggerRecord or refused with kFinalized.
+ */
+class ConcurrentTriggerRecordBuilder
+{
+public:
+  /**
+   * @brief Outcome of add_fragment()
+   */
+  enum class AddResult : uint8_t // NOLINT(build/unsigned)
+  {
+    kAdded,           ///< The Fragment took its slot
+    kCompleted,       ///< The Fragment took the last empty slot; exactly one add_fragment() returns this
+    kUnknownSourceID, ///< No ComponentRequest has the Fragment's element_id
+    kDuplicate,       ///< All the slots of the Fragment's element_id are already taken
+    kFinalized        ///< finalize() was called
+  };
+
+  /**
+   * @brief Construct a ConcurrentTriggerRecordBuilder for the components of the given TriggerRecordHeader
+   * @param header TriggerRecordHeader to *copy* into the TriggerRecord
+   */
+  explicit ConcurrentTriggerRecordBuilder(TriggerRecordHeader const& header)
+    : ConcurrentTriggerRecordBuilder(TriggerRecordHeader(header))
+  {
+  }
+
+  /**
+   * @brief Construct a ConcurrentTriggerRecordBuilder taking over the given TriggerRecordHeader
+   * @param header TriggerRecordHeader to *move* into the TriggerRecord. A non-owning header stays non-owning, and
+   * its buffer must outlive the finalized TriggerRecord.
+   */
+  inline explicit ConcurrentTriggerRecordBuilder(TriggerRecordHeader&& header);
+
+  /**
+   * @brief ConcurrentTriggerRecordBuilder destructor, deleting the Fragments that were not finalized
+   */
+  inline ~ConcurrentTriggerRecordBuilder();
+
+  ConcurrentTriggerRecordBuilder(ConcurrentTriggerRecordBuilder const&) = delete; ///< Not copy-constructible
+  ConcurrentTriggerRecordBuilder& operator=(ConcurrentTriggerRecordBuilder const&) = delete; ///< Not copy-assignable
+  ConcurrentTriggerRecordBuilder(ConcurrentTriggerRecordBuilder&&) = delete;            ///< Not move-constructible
+  ConcurrentTriggerRecordBuilder& operator=(ConcurrentTriggerRecordBuilder&&) = delete; ///< Not move-assignable
+
+  /**
+   * @brief Add a Fragment to the slot of its element_id. Safe to call from any number of threads.
+   * @param fragment Fragment to add. It is only taken when the result is kAdded or kCompleted.
+   */
+  inline AddResult add_fragment(std::unique_ptr<Fragment>&& fragment);
+
+  /**
+   * @brief Whether every slot has been filled
+   */
+  bool is_complete() const { return get_num_missing() == 0; }
+
+  /**
+   * @brief Number of slots still empty
+   */
+  size_t get_num_missing() const { return m_num_missing.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Number of slots, i.e. of ComponentRequests
+   */
+  size_t get_num_slots() const { return m_slots.size(); }
+
+  /**
+   * @brief Get a handle to the TriggerRecordHeader, e.g. to set fields before finalize()
+   *
+   * The ComponentRequests must not be modified. The header is moved into the TriggerRecord by finalize().
+   */
+  const TriggerRecordHeader& get_header_ref() const { return m_header; }
+  TriggerRecordHeader& get_header_ref() { return m_header; }
+
+  /**
+   * @brief Move the Fragments into a TriggerRecord, in ComponentRequest order, and close the slots
+   * @return TriggerRecord with the TriggerRecordHeader and the Fragments added so far. Its kIncomplete error bit is
+   * set if some slots were empty.
+   * @throws std::logic_error if finalize() was already called
+   */
+  inline TriggerRecord finalize();
+
+private:
+  /**
+   * @brief Value of a slot after finalize(), which no Fragment can take. It is never dereferenced.
+   */
+  static Fragment* closed_slot_() { return reinterpret_cast<Fragment*>(&s_closed_slot_target); } // NOLINT
+
+  static inline char s_closed_slot_target = 0; ///< Object whose address marks the closed slots
+
+  TriggerRecordHeader m_header;
+  SourceIDIndex m_slot_index;                  ///< First slot of each SourceID
+  std::vector<size_t> m_next_same_source;      ///< Next slot with the same SourceID, or the number of slots if none
+  std::vector<std::atomic<Fragment*>> m_slots; ///< Fragment of each ComponentRequest, nullptr while empty
+  std::atomic<size_t> m_num_missing;           ///< Number of empty slots
+  std::atomic<bool> m_finalized{ false };      ///< Whether finalize() was called
+};
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/ConcurrentTriggerRecordBuilder.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_CONCURRENTTRIGGERRECORDBUILDER_HPP_
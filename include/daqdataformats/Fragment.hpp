@@ -14,13 +14,16 @@
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENT_HPP_
 
 #include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/Instrumentation.hpp"
 #include "daqdataformats/SourceID.hpp"
 #include "daqdataformats/Types.hpp"
 
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory_resource>
 #include <new>
 #include <numeric>
 #include <stdexcept>
@@ -31,6 +34,8 @@ namespace dunedaq {
 
 namespace daqdataformats {
 
+class FragmentBuilder;
+
 /**
  * @brief C++ Representation of a DUNE Fragment, wrapping the flat byte array that is the Fragment's "actual" form
  */
@@ -50,20 +55,30 @@ public:
   /**
    * @brief Fragment constructor using a vector of buffer pointers
    * @param pieces Vector of pairs of pointer/size pairs used to initialize Fragment payload
+   * @param memory_resource Memory resource to allocate the Fragment array from (nullptr means malloc/free)
    */
-  inline explicit Fragment(const std::vector<std::pair<void*, size_t>>& pieces);
+  inline explicit Fragment(const std::vector<std::pair<void*, size_t>>& pieces,
+                           std::pmr::memory_resource* memory_resource = nullptr);
   /**
    * @brief Fragment constructor using a buffer and size
    * @param buffer Pointer to Fragment payload
    * @param size Size of payload
+   * @param memory_resource Memory resource to allocate the Fragment array from (nullptr means malloc/free)
    */
-  inline Fragment(void* buffer, size_t size);
+  inline Fragment(void* buffer, size_t size, std::pmr::memory_resource* memory_resource = nullptr);
   /**
    * @brief Framgnet constructor using existing Fragment array
    * @param existing_fragment_buffer Pointer to existing Fragment array
    * @param adoption_mode How the constructor should treat the existing_fragment_buffer
+   * @param memory_resource Memory resource the Fragment array is allocated from (kCopyFromBuffer) or was allocated
+   * from (kTakeOverBuffer), nullptr means malloc/free. Unused in kReadOnlyMode.
+   * @param alloc_size Size the taken over buffer was allocated with, if larger than the Fragment (kTakeOverBuffer
+   * only). 0 means the allocation is exactly the size in the Fragment's header.
    */
-  inline explicit Fragment(void* existing_fragment_buffer, BufferAdoptionMode adoption_mode);
+  inline explicit Fragment(void* existing_fragment_buffer,
+                           BufferAdoptionMode adoption_mode,
+                           std::pmr::memory_resource* memory_resource = nullptr,
+                           size_t alloc_size = 0);
 
   Fragment(Fragment const&) = delete;            ///< Fragment copy constructor is deleted
   Fragment& operator=(Fragment const&) = delete; ///< Fragment copy assignment operator is deleted
@@ -72,12 +87,20 @@ public:
     m_alloc = other.m_alloc;
     other.m_alloc = false;
     m_data_arr = other.m_data_arr;
+    m_memory_resource = other.m_memory_resource;
+    m_alloc_size = other.m_alloc_size;
   }
   Fragment& operator=(Fragment&& other)
   {
+    if (&other == this)
+      return *this;
+
+    deallocate_();
     m_alloc = other.m_alloc;
     other.m_alloc = false;
     m_data_arr = other.m_data_arr;
+    m_memory_resource = other.m_memory_resource;
+    m_alloc_size = other.m_alloc_size;
     return *this;
   }
 
@@ -89,7 +112,11 @@ public:
    * @brief Get a copy of the FragmentHeader struct
    * @return A copy of the FragmentHeader struct stored in this Fragment
    */
-  FragmentHeader get_header() const { return *header_(); }
+  FragmentHeader get_header() const
+  {
+    instrumentation::record_fragment_copy(header_()->fragment_type, sizeof(FragmentHeader));
+    return *header_();
+  }
   /**
    * @brief Copy fields from the provided header in this Fragment's header
    * @param header Header to copy into the Fragment data array
@@ -104,6 +131,18 @@ public:
    */
   const void* get_storage_location() const { return m_data_arr; }
 
+  /**
+   * @brief Get the memory resource the Fragment's data array is returned to on destruction
+   * @return Pointer to the memory resource, or nullptr if the array is managed with malloc/free
+   */
+  std::pmr::memory_resource* get_memory_resource() const { return m_memory_resource; }
+
+  /**
+   * @brief Whether the Fragment owns its data array
+   * @return false if the Fragment was constructed in kReadOnlyMode, i.e. it points into memory owned by someone else
+   */
+  bool owns_buffer() const noexcept { return m_alloc; }
+
   // Header setters and getters
   /**
    * @brief Get the trigger_number field from the header
@@ -222,7 +261,13 @@ public:
    * @brief Set the fragment_type header field
    * @param fragment_type Value to set
    */
-  void set_type(FragmentType fragment_type) { header_()->fragment_type = static_cast<fragment_type_t>(fragment_type); }
+  void set_type(FragmentType fragment_type)
+  {
+    if (m_alloc)
+      instrumentation::record_fragment_type_change(
+        header_()->fragment_type, static_cast<fragment_type_t>(fragment_type), m_alloc_size);
+    header_()->fragment_type = static_cast<fragment_type_t>(fragment_type);
+  }
 
   /**
    * @brief Get the sequence_number field from the header
@@ -263,13 +308,26 @@ private:
    * @return Pointer to the FragmentHeader
    */
   FragmentHeader* header_() const { return static_cast<FragmentHeader*>(m_data_arr); }
+  /**
+   * @brief Allocate m_data_arr from m_memory_resource (or malloc) and take ownership of it
+   * @param size Number of bytes to allocate
+   */
+  inline void allocate_(size_t size);
+  /**
+   * @brief Release m_data_arr to where it came from, if this Fragment owns it
+   */
+  inline void deallocate_();
+
   void* m_data_arr{ nullptr }; ///< Flat memory containing a FragmentHeader and the data payload
   bool m_alloc{ false };       ///< Whether the Fragment owns the memory pointed by m_data_arr
+  std::pmr::memory_resource* m_memory_resource{ nullptr }; ///< Where m_data_arr is returned to, nullptr for free()
+  size_t m_alloc_size{ 0 }; ///< Size of the m_data_arr allocation, as required by memory_resource::deallocate
 };
 
 // ------
 
-Fragment::Fragment(const std::vector<std::pair<void*, size_t>>& pieces)
+Fragment::Fragment(const std::vector<std::pair<void*, size_t>>& pieces, std::pmr::memory_resource* memory_resource)
+  : m_memory_resource(memory_resource)
 {
 
   size_t size = sizeof(FragmentHeader) +
@@ -279,19 +337,18 @@ Fragment::Fragment(const std::vector<std::pair<void*, size_t>>& pieces)
     throw std::length_error("The Fragment size is smaller than the Fragment header size.");
   }
 
-  m_data_arr = malloc(size); // NOLINT(build/unsigned)
-  if (m_data_arr == nullptr) {
-    throw std::bad_alloc();
-  }
-  m_alloc = true;
+  allocate_(size);
 
   FragmentHeader header;
   header.size = size;
   memcpy(m_data_arr, &header, sizeof(header));
+  instrumentation::record_fragment_allocation(header.fragment_type, size);
+  instrumentation::record_fragment_copy(header.fragment_type, size);
 
   size_t offset = sizeof(FragmentHeader);
   for (auto& piece : pieces) {
     if (piece.first == nullptr) {
+      deallocate_();
       throw std::invalid_argument("The Fragment buffer point to NULL.");
     }
     memcpy(static_cast<uint8_t*>(m_data_arr) + offset, piece.first, piece.second); // NOLINT(build/unsigned)
@@ -299,32 +356,73 @@ Fragment::Fragment(const std::vector<std::pair<void*, size_t>>& pieces)
   }
 }
 
-Fragment::Fragment(void* buffer, size_t size)
-  : Fragment({ std::make_pair(buffer, size) })
+Fragment::Fragment(void* buffer, size_t size, std::pmr::memory_resource* memory_resource)
+  : Fragment({ std::make_pair(buffer, size) }, memory_resource)
 {}
 
-Fragment::Fragment(void* existing_fragment_buffer, BufferAdoptionMode adoption_mode)
+Fragment::Fragment(void* existing_fragment_buffer,
+                   BufferAdoptionMode adoption_mode,
+                   std::pmr::memory_resource* memory_resource,
+                   size_t alloc_size)
 {
   if (adoption_mode == BufferAdoptionMode::kReadOnlyMode) {
     m_data_arr = existing_fragment_buffer;
   } else if (adoption_mode == BufferAdoptionMode::kTakeOverBuffer) {
     m_data_arr = existing_fragment_buffer;
+    if (alloc_size != 0 && alloc_size < header_()->size) {
+      throw std::invalid_argument("The allocation size is smaller than the Fragment size.");
+    }
     m_alloc = true;
+    m_memory_resource = memory_resource;
+    m_alloc_size = alloc_size != 0 ? alloc_size : header_()->size;
+    instrumentation::record_fragment_allocation(header_()->fragment_type, m_alloc_size);
   } else if (adoption_mode == BufferAdoptionMode::kCopyFromBuffer) {
-    auto header = reinterpret_cast<FragmentHeader*>(existing_fragment_buffer); // NOLINT
-    m_data_arr = malloc(header->size);
+    // The buffer need not be aligned for a FragmentHeader, so its size field is read with memcpy
+    fragment_size_t size;
+    memcpy(&size,
+           static_cast<uint8_t*>(existing_fragment_buffer) + offsetof(FragmentHeader, size), // NOLINT(build/unsigned)
+           sizeof(size));
+    m_memory_resource = memory_resource;
+    allocate_(size);
+    memcpy(m_data_arr, existing_fragment_buffer, size);
+    instrumentation::record_fragment_allocation(header_()->fragment_type, m_alloc_size);
+    instrumentation::record_fragment_copy(header_()->fragment_type, m_alloc_size);
+  }
+}
+
+Fragment::~Fragment()
+{
+  deallocate_();
+}
+
+void
+Fragment::allocate_(size_t size)
+{
+  if (m_memory_resource != nullptr) {
+    m_data_arr = m_memory_resource->allocate(size, alignof(std::max_align_t));
+  } else {
+    m_data_arr = malloc(size); // NOLINT(build/unsigned)
     if (m_data_arr == nullptr) {
       throw std::bad_alloc();
     }
-    m_alloc = true;
-    memcpy(m_data_arr, existing_fragment_buffer, header->size);
   }
+  m_alloc = true;
+  m_alloc_size = size;
 }
 
-Fragment::~Fragment()
+void
+Fragment::deallocate_()
 {
-  if (m_alloc)
+  if (!m_alloc)
+    return;
+
+  instrumentation::record_fragment_free(header_()->fragment_type, m_alloc_size);
+  if (m_memory_resource != nullptr) {
+    m_memory_resource->deallocate(m_data_arr, m_alloc_size, alignof(std::max_align_t));
+  } else {
     free(m_data_arr);
+  }
+  m_alloc = false;
 }
 
 void
@@ -338,7 +436,7 @@ Fragment::set_header_fields(const FragmentHeader& header)
   header_()->element_id = header.element_id;
   header_()->detector_id = header.detector_id;
   header_()->error_bits = header.error_bits;
-  header_()->fragment_type = header.fragment_type;
+  set_type(static_cast<FragmentType>(header.fragment_type));
   header_()->sequence_number = header.sequence_number;
 }
 
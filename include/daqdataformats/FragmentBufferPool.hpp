@@ -0,0 +1,356 @@
+/**
+ * @file FragmentBufferPool.hpp Size-class pool of Fragment buffers with per-thread caches
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTBUFFERPOOL_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTBUFFERPOOL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief memory_resource handing out Fragment-sized buffers from power-of-two size classes
+ *
+ * Freed buffers are kept on per-thread free lists and exchanged in batches with a shared, mutex-protected depot, so
+ * that in steady state allocation and deallocation do not touch the system allocator nor take a lock. Pass a pointer
+ * to the pool to the Fragment (or TriggerRecordHeader) constructors to have the buffer returned to the pool when the
+ * object is destroyed.
+ *
+ * Requests larger than the largest size class, or with an alignment stricter than alignof(std::max_align_t), are
+ * forwarded to malloc/free and the default memory_resource respectively.
+ */
+class FragmentBufferPool : public std::pmr::memory_resource
+{
+public:
+  static constexpr size_t s_min_block_size = 1 << 7;   ///< Block size of the smallest size class
+  static constexpr size_t s_num_size_classes = 20;     ///< Number of size classes (128 B to 64 MiB)
+  static constexpr size_t s_default_batch_size = 16;   ///< Default number of blocks moved per refill/drain
+  static constexpr size_t s_max_batch_bytes = 1 << 22; ///< A batch never holds more than this many bytes
+  static constexpr size_t s_default_max_depot_bytes_per_class = size_t(1) << 28; ///< Default depot capacity
+
+  /**
+   * @brief Construct a FragmentBufferPool
+   * @param batch_size Number of blocks moved between a thread cache and the depot at once
+   * @param max_depot_bytes_per_class Bytes the depot keeps per size class before returning blocks to the system
+   */
+  inline explicit FragmentBufferPool(size_t batch_size = s_default_batch_size,
+                                     size_t max_depot_bytes_per_class = s_default_max_depot_bytes_per_class);
+
+  /**
+   * @brief FragmentBufferPool destructor
+   *
+   * Blocks held by the depot are released. Blocks still cached by other threads are released when those threads
+   * exit; blocks still in use must not be deallocated after the pool is gone.
+   */
+  inline ~FragmentBufferPool() override;
+
+  FragmentBufferPool(FragmentBufferPool const&) = delete;            ///< FragmentBufferPool is not copy-constructible
+  FragmentBufferPool& operator=(FragmentBufferPool const&) = delete; ///< FragmentBufferPool is not copy-assignable
+  FragmentBufferPool(FragmentBufferPool&&) = delete;                 ///< FragmentBufferPool is not move-constructible
+  FragmentBufferPool& operator=(FragmentBufferPool&&) = delete;      ///< FragmentBufferPool is not move-assignable
+
+  /**
+   * @brief Get the size class serving allocations of the given size
+   * @param bytes Size of the allocation
+   * @return Index of the size class, or s_num_size_classes if the allocation is too large to be pooled
+   */
+  static inline size_t size_class_for(size_t bytes) noexcept;
+
+  /**
+   * @brief Get the block size of a size class
+   * @param size_class Index of the size class
+   * @return Size in bytes of the blocks in the given size class
+   */
+  static constexpr size_t block_size(size_t size_class) noexcept { return s_min_block_size << size_class; }
+
+  /**
+   * @brief Get the number of blocks of a size class moved per refill/drain
+   * @param size_class Index of the size class
+   * @return Batch size for the given size class
+   */
+  size_t batch_size(size_t size_class) const noexcept
+  {
+    return std::max<size_t>(1, std::min(m_batch_size, s_max_batch_bytes / block_size(size_class)));
+  }
+
+  /**
+   * @brief Get the number of free blocks currently held by the shared depot
+   * @param size_class Index of the size class
+   * @return Number of free blocks of the given size class in the depot
+   */
+  inline size_t get_depot_block_count(size_t size_class) const;
+
+  /**
+   * @brief Move the calling thread's cached blocks back into the shared depot
+   */
+  inline void flush_thread_cache();
+
+  /**
+   * @brief Return all blocks held by the shared depot to the system
+   */
+  inline void release();
+
+private:
+  using FreeLists = std::array<std::vector<void*>, s_num_size_classes>;
+
+  /**
+   * @brief Free lists shared by all threads. Outlives the pool while thread caches still refer to it.
+   */
+  struct Depot
+  {
+    std::mutex mutex;
+    FreeLists free_lists;
+    std::atomic<bool> pool_destroyed{ false };
+
+    inline ~Depot();
+  };
+
+  /**
+   * @brief Free lists of one thread for one pool
+   */
+  struct ThreadCache
+  {
+    std::shared_ptr<Depot> depot;
+    FreeLists free_lists;
+
+    inline ~ThreadCache();
+  };
+
+  /**
+   * @brief All ThreadCaches of the calling thread, one per pool it has used
+   */
+  struct ThreadCacheRegistry
+  {
+    std::vector<std::unique_ptr<ThreadCache>> caches;
+    ThreadCache* last_used{ nullptr };
+  };
+
+  inline void* do_allocate(size_t bytes, size_t alignment) override;
+  inline void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  /**
+   * @brief Get the calling thread's cache for this pool, creating it if needed
+   */
+  inline ThreadCache& thread_cache_();
+  inline void refill_(ThreadCache& cache, size_t size_class);
+  inline void drain_(ThreadCache& cache, size_t size_class, size_t count);
+
+  static inline ThreadCacheRegistry& thread_cache_registry_();
+
+  std::shared_ptr<Depot> m_depot;
+  size_t m_batch_size;
+  size_t m_max_depot_bytes_per_class;
+};
+
+//------
+
+FragmentBufferPool::Depot::~Depot()
+{
+  for (auto& free_list : free_lists)
+    for (auto block : free_list)
+      free(block);
+}
+
+FragmentBufferPool::ThreadCache::~ThreadCache()
+{
+  std::lock_guard<std::mutex> lock(depot->mutex);
+  for (size_t size_class = 0; size_class < s_num_size_classes; ++size_class) {
+    auto& depot_list = depot->free_lists[size_class];
+    depot_list.insert(depot_list.end(), free_lists[size_class].begin(), free_lists[size_class].end());
+  }
+}
+
+FragmentBufferPool::FragmentBufferPool(size_t batch_size, size_t max_depot_bytes_per_class)
+  : m_depot(std::make_shared<Depot>())
+  , m_batch_size(std::max<size_t>(1, batch_size))
+  , m_max_depot_bytes_per_class(max_depot_bytes_per_class)
+{}
+
+FragmentBufferPool::~FragmentBufferPool()
+{
+  flush_thread_cache();
+  m_depot->pool_destroyed = true;
+  release();
+}
+
+size_t
+FragmentBufferPool::size_class_for(size_t bytes) noexcept
+{
+  if (bytes <= s_min_block_size)
+    return 0;
+  if (bytes > block_size(s_num_size_classes - 1))
+    return s_num_size_classes;
+  // ceil(log2(bytes)) - log2(s_min_block_size)
+  return 64 - __builtin_clzll(bytes - 1) - 7;
+}
+
+size_t
+FragmentBufferPool::get_depot_block_count(size_t size_class) const
+{
+  std::lock_guard<std::mutex> lock(m_depot->mutex);
+  return m_depot->free_lists.at(size_class).size();
+}
+
+void
+FragmentBufferPool::flush_thread_cache()
+{
+  auto& registry = thread_cache_registry_();
+  auto it = std::find_if(registry.caches.begin(), registry.caches.end(), [&](auto const& cache) {
+    return cache->depot == m_depot;
+  });
+  if (it == registry.caches.end())
+    return;
+
+  if (registry.last_used == it->get())
+    registry.last_used = nullptr;
+  registry.caches.erase(it); // ~ThreadCache moves the blocks to the depot
+}
+
+void
+FragmentBufferPool::release()
+{
+  FreeLists released;
+  {
+    std::lock_guard<std::mutex> lock(m_depot->mutex);
+    released.swap(m_depot->free_lists);
+  }
+  for (auto& free_list : released)
+    for (auto block : free_list)
+      free(block);
+}
+
+void*
+FragmentBufferPool::do_allocate(size_t bytes, size_t alignment)
+{
+  if (alignment > alignof(std::max_align_t))
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+
+  auto size_class = size_class_for(bytes);
+  if (size_class == s_num_size_classes) {
+    void* block = malloc(bytes);
+    if (block == nullptr)
+      throw std::bad_alloc();
+    return block;
+  }
+
+  auto& cache = thread_cache_();
+  auto& free_list = cache.free_lists[size_class];
+  if (free_list.empty()) {
+    refill_(cache, size_class);
+    if (free_list.empty()) {
+      void* block = malloc(block_size(size_class));
+      if (block == nullptr)
+        throw std::bad_alloc();
+      return block;
+    }
+  }
+  void* block = free_list.back();
+  free_list.pop_back();
+  return block;
+}
+
+void
+FragmentBufferPool::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+  if (alignment > alignof(std::max_align_t)) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    return;
+  }
+
+  auto size_class = size_class_for(bytes);
+  if (size_class == s_num_size_classes) {
+    free(p);
+    return;
+  }
+
+  auto& cache = thread_cache_();
+  auto& free_list = cache.free_lists[size_class];
+  free_list.push_back(p);
+  auto batch = batch_size(size_class);
+  if (free_list.size() >= 2 * batch)
+    drain_(cache, size_class, batch);
+}
+
+FragmentBufferPool::ThreadCache&
+FragmentBufferPool::thread_cache_()
+{
+  auto& registry = thread_cache_registry_();
+  if (registry.last_used != nullptr && registry.last_used->depot == m_depot)
+    return *registry.last_used;
+
+  ThreadCache* found = nullptr;
+  for (auto it = registry.caches.begin(); it != registry.caches.end();) {
+    if ((*it)->depot == m_depot) {
+      found = it->get();
+      ++it;
+    } else if ((*it)->depot->pool_destroyed) {
+      it = registry.caches.erase(it); // Hand blocks of destroyed pools back to their depot for release
+    } else {
+      ++it;
+    }
+  }
+  if (found == nullptr) {
+    registry.caches.emplace_back(std::make_unique<ThreadCache>());
+    found = registry.caches.back().get();
+    found->depot = m_depot;
+  }
+  registry.last_used = found;
+  return *found;
+}
+
+void
+FragmentBufferPool::refill_(ThreadCache& cache, size_t size_class)
+{
+  auto& free_list = cache.free_lists[size_class];
+  std::lock_guard<std::mutex> lock(m_depot->mutex);
+  auto& depot_list = m_depot->free_lists[size_class];
+  auto count = std::min(batch_size(size_class), depot_list.size());
+  free_list.insert(free_list.end(), depot_list.end() - count, depot_list.end());
+  depot_list.resize(depot_list.size() - count);
+}
+
+void
+FragmentBufferPool::drain_(ThreadCache& cache, size_t size_class, size_t count)
+{
+  auto& free_list = cache.free_lists[size_class];
+  auto max_depot_blocks = m_max_depot_bytes_per_class / block_size(size_class);
+  size_t excess = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_depot->mutex);
+    auto& depot_list = m_depot->free_lists[size_class];
+    auto accepted = std::min(count, max_depot_blocks > depot_list.size() ? max_depot_blocks - depot_list.size() : 0);
+    depot_list.insert(depot_list.end(), free_list.end() - accepted, free_list.end());
+    free_list.resize(free_list.size() - accepted);
+    excess = count - accepted;
+  }
+  for (; excess > 0; --excess) {
+    free(free_list.back());
+    free_list.pop_back();
+  }
+}
+
+FragmentBufferPool::ThreadCacheRegistry&
+FragmentBufferPool::thread_cache_registry_()
+{
+  static thread_local ThreadCacheRegistry registry;
+  return registry;
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTBUFFERPOOL_HPP_
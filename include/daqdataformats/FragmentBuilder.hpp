@@ -0,0 +1,243 @@
+/**
+ * @file FragmentBuilder.hpp Incremental, in-place construction of a Fragment
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTBUILDER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTBUILDER_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Builds a Fragment directly in its final buffer
+ *
+ * The FragmentHeader and payload are written in place: the builder hands out writable regions at the end of the
+ * payload (e.g. as DMA or decoding targets), grows the buffer geometrically when the reserved capacity is exceeded,
+ * and finalize() turns the buffer into a Fragment without copying it.
+ *
+ * Pointers returned by prepare(), get_data() and get_header() are invalidated when the buffer grows.
+ */
+class FragmentBuilder
+{
+public:
+  /**
+   * @brief Default payload capacity reserved when none is given
+   */
+  static constexpr size_t s_default_payload_capacity = 4096;
+
+  /**
+   * @brief Construct a FragmentBuilder, reserving space for a payload of the given size
+   * @param payload_capacity Estimated payload size
+   * @param memory_resource Memory resource to allocate the Fragment array from (nullptr means malloc/free)
+   */
+  inline explicit FragmentBuilder(size_t payload_capacity = s_default_payload_capacity,
+                                  std::pmr::memory_resource* memory_resource = nullptr);
+
+  /**
+   * @brief FragmentBuilder destructor, releasing the buffer unless it was handed to a Fragment
+   */
+  ~FragmentBuilder() { deallocate_(); }
+
+  FragmentBuilder(FragmentBuilder const&) = delete;            ///< FragmentBuilder is not copy-constructible
+  FragmentBuilder& operator=(FragmentBuilder const&) = delete; ///< FragmentBuilder is not copy-assignable
+  FragmentBuilder(FragmentBuilder&&) = delete;                 ///< FragmentBuilder is not move-constructible
+  FragmentBuilder& operator=(FragmentBuilder&&) = delete;      ///< FragmentBuilder is not move-assignable
+
+  /**
+   * @brief Get the header of the Fragment being built
+   * @return Reference to the FragmentHeader in the buffer. The size field is set by finalize().
+   */
+  FragmentHeader& get_header()
+  {
+    ensure_buffer_();
+    return *static_cast<FragmentHeader*>(m_buffer);
+  }
+
+  /**
+   * @brief Make sure the buffer can hold a payload of at least the given size without growing
+   * @param payload_capacity Payload size to reserve
+   */
+  inline void reserve(size_t payload_capacity);
+
+  /**
+   * @brief Get a writable region of the given size right after the payload written so far
+   * @param size Size of the region
+   * @return Pointer to the region. It becomes part of the payload once commit() is called.
+   */
+  inline void* prepare(size_t size);
+
+  /**
+   * @brief Append the given number of bytes from the region returned by prepare() to the payload
+   * @param size Number of bytes written into the prepared region
+   * @throws std::length_error if size exceeds the reserved capacity
+   */
+  inline void commit(size_t size);
+
+  /**
+   * @brief Copy data to the end of the payload
+   * @param data Pointer to the data
+   * @param size Size of the data
+   */
+  void append(const void* data, size_t size)
+  {
+    std::memcpy(prepare(size), data, size);
+    m_data_size += size;
+  }
+
+  /**
+   * @brief Get a pointer to the start of the payload
+   */
+  void* get_data()
+  {
+    ensure_buffer_();
+    return static_cast<uint8_t*>(m_buffer) + sizeof(FragmentHeader); // NOLINT(build/unsigned)
+  }
+
+  /**
+   * @brief Get the size of the payload written so far
+   */
+  size_t get_data_size() const { return m_data_size; }
+
+  /**
+   * @brief Get the payload size the current buffer can hold without growing
+   */
+  size_t get_payload_capacity() const { return m_buffer == nullptr ? 0 : m_capacity - sizeof(FragmentHeader); }
+
+  /**
+   * @brief Turn the buffer into a Fragment, setting the size header field
+   * @return Fragment owning the buffer
+   *
+   * The builder is left empty and can be used to build another Fragment, which gets a new buffer.
+   */
+  inline Fragment finalize();
+
+private:
+  inline void ensure_buffer_();
+  inline void grow_(size_t min_capacity);
+  inline void deallocate_();
+
+  void* m_buffer{ nullptr };   ///< Buffer holding the FragmentHeader and payload
+  size_t m_capacity{ 0 };      ///< Size of m_buffer
+  size_t m_data_size{ 0 };     ///< Size of the payload written so far
+  size_t m_initial_capacity;   ///< Buffer size allocated for each new Fragment
+  std::pmr::memory_resource* m_memory_resource; ///< Where m_buffer comes from, nullptr for malloc()
+};
+
+//------
+
+FragmentBuilder::FragmentBuilder(size_t payload_capacity, std::pmr::memory_resource* memory_resource)
+  : m_initial_capacity(sizeof(FragmentHeader) + payload_capacity)
+  , m_memory_resource(memory_resource)
+{
+  ensure_buffer_();
+}
+
+void
+FragmentBuilder::reserve(size_t payload_capacity)
+{
+  ensure_buffer_();
+  if (sizeof(FragmentHeader) + payload_capacity > m_capacity)
+    grow_(sizeof(FragmentHeader) + payload_capacity);
+}
+
+void*
+FragmentBuilder::prepare(size_t size)
+{
+  ensure_buffer_();
+  size_t needed = sizeof(FragmentHeader) + m_data_size + size;
+  if (needed > m_capacity)
+    grow_(std::max(needed, 2 * m_capacity));
+  return static_cast<uint8_t*>(m_buffer) + sizeof(FragmentHeader) + m_data_size; // NOLINT(build/unsigned)
+}
+
+void
+FragmentBuilder::commit(size_t size)
+{
+  if (sizeof(FragmentHeader) + m_data_size + size > m_capacity) {
+    throw std::length_error("Committed FragmentBuilder data exceeds the prepared capacity.");
+  }
+  m_data_size += size;
+}
+
+Fragment
+FragmentBuilder::finalize()
+{
+  get_header().size = sizeof(FragmentHeader) + m_data_size;
+
+  Fragment fragment(m_buffer, Fragment::BufferAdoptionMode::kTakeOverBuffer, m_memory_resource, m_capacity);
+
+  m_buffer = nullptr;
+  m_capacity = 0;
+  m_data_size = 0;
+  return fragment;
+}
+
+void
+FragmentBuilder::ensure_buffer_()
+{
+  if (m_buffer != nullptr)
+    return;
+
+  if (m_memory_resource != nullptr) {
+    m_buffer = m_memory_resource->allocate(m_initial_capacity, alignof(std::max_align_t));
+  } else {
+    m_buffer = malloc(m_initial_capacity); // NOLINT(build/unsigned)
+    if (m_buffer == nullptr) {
+      throw std::bad_alloc();
+    }
+  }
+  m_capacity = m_initial_capacity;
+  new (m_buffer) FragmentHeader();
+}
+
+void
+FragmentBuilder::grow_(size_t min_capacity)
+{
+  if (m_memory_resource != nullptr) {
+    void* buffer = m_memory_resource->allocate(min_capacity, alignof(std::max_align_t));
+    std::memcpy(buffer, m_buffer, sizeof(FragmentHeader) + m_data_size);
+    m_memory_resource->deallocate(m_buffer, m_capacity, alignof(std::max_align_t));
+    m_buffer = buffer;
+  } else {
+    // realloc can often extend the block in place and avoid the copy
+    void* buffer = realloc(m_buffer, min_capacity);
+    if (buffer == nullptr) {
+      throw std::bad_alloc();
+    }
+    m_buffer = buffer;
+  }
+  m_capacity = min_capacity;
+}
+
+void
+FragmentBuilder::deallocate_()
+{
+  if (m_buffer == nullptr)
+    return;
+
+  if (m_memory_resource != nullptr) {
+    m_memory_resource->deallocate(m_buffer, m_capacity, alignof(std::max_align_t));
+  } else {
+    free(m_buffer);
+  }
+  m_buffer = nullptr;
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTBUILDER_HPP_
@@ -9,15 +9,20 @@
 #ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTHEADER_HPP_
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTHEADER_HPP_
 
+#include "daqdataformats/CharReader.hpp"
+#include "daqdataformats/CharWriter.hpp"
+#include "daqdataformats/NameTable.hpp"
 #include "daqdataformats/SourceID.hpp"
 #include "daqdataformats/Types.hpp"
 
 #include <bitset>
+#include <charconv>
 #include <cstddef>
 #include <cstdlib>
 #include <map>
 #include <numeric>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace dunedaq::daqdataformats {
@@ -215,32 +220,73 @@ enum class FragmentType : fragment_type_t
   kTDEEth = 15,
 };
 
+namespace detail {
+
+/**
+ * @brief Names of the FragmentTypes, indexed by value. These names can be used, for example, as HDF5 Group names
+ */
+inline constexpr NameTable<FragmentType, 16> s_fragment_type_names{ {
+  "Unknown",
+  "ProtoWIB",
+  "WIB",
+  "DAPHNE",
+  "TDE_AMC",
+  "FW_Trigger_Primitive",
+  "Trigger_Primitive",
+  "Trigger_Activity",
+  "Trigger_Candidate",
+  "Hardware_Signal",
+  "PACMAN",
+  "MPD",
+  "WIBEth",
+  "DAPHNEStream",
+  "CRT",
+  "TDEEth",
+} };
+
+static_assert(s_fragment_type_names.get_name(FragmentType::kTDEEth) == "TDEEth",
+              "s_fragment_type_names must list every FragmentType, in value order");
+
+} // namespace detail
+
+/**
+ * @brief Get the name of a FragmentType, without allocating
+ * @param type Type to name
+ * @return Name of the given type, "Unknown" for values that are not FragmentTypes
+ */
+constexpr std::string_view
+get_fragment_type_name(FragmentType type) noexcept
+{
+  auto name = detail::s_fragment_type_names.get_name(type);
+  return name.empty() ? detail::s_fragment_type_names.get_name(FragmentType::kUnknown) : name;
+}
+
+/**
+ * @brief Find the FragmentType with a given name, without allocating
+ * @param name Name of the type
+ * @return FragmentType with this name, FragmentType::kUnknown if there is none
+ */
+constexpr FragmentType
+find_fragment_type(std::string_view name) noexcept
+{
+  return detail::s_fragment_type_names.find(name).value_or(FragmentType::kUnknown);
+}
+
 /**
  * @brief This map relates FragmentType values to string names
  *
- * These names can be used, for example, as HDF5 Group names
+ * These names can be used, for example, as HDF5 Group names. Prefer get_fragment_type_name and find_fragment_type
+ * for single conversions, as this builds a new map on every call.
  */
 inline std::map<FragmentType, std::string>
 get_fragment_type_names()
 {
-  return {
-    { FragmentType::kUnknown, "Unknown" },
-    { FragmentType::kProtoWIB, "ProtoWIB" },
-    { FragmentType::kWIB, "WIB" },
-    { FragmentType::kDAPHNE, "DAPHNE" },
-    { FragmentType::kDAPHNEStream, "DAPHNEStream" },
-    { FragmentType::kTDE_AMC, "TDE_AMC" },
-    { FragmentType::kFW_TriggerPrimitive, "FW_Trigger_Primitive" },
-    { FragmentType::kTriggerPrimitive, "Trigger_Primitive" },
-    { FragmentType::kTriggerActivity, "Trigger_Activity" },
-    { FragmentType::kTriggerCandidate, "Trigger_Candidate" },
-    { FragmentType::kHardwareSignal, "Hardware_Signal" },
-    { FragmentType::kPACMAN, "PACMAN"},
-    { FragmentType::kMPD, "MPD"},
-    { FragmentType::kWIBEth, "WIBEth"},
-    { FragmentType::kCRT, "CRT"},
-    { FragmentType::kTDEEth, "TDEEth"},
-  };
+  std::map<FragmentType, std::string> names;
+  for (size_t i = 0; i < detail::s_fragment_type_names.size(); ++i) {
+    auto type = static_cast<FragmentType>(i);
+    names.emplace(type, get_fragment_type_name(type));
+  }
+  return names;
 }
 
 /**
@@ -251,12 +297,7 @@ get_fragment_type_names()
 inline std::string
 fragment_type_to_string(const FragmentType& type)
 {
-  try {
-    return get_fragment_type_names().at(type);
-  }
-  catch(std::exception &e) {
-  }
-  return "Unknown";
+  return std::string(get_fragment_type_name(type));
 }
 
 /**
@@ -267,11 +308,7 @@ fragment_type_to_string(const FragmentType& type)
 inline FragmentType
 string_to_fragment_type(const std::string& name)
 {
-  for (auto& it : get_fragment_type_names()) {
-    if (it.second == name)
-      return it.first;
-  }
-  return FragmentType::kUnknown;
+  return find_fragment_type(name);
 }
 
 /**
@@ -298,6 +335,64 @@ operator<<(std::ostream& o, FragmentHeader const& hdr)
            << "element_id: " << hdr.element_id ;
 }
 
+/**
+ * @brief Write a FragmentHeader into a buffer, as operator<< streams it, without allocating
+ * @param first Start of the buffer
+ * @param last End of the buffer
+ * @param hdr FragmentHeader to write
+ * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+ */
+inline std::to_chars_result
+to_chars(char* first, char* last, FragmentHeader const& hdr) noexcept
+{
+  CharWriter writer(first, last);
+  writer.write("check_word: ").write_hex(hdr.fragment_header_marker).write(", ")
+    .write("version: ").write_dec(hdr.version).write(", ")
+    .write("size: ").write_dec(hdr.size).write(", ")
+    .write("trigger_number: ").write_dec(hdr.trigger_number).write(", ")
+    .write("run_number: ").write_dec(hdr.run_number).write(", ")
+    .write("trigger_timestamp: ").write_dec(hdr.trigger_timestamp).write(", ")
+    .write("window_begin: ").write_dec(hdr.window_begin).write(", ")
+    .write("window_end: ").write_dec(hdr.window_end).write(", ")
+    .write("error_bits: ").write_dec(hdr.error_bits).write(", ")
+    .write("fragment_type: ").write_dec(hdr.fragment_type).write(", ")
+    .write("sequence_number: ").write_dec(hdr.sequence_number).write(", ")
+    .write("detector_id: ").write_dec(hdr.detector_id).write(", ")
+    .write("element_id: ").write_object(hdr.element_id);
+  return writer.result();
+}
+
+/**
+ * @brief Parse a FragmentHeader from the text written by operator<< and to_chars, without allocating
+ * @param first Start of the text
+ * @param last End of the text
+ * @param hdr FragmentHeader to fill. It is only modified if parsing succeeds.
+ * @return One past the last character parsed, or the position of the first mismatch and std::errc::invalid_argument
+ * (or std::errc::result_out_of_range for a number too large for its field)
+ */
+inline std::from_chars_result
+from_chars(const char* first, const char* last, FragmentHeader& hdr) noexcept
+{
+  FragmentHeader parsed = hdr;
+  CharReader reader(first, last);
+  reader.expect("check_word: ").read_hex(parsed.fragment_header_marker).expect(", ")
+    .expect("version: ").read_dec(parsed.version).expect(", ")
+    .expect("size: ").read_dec(parsed.size).expect(", ")
+    .expect("trigger_number: ").read_dec(parsed.trigger_number).expect(", ")
+    .expect("run_number: ").read_dec(parsed.run_number).expect(", ")
+    .expect("trigger_timestamp: ").read_dec(parsed.trigger_timestamp).expect(", ")
+    .expect("window_begin: ").read_dec(parsed.window_begin).expect(", ")
+    .expect("window_end: ").read_dec(parsed.window_end).expect(", ")
+    .expect("error_bits: ").read_dec(parsed.error_bits).expect(", ")
+    .expect("fragment_type: ").read_dec(parsed.fragment_type).expect(", ")
+    .expect("sequence_number: ").read_dec(parsed.sequence_number).expect(", ")
+    .expect("detector_id: ").read_dec(parsed.detector_id).expect(", ")
+    .expect("element_id: ").read_object(parsed.element_id);
+  if (reader.ok())
+    hdr = parsed;
+  return reader.result();
+}
+
 /**
  * @brief Read a FragmentHeader instance from a string stream
  * @param is Stream to read from
@@ -0,0 +1,170 @@
+/**
+ * @file FragmentHeaderColumns.hpp Struct-of-arrays copy of selected FragmentHeader fields, with reductions
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTHEADERCOLUMNS_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTHEADERCOLUMNS_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/TimeSlice.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/Types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief The header fields used by monitoring and data-quality summaries, gathered into one array per field
+ *
+ * Each column is contiguous, so a reduction over one field reads only that field: 8 bytes per Fragment for the
+ * window or size columns instead of the 72-byte FragmentHeader copy returned by Fragment::get_header(). Headers are
+ * read in place from the Fragments' storage, field by field.
+ */
+class FragmentHeaderColumns
+{
+public:
+  FragmentHeaderColumns() = default;
+
+  /**
+   * @brief Gather the headers of the Fragments of a TriggerRecord
+   */
+  explicit FragmentHeaderColumns(const TriggerRecord& record) { append(record); }
+
+  /**
+   * @brief Gather the headers of the Fragments of a TimeSlice
+   */
+  explicit FragmentHeaderColumns(const TimeSlice& timeslice) { append(timeslice); }
+
+  /**
+   * @brief Gather the headers of back-to-back Fragment flat arrays, e.g. a file region written by VectoredWriter
+   * @param buffer Start of the first Fragment
+   * @param size Size of the buffer, which must end at the end of a Fragment
+   * @throws std::invalid_argument if a FragmentHeader marker word is wrong or a Fragment size is smaller than a header
+   * @throws std::length_error if the last Fragment is truncated
+   */
+  inline static FragmentHeaderColumns from_buffer(const void* buffer, size_t size);
+
+  /**
+   * @brief Add the header of a FragmentHeader flat array
+   * @param header Start of the FragmentHeader. It does not need to be aligned.
+   */
+  inline void append(const void* header);
+
+  /**
+   * @brief Add the header of a Fragment
+   */
+  void append(const Fragment& fragment) { append(fragment.get_storage_location()); }
+
+  /**
+   * @brief Add the headers of the Fragments of a TriggerRecord
+   */
+  void append(const TriggerRecord& record) { append_all_(record.get_fragments_ref()); }
+
+  /**
+   * @brief Add the headers of the Fragments of a TimeSlice
+   */
+  void append(const TimeSlice& timeslice) { append_all_(timeslice.get_fragments_ref()); }
+
+  /**
+   * @brief Reserve space in every column
+   */
+  inline void reserve(size_t count);
+
+  /**
+   * @brief Remove all rows, keeping the allocated space
+   */
+  inline void clear();
+
+  /**
+   * @brief Get the number of rows (Fragments)
+   */
+  size_t size() const { return m_size.size(); }
+
+  /**
+   * @brief Whether there are no rows
+   */
+  bool empty() const { return m_size.empty(); }
+
+  const std::vector<fragment_size_t>& get_size() const { return m_size; }           ///< Column of sizes
+  const std::vector<timestamp_t>& get_window_begin() const { return m_window_begin; } ///< Column of window_begin
+  const std::vector<timestamp_t>& get_window_end() const { return m_window_end; }     ///< Column of window_end
+  const std::vector<uint32_t>& get_error_bits() const { return m_error_bits; } ///< Column of error_bits // NOLINT
+  const std::vector<fragment_type_t>& get_fragment_type() const { return m_fragment_type; } ///< Column of types
+  const std::vector<SourceID>& get_element_id() const { return m_element_id; }              ///< Column of SourceIDs
+
+  /**
+   * @brief Get the earliest window_begin, or TypeDefaults::s_invalid_timestamp if there are no rows
+   */
+  inline timestamp_t min_window_begin() const;
+
+  /**
+   * @brief Get the latest window_end, or 0 if there are no rows
+   */
+  inline timestamp_t max_window_end() const;
+
+  /**
+   * @brief Get the sum of the Fragment sizes, headers included
+   */
+  inline uint64_t total_size() const; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Get the OR of all error_bits, i.e. the error bits set in at least one Fragment
+   */
+  inline uint32_t error_bits_or() const; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Get the total number of error bits set, summed over all Fragments
+   */
+  inline uint64_t error_bits_popcount() const; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Get the number of Fragments with any error bit set
+   */
+  inline size_t count_with_errors() const;
+
+  /**
+   * @brief Get, for each error bit, the number of Fragments that have it set
+   */
+  inline std::array<size_t, 32> error_bit_counts() const;
+
+  /**
+   * @brief Get the number of Fragments of a type
+   */
+  inline size_t count_of_type(FragmentType type) const;
+
+private:
+  template<typename FragmentPointers>
+  void append_all_(const FragmentPointers& fragments)
+  {
+    reserve(size() + fragments.size());
+    for (auto const& fragment : fragments)
+      append(*fragment);
+  }
+
+  std::vector<fragment_size_t> m_size;
+  std::vector<timestamp_t> m_window_begin;
+  std::vector<timestamp_t> m_window_end;
+  std::vector<uint32_t> m_error_bits; // NOLINT(build/unsigned)
+  std::vector<fragment_type_t> m_fragment_type;
+  std::vector<SourceID> m_element_id;
+};
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/FragmentHeaderColumns.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_FRAGMENTHEADERCOLUMNS_HPP_
@@ -0,0 +1,155 @@
+/**
+ * @file IndexedRecordFileWriter.hpp Writer for append-only record files with a footer index
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_INDEXEDRECORDFILEWRITER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_INDEXEDRECORDFILEWRITER_HPP_
+
+#include "daqdataformats/RecordFileIndex.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/VectoredWriter.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Writes TriggerRecords back-to-back into a file and closes it with a sorted footer index
+ *
+ * The file layout is described in docs/IndexedRecordFileV1.md. Until close() is called the file holds only the
+ * records, which MappedRecordFile reads sequentially; after close() it can look records up by
+ * (run_number, trigger_number, sequence_number) with a binary search of the footer.
+ */
+class IndexedRecordFileWriter
+{
+public:
+  /**
+   * @brief Create (or truncate) the given file
+   * @param path Path of the file
+   * @throws std::system_error if the file cannot be created
+   */
+  explicit IndexedRecordFileWriter(const std::string& path)
+    : m_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+    , m_writer(m_fd, 0)
+  {
+    if (m_fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "IndexedRecordFileWriter failed to create " + path);
+    }
+  }
+
+  /**
+   * @brief IndexedRecordFileWriter destructor, closing the file if close() was not called
+   */
+  ~IndexedRecordFileWriter()
+  {
+    try {
+      close();
+    } catch (...) { // NOLINT(bugprone-empty-catch)
+      // Errors can only be reported by an explicit close()
+    }
+  }
+
+  IndexedRecordFileWriter(IndexedRecordFileWriter const&) = delete; ///< IndexedRecordFileWriter is not copy-constructible
+  IndexedRecordFileWriter& operator=(IndexedRecordFileWriter const&) =
+    delete; ///< IndexedRecordFileWriter is not copy-assignable
+  IndexedRecordFileWriter(IndexedRecordFileWriter&&) = delete; ///< IndexedRecordFileWriter is not move-constructible
+  IndexedRecordFileWriter& operator=(IndexedRecordFileWriter&&) =
+    delete; ///< IndexedRecordFileWriter is not move-assignable
+
+  /**
+   * @brief Queue a TriggerRecord at the end of the file
+   * @param record TriggerRecord to write. It must stay alive and unmodified until the next flush() or close().
+   */
+  void append(const TriggerRecord& record)
+  {
+    auto const& header = record.get_header_ref();
+    RecordIndexEntry entry;
+    entry.trigger_number = header.get_trigger_number();
+    entry.run_number = header.get_run_number();
+    entry.sequence_number = header.get_sequence_number();
+    entry.offset = m_end_offset;
+    entry.size = record.get_total_size_bytes();
+    entry.num_fragments = static_cast<uint32_t>(record.get_fragments_ref().size()); // NOLINT(build/unsigned)
+    entry.header_size = static_cast<uint32_t>(header.get_total_size_bytes());       // NOLINT(build/unsigned)
+
+    m_writer.add(record);
+    m_entries.push_back(entry);
+    m_end_offset += entry.size;
+  }
+
+  /**
+   * @brief Write all queued TriggerRecords
+   * @throws std::system_error if writing fails
+   */
+  void flush() { m_writer.flush(); }
+
+  /**
+   * @brief Write all queued TriggerRecords, the footer index and the trailer, then close the file
+   * @throws std::system_error if writing fails
+   *
+   * Calling close() more than once has no effect.
+   */
+  inline void close();
+
+  /**
+   * @brief Get the number of TriggerRecords appended
+   */
+  size_t get_num_records() const { return m_entries.size(); }
+
+private:
+  int m_fd;
+  VectoredWriter m_writer;
+  std::vector<RecordIndexEntry> m_entries;
+  uint64_t m_end_offset{ 0 }; ///< Offset of the end of the last appended record // NOLINT(build/unsigned)
+};
+
+//------
+
+void
+IndexedRecordFileWriter::close()
+{
+  if (m_fd < 0)
+    return;
+
+  static const uint8_t padding[RecordFileTrailer::s_index_alignment] = {}; // NOLINT(build/unsigned)
+
+  RecordFileTrailer trailer;
+  trailer.index_offset = (m_end_offset + RecordFileTrailer::s_index_alignment - 1) /
+                         RecordFileTrailer::s_index_alignment * RecordFileTrailer::s_index_alignment;
+  trailer.num_entries = m_entries.size();
+  std::stable_sort(m_entries.begin(), m_entries.end());
+
+  // Release the descriptor whatever happens, so that a failed close() is not retried by the destructor
+  int fd = m_fd;
+  m_fd = -1;
+  try {
+    m_writer.add_buffer(padding, trailer.index_offset - m_end_offset);
+    m_writer.add_buffer(m_entries.data(), m_entries.size() * sizeof(RecordIndexEntry));
+    m_writer.add_buffer(&trailer, sizeof(trailer));
+    m_writer.flush();
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+
+  if (::close(fd) != 0) {
+    throw std::system_error(errno, std::generic_category(), "IndexedRecordFileWriter failed to close the file");
+  }
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_INDEXEDRECORDFILEWRITER_HPP_
@@ -0,0 +1,166 @@
+/**
+ * @file Instrumentation.hpp Opt-in counters of the allocations and copies made by the data format classes
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_INSTRUMENTATION_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_INSTRUMENTATION_HPP_
+
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/Types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Set to 1 to count allocations, frees and copies in Fragment, TriggerRecordHeader and TriggerRecord
+ *
+ * The value must be the same in every translation unit of a program; the CMake option of the same name adds it to
+ * the compile definitions of the daqdataformats target. When it is 0 the recording functions are empty and
+ * snapshot() returns zeros.
+ */
+#ifndef DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+#define DAQDATAFORMATS_ENABLE_INSTRUMENTATION 0
+#endif
+
+namespace dunedaq::daqdataformats::instrumentation {
+
+/**
+ * @brief Whether the counters are compiled in
+ */
+constexpr bool s_enabled = DAQDATAFORMATS_ENABLE_INSTRUMENTATION != 0;
+
+/**
+ * @brief Classes whose memory traffic is counted
+ */
+enum class InstrumentedClass : uint8_t // NOLINT(build/unsigned)
+{
+  kFragment = 0,
+  kTriggerRecordHeader = 1,
+  kTriggerRecord = 2
+};
+
+constexpr size_t s_num_instrumented_classes = 3; ///< Number of InstrumentedClasses
+constexpr size_t s_num_fragment_types = daqdataformats::detail::s_fragment_type_names.size(); ///< FragmentType slots
+
+/**
+ * @brief Memory traffic of one class or FragmentType
+ */
+struct Counters
+{
+  uint64_t allocations{ 0 };     ///< Buffers allocated, or taken over with kTakeOverBuffer // NOLINT(build/unsigned)
+  uint64_t frees{ 0 };           ///< Buffers released // NOLINT(build/unsigned)
+  uint64_t bytes_allocated{ 0 }; ///< Total size of the buffers allocated // NOLINT(build/unsigned)
+  uint64_t bytes_freed{ 0 };     ///< Total size of the buffers released // NOLINT(build/unsigned)
+  uint64_t bytes_copied{ 0 };    ///< Bytes memcpy'd into buffers or returned by value // NOLINT(build/unsigned)
+
+  /**
+   * @brief Bytes currently allocated
+   */
+  int64_t live_bytes() const { return static_cast<int64_t>(bytes_allocated - bytes_freed); }
+
+  /**
+   * @brief Buffers currently allocated
+   */
+  int64_t live_allocations() const { return static_cast<int64_t>(allocations - frees); }
+
+  Counters& operator+=(const Counters& other)
+  {
+    allocations += other.allocations;
+    frees += other.frees;
+    bytes_allocated += other.bytes_allocated;
+    bytes_freed += other.bytes_freed;
+    bytes_copied += other.bytes_copied;
+    return *this;
+  }
+
+  Counters& operator-=(const Counters& other)
+  {
+    allocations -= other.allocations;
+    frees -= other.frees;
+    bytes_allocated -= other.bytes_allocated;
+    bytes_freed -= other.bytes_freed;
+    bytes_copied -= other.bytes_copied;
+    return *this;
+  }
+};
+
+/**
+ * @brief Counters of the whole program at one point in time, by class and, for Fragments, by FragmentType
+ *
+ * Subtract two snapshots to get the traffic over an interval, e.g. to publish rates to opmon.
+ */
+struct Snapshot
+{
+  std::array<Counters, s_num_instrumented_classes> by_class{};
+  std::array<Counters, s_num_fragment_types> by_fragment_type{}; ///< Unknown type codes are counted as kUnknown
+
+  const Counters& get(InstrumentedClass instrumented_class) const
+  {
+    return by_class[static_cast<size_t>(instrumented_class)];
+  }
+  const Counters& get(FragmentType fragment_type) const { return by_fragment_type[static_cast<size_t>(fragment_type)]; }
+
+  Snapshot& operator-=(const Snapshot& other)
+  {
+    for (size_t i = 0; i < by_class.size(); ++i)
+      by_class[i] -= other.by_class[i];
+    for (size_t i = 0; i < by_fragment_type.size(); ++i)
+      by_fragment_type[i] -= other.by_fragment_type[i];
+    return *this;
+  }
+};
+
+inline Snapshot
+operator-(Snapshot later, const Snapshot& earlier)
+{
+  return later -= earlier;
+}
+
+/**
+ * @brief Sum the counters of all threads, including those that have exited
+ *
+ * Each counter is read atomically, but the snapshot is not taken at a single instant: an operation in progress on
+ * another thread may be only partly counted.
+ */
+inline Snapshot
+snapshot();
+
+// Recording functions, called by the instrumented classes. They are empty when instrumentation is disabled.
+
+inline void
+record_allocation(InstrumentedClass instrumented_class, size_t bytes);
+inline void
+record_free(InstrumentedClass instrumented_class, size_t bytes);
+inline void
+record_copy(InstrumentedClass instrumented_class, size_t bytes);
+
+/**
+ * @brief Record the allocation of a Fragment buffer, by class and by FragmentType
+ */
+inline void
+record_fragment_allocation(fragment_type_t fragment_type, size_t bytes);
+inline void
+record_fragment_free(fragment_type_t fragment_type, size_t bytes);
+inline void
+record_fragment_copy(fragment_type_t fragment_type, size_t bytes);
+
+/**
+ * @brief Move a live Fragment buffer from one FragmentType to another, when the type of an owning Fragment is set
+ */
+inline void
+record_fragment_type_change(fragment_type_t old_type, fragment_type_t new_type, size_t bytes);
+
+} // namespace dunedaq::daqdataformats::instrumentation
+
+#include "detail/Instrumentation.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_INSTRUMENTATION_HPP_
@@ -0,0 +1,419 @@
+/**
+ * @file MappedRecordFile.hpp Zero-copy reader for files of serialized TriggerRecords and TimeSlices
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_MAPPEDRECORDFILE_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_MAPPEDRECORDFILE_HPP_
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/RecordFileIndex.hpp"
+#include "daqdataformats/TimeSlice.hpp"
+#include "daqdataformats/TimeSliceHeader.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Maps a file of serialized TriggerRecords and TimeSlices and hands out objects pointing into the mapping
+ *
+ * The file is the concatenation of records as written by VectoredWriter: a TriggerRecordHeader or TimeSliceHeader
+ * followed by the Fragments belonging to it. Records are found by walking the header marker words and sizes once,
+ * when the file is opened. The TriggerRecords and TimeSlices handed out hold kReadOnlyMode Fragments (and, for
+ * TriggerRecords, a non-owning TriggerRecordHeader) whose storage is the mapping itself, so reading costs no copies
+ * of the data and the page cache is shared with other processes reading the same file.
+ *
+ * Files closed by IndexedRecordFileWriter end with a footer index sorted by (run_number, trigger_number,
+ * sequence_number). When its trailer is found, the records are taken from the index, in key order, without touching
+ * the data, and find_trigger_record() is a binary search. Otherwise (e.g. a file whose writer did not finish) the
+ * records are found sequentially, in file order.
+ *
+ * Records and Fragments are packed without padding, so they are not always aligned for their header structs. A
+ * TriggerRecordHeader or Fragment at a misaligned offset is copied out of the mapping instead of being pointed into.
+ *
+ * The mapping is private: modifying a header field through a handed-out object changes this process's copy of the
+ * page only, never the file. Objects handed out must not outlive the MappedRecordFile.
+ */
+class MappedRecordFile
+{
+public:
+  /**
+   * @brief Kind of record stored in the file
+   */
+  enum class RecordType
+  {
+    kTriggerRecord,
+    kTimeSlice
+  };
+
+  /**
+   * @brief Location of one record in the file
+   */
+  struct RecordEntry
+  {
+    RecordType type;
+    size_t offset;        ///< Offset of the record header from the start of the file
+    size_t size;          ///< Size of the header and all Fragments
+    size_t header_size;   ///< Size of the record header
+    size_t num_fragments; ///< Number of Fragments following the header
+  };
+
+  /**
+   * @brief Map the given file and index the records in it
+   * @param path Path of the file
+   * @throws std::system_error if the file cannot be opened or mapped
+   */
+  inline explicit MappedRecordFile(const std::string& path);
+
+  /**
+   * @brief MappedRecordFile destructor, unmapping the file
+   */
+  ~MappedRecordFile() { unmap_(); }
+
+  MappedRecordFile(MappedRecordFile const&) = delete;            ///< MappedRecordFile is not copy-constructible
+  MappedRecordFile& operator=(MappedRecordFile const&) = delete; ///< MappedRecordFile is not copy-assignable
+  MappedRecordFile(MappedRecordFile&& other)
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_valid_size(std::exchange(other.m_valid_size, 0))
+    , m_index(std::exchange(other.m_index, nullptr))
+    , m_records(std::move(other.m_records))
+  {}
+  MappedRecordFile& operator=(MappedRecordFile&& other)
+  {
+    if (&other == this)
+      return *this;
+
+    unmap_();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_valid_size = std::exchange(other.m_valid_size, 0);
+    m_index = std::exchange(other.m_index, nullptr);
+    m_records = std::move(other.m_records);
+    return *this;
+  }
+
+  /**
+   * @brief Get the number of complete records found in the file
+   */
+  size_t get_num_records() const { return m_records.size(); }
+
+  /**
+   * @brief Get the index of all records found in the file
+   */
+  const std::vector<RecordEntry>& get_record_entries() const { return m_records; }
+
+  /**
+   * @brief Whether the records were taken from a footer index
+   */
+  bool has_index() const { return m_index != nullptr; }
+
+  /**
+   * @brief Find a TriggerRecord by key
+   * @param run_number Run Number of the TriggerRecord
+   * @param trigger_number Trigger Number of the TriggerRecord
+   * @param sequence_number Sequence Number of the TriggerRecord
+   * @return Index of the record, or get_num_records() if there is none with this key
+   *
+   * Uses a binary search of the footer index when the file has one, and a linear search otherwise.
+   */
+  inline size_t find_trigger_record(run_number_t run_number,
+                                    trigger_number_t trigger_number,
+                                    sequence_number_t sequence_number = 0) const;
+
+  /**
+   * @brief Get a TriggerRecord pointing into the mapping
+   * @param idx Index of the record
+   * @throws std::range_error if idx is outside of allowable range
+   * @throws std::invalid_argument if the record is not a TriggerRecord, or does not match the footer index
+   */
+  inline std::unique_ptr<TriggerRecord> get_trigger_record(size_t idx) const;
+
+  /**
+   * @brief Get a TimeSlice whose Fragments point into the mapping
+   * @param idx Index of the record
+   * @throws std::range_error if idx is outside of allowable range
+   * @throws std::invalid_argument if the record is not a TimeSlice
+   */
+  inline std::unique_ptr<TimeSlice> get_timeslice(size_t idx) const;
+
+  /**
+   * @brief Get the size of the file
+   */
+  size_t get_size() const { return m_size; }
+
+  /**
+   * @brief Get the size of the part of the file made of complete records
+   */
+  size_t get_valid_size() const { return m_valid_size; }
+
+  /**
+   * @brief Whether the file ends with bytes that do not form a complete record (e.g. a file still being written)
+   */
+  bool is_truncated() const { return m_valid_size != m_size; }
+
+private:
+  inline const RecordEntry& get_entry_(size_t idx, RecordType type) const;
+  inline bool load_index_();
+  inline void index_records_();
+  template<typename T>
+  inline void add_fragments_(T& record, const RecordEntry& entry) const;
+  inline size_t index_fragments_(size_t offset, RecordEntry& entry) const;
+  inline uint32_t read_marker_(size_t offset) const; // NOLINT(build/unsigned)
+  inline void unmap_();
+
+  uint8_t* m_data{ nullptr }; ///< Start of the mapping // NOLINT(build/unsigned)
+  size_t m_size{ 0 };
+  size_t m_valid_size{ 0 };
+  const RecordIndexEntry* m_index{ nullptr }; ///< Footer index in the mapping, if the file has one
+  std::vector<RecordEntry> m_records;
+};
+
+//------
+
+MappedRecordFile::MappedRecordFile(const std::string& path)
+{
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "MappedRecordFile failed to open " + path);
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0) {
+    auto error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::generic_category(), "MappedRecordFile failed to stat " + path);
+  }
+  m_size = static_cast<size_t>(file_stat.st_size);
+
+  if (m_size > 0) {
+    void* mapping = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      auto error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "MappedRecordFile failed to map " + path);
+    }
+    m_data = static_cast<uint8_t*>(mapping); // NOLINT(build/unsigned)
+    ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+  }
+  ::close(fd);
+
+  if (!load_index_())
+    index_records_();
+}
+
+std::unique_ptr<TriggerRecord>
+MappedRecordFile::get_trigger_record(size_t idx) const
+{
+  auto const& entry = get_entry_(idx, RecordType::kTriggerRecord);
+  if (read_marker_(entry.offset) != TriggerRecordHeaderData::s_trigger_record_header_magic) {
+    throw std::invalid_argument("Record " + std::to_string(idx) + " does not start with a TriggerRecordHeader marker.");
+  }
+  auto copy_header = entry.offset % alignof(TriggerRecordHeaderData) != 0;
+  auto record = std::make_unique<TriggerRecord>(TriggerRecord::s_adopt_header,
+                                                TriggerRecordHeader(m_data + entry.offset, copy_header));
+  if (record->get_header_ref().get_total_size_bytes() != entry.header_size) {
+    throw std::invalid_argument("Record " + std::to_string(idx) + " header size does not match the index.");
+  }
+
+  record->get_fragments_ref().reserve(entry.num_fragments);
+  add_fragments_(*record, entry);
+  return record;
+}
+
+std::unique_ptr<TimeSlice>
+MappedRecordFile::get_timeslice(size_t idx) const
+{
+  auto const& entry = get_entry_(idx, RecordType::kTimeSlice);
+  TimeSliceHeader header;
+  std::memcpy(&header, m_data + entry.offset, sizeof(header));
+  auto timeslice = std::make_unique<TimeSlice>(header);
+  add_fragments_(*timeslice, entry);
+  return timeslice;
+}
+
+size_t
+MappedRecordFile::find_trigger_record(run_number_t run_number,
+                                      trigger_number_t trigger_number,
+                                      sequence_number_t sequence_number) const
+{
+  auto key = std::make_tuple(run_number, trigger_number, sequence_number);
+  if (m_index != nullptr) {
+    auto end = m_index + m_records.size();
+    auto found = std::lower_bound(
+      m_index, end, key, [](const RecordIndexEntry& entry, const auto& k) { return entry.get_key() < k; });
+    return found != end && found->get_key() == key ? static_cast<size_t>(found - m_index) : m_records.size();
+  }
+
+  for (size_t idx = 0; idx < m_records.size(); ++idx) {
+    if (m_records[idx].type != RecordType::kTriggerRecord)
+      continue;
+    TriggerRecordHeaderData header;
+    std::memcpy(&header, m_data + m_records[idx].offset, sizeof(header));
+    if (std::make_tuple(header.run_number, header.trigger_number, header.sequence_number) == key)
+      return idx;
+  }
+  return m_records.size();
+}
+
+const MappedRecordFile::RecordEntry&
+MappedRecordFile::get_entry_(size_t idx, RecordType type) const
+{
+  if (idx >= m_records.size()) {
+    throw std::range_error("Supplied record index is larger than the maximum index.");
+  }
+  if (m_records[idx].type != type) {
+    throw std::invalid_argument("Record " + std::to_string(idx) + " is not of the requested type.");
+  }
+  return m_records[idx];
+}
+
+bool
+MappedRecordFile::load_index_()
+{
+  if (m_size < sizeof(RecordFileTrailer))
+    return false;
+  RecordFileTrailer trailer;
+  std::memcpy(&trailer, m_data + m_size - sizeof(trailer), sizeof(trailer));
+  if (trailer.record_file_trailer_marker != RecordFileTrailer::s_record_file_trailer_marker ||
+      trailer.version != RecordFileTrailer::s_record_file_trailer_version ||
+      trailer.index_offset % RecordFileTrailer::s_index_alignment != 0 || trailer.index_offset > m_size ||
+      trailer.num_entries != (m_size - sizeof(trailer) - trailer.index_offset) / sizeof(RecordIndexEntry) ||
+      trailer.index_offset + trailer.num_entries * sizeof(RecordIndexEntry) + sizeof(trailer) != m_size)
+    return false;
+
+  auto index = reinterpret_cast<const RecordIndexEntry*>(m_data + trailer.index_offset); // NOLINT
+  std::vector<RecordEntry> records;
+  records.reserve(trailer.num_entries);
+  for (size_t idx = 0; idx < trailer.num_entries; ++idx) {
+    auto const& entry = index[idx];
+    if (entry.offset > trailer.index_offset || entry.size > trailer.index_offset - entry.offset ||
+        entry.header_size < sizeof(TriggerRecordHeaderData) || entry.header_size > entry.size)
+      return false;
+    records.push_back({ RecordType::kTriggerRecord, entry.offset, entry.size, entry.header_size, entry.num_fragments });
+  }
+
+  m_index = index;
+  m_records = std::move(records);
+  m_valid_size = m_size;
+  return true;
+}
+
+template<typename T>
+void
+MappedRecordFile::add_fragments_(T& record, const RecordEntry& entry) const
+{
+  size_t offset = entry.offset + entry.header_size;
+  size_t end = entry.offset + entry.size;
+  for (size_t i = 0; i < entry.num_fragments; ++i) {
+    fragment_size_t size = 0;
+    if (end - offset >= sizeof(FragmentHeader))
+      std::memcpy(&size, m_data + offset + offsetof(FragmentHeader, size), sizeof(size));
+    if (size < sizeof(FragmentHeader) || size > end - offset ||
+        read_marker_(offset) != FragmentHeader::s_fragment_header_marker) {
+      throw std::invalid_argument("Fragment " + std::to_string(i) + " of the record at offset " +
+                                  std::to_string(entry.offset) + " is invalid.");
+    }
+    auto mode = offset % alignof(FragmentHeader) != 0 ? Fragment::BufferAdoptionMode::kCopyFromBuffer
+                                                      : Fragment::BufferAdoptionMode::kReadOnlyMode;
+    record.add_fragment(std::make_unique<Fragment>(m_data + offset, mode));
+    offset += size;
+  }
+}
+
+void
+MappedRecordFile::index_records_()
+{
+  size_t offset = 0;
+  while (offset + sizeof(uint32_t) <= m_size) { // NOLINT(build/unsigned)
+    RecordEntry entry{ RecordType::kTriggerRecord, offset, 0, 0, 0 };
+    auto marker = read_marker_(offset);
+
+    if (marker == TriggerRecordHeaderData::s_trigger_record_header_magic) {
+      if (m_size - offset < sizeof(TriggerRecordHeaderData))
+        break;
+      TriggerRecordHeaderData header;
+      std::memcpy(&header, m_data + offset, sizeof(header));
+      if (header.num_requested_components > (m_size - offset - sizeof(header)) / sizeof(ComponentRequest))
+        break;
+      entry.header_size = sizeof(header) + header.num_requested_components * sizeof(ComponentRequest);
+    } else if (marker == TimeSliceHeader::s_timeslice_header_marker) {
+      if (m_size - offset < sizeof(TimeSliceHeader))
+        break;
+      entry.type = RecordType::kTimeSlice;
+      entry.header_size = sizeof(TimeSliceHeader);
+    } else {
+      break;
+    }
+
+    auto end = index_fragments_(offset + entry.header_size, entry);
+    if (end == 0)
+      break;
+    entry.size = end - offset;
+    m_records.push_back(entry);
+    offset = end;
+  }
+  m_valid_size = offset;
+}
+
+size_t
+MappedRecordFile::index_fragments_(size_t offset, RecordEntry& entry) const
+{
+  // Fragments belong to the preceding record header until the next record header or the end of the file
+  while (offset + sizeof(uint32_t) <= m_size && // NOLINT(build/unsigned)
+         read_marker_(offset) == FragmentHeader::s_fragment_header_marker) {
+    if (m_size - offset < sizeof(FragmentHeader))
+      return 0;
+    fragment_size_t size;
+    std::memcpy(&size, m_data + offset + offsetof(FragmentHeader, size), sizeof(size));
+    if (size < sizeof(FragmentHeader) || size > m_size - offset)
+      return 0;
+    offset += size;
+    ++entry.num_fragments;
+  }
+  return offset;
+}
+
+uint32_t // NOLINT(build/unsigned)
+MappedRecordFile::read_marker_(size_t offset) const
+{
+  uint32_t marker; // NOLINT(build/unsigned)
+  std::memcpy(&marker, m_data + offset, sizeof(marker));
+  return marker;
+}
+
+void
+MappedRecordFile::unmap_()
+{
+  if (m_data != nullptr)
+    ::munmap(m_data, m_size);
+  m_data = nullptr;
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_MAPPEDRECORDFILE_HPP_
@@ -0,0 +1,122 @@
+/**
+ * @file MarkerScanner.hpp Scanner locating headers in a raw byte stream by their marker words
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_MARKERSCANNER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_MARKERSCANNER_HPP_
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/TimeSliceHeader.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Location of a header found in a raw byte stream
+ */
+struct RecordBoundary
+{
+  /**
+   * @brief Kind of header found
+   */
+  enum class Type : uint8_t // NOLINT(build/unsigned)
+  {
+    kFragment,
+    kTriggerRecordHeader,
+    kTimeSliceHeader
+  };
+
+  Type type;
+  size_t offset; ///< Offset of the header from the start of the buffer
+  size_t size;   ///< Size of the flat array the header describes (Fragment, TriggerRecordHeader or TimeSliceHeader)
+  bool complete; ///< Whether the flat array fits within the buffer
+};
+
+/**
+ * @brief Finds FragmentHeaders, TriggerRecordHeaders and TimeSliceHeaders in a byte buffer by their marker words
+ *
+ * Used to resynchronize on corrupted or truncated files and network captures. Candidate marker words are located
+ * with AVX2 or SSE2 when the CPU supports them (scalar code otherwise), then each candidate is validated using the
+ * version field and the size it declares. After a complete Fragment or TriggerRecordHeader the scan resumes at its
+ * end, so that payload bytes are not mistaken for headers.
+ */
+class MarkerScanner
+{
+public:
+  /**
+   * @brief Largest Fragment or TriggerRecordHeader size considered plausible by default
+   */
+  static constexpr size_t s_default_max_record_size = size_t(1) << 32;
+
+  /**
+   * @brief Construct a MarkerScanner over a buffer
+   * @param buffer Start of the buffer
+   * @param size Size of the buffer
+   * @param max_record_size Candidates declaring a larger size are rejected
+   */
+  MarkerScanner(const void* buffer, size_t size, size_t max_record_size = s_default_max_record_size)
+    : m_data(static_cast<const uint8_t*>(buffer)) // NOLINT(build/unsigned)
+    , m_size(size)
+    , m_max_record_size(max_record_size)
+  {}
+
+  /**
+   * @brief Find the next valid header
+   * @param boundary Filled with the location of the header
+   * @return Whether a header was found before the end of the buffer
+   */
+  inline bool next(RecordBoundary& boundary);
+
+  /**
+   * @brief Find all valid headers from the current position to the end of the buffer
+   */
+  inline std::vector<RecordBoundary> scan_all();
+
+  /**
+   * @brief Get the offset the next scan starts at
+   */
+  size_t get_position() const { return m_position; }
+
+  /**
+   * @brief Set the offset the next scan starts at
+   */
+  void set_position(size_t position) { m_position = position; }
+
+  /**
+   * @brief Get the number of marker words found that failed validation
+   */
+  size_t get_num_rejected_candidates() const { return m_num_rejected_candidates; }
+
+  /**
+   * @brief Find the next marker word, without validating it
+   * @param buffer Start of the buffer
+   * @param size Size of the buffer
+   * @param from Offset to start searching at
+   * @return Offset of the first marker word at or after from, or size if there is none
+   */
+  static inline size_t find_candidate(const void* buffer, size_t size, size_t from);
+
+private:
+  inline bool validate_(size_t offset, RecordBoundary& boundary) const;
+
+  const uint8_t* m_data; // NOLINT(build/unsigned)
+  size_t m_size;
+  size_t m_max_record_size;
+  size_t m_position{ 0 };
+  size_t m_num_rejected_candidates{ 0 };
+};
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/MarkerScanner.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_MARKERSCANNER_HPP_
@@ -0,0 +1,125 @@
+/**
+ * @file NameTable.hpp Compile-time table of enumerator names with perfect-hash reverse lookup
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_NAMETABLE_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_NAMETABLE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Names of the enumerators of an enum whose values are 0 to N-1, usable in constant expressions
+ *
+ * Value to name is an array access. Name to value hashes the name into a table with no collisions (the hash seed is
+ * searched for when the NameTable is built), then confirms with one string comparison. A NameTable should be declared
+ * constexpr, so that duplicate names and other construction errors are reported at compile time.
+ */
+template<typename Enum, size_t N>
+class NameTable
+{
+public:
+  /**
+   * @brief Build a NameTable
+   * @param names Name of each enumerator, indexed by its value
+   * @throws std::invalid_argument if a name is empty or appears twice
+   * @throws std::logic_error if no collision-free hash seed is found
+   */
+  constexpr explicit NameTable(const std::array<std::string_view, N>& names)
+    : m_names(names)
+  {
+    for (size_t i = 0; i < N; ++i) {
+      if (m_names[i].empty())
+        throw std::invalid_argument("NameTable names must not be empty");
+      for (size_t j = 0; j < i; ++j)
+        if (m_names[i] == m_names[j])
+          throw std::invalid_argument("NameTable names must be unique");
+    }
+
+    for (m_seed = 0; m_seed < s_max_seed; ++m_seed)
+      if (fill_slots_())
+        return;
+    throw std::logic_error("NameTable found no collision-free hash seed");
+  }
+
+  /**
+   * @brief Get the name of an enumerator
+   * @return The name, or an empty string_view if the value is out of range
+   */
+  constexpr std::string_view get_name(Enum value) const noexcept
+  {
+    auto index = static_cast<size_t>(value);
+    return index < N ? m_names[index] : std::string_view();
+  }
+
+  /**
+   * @brief Find the enumerator with a name
+   * @return The enumerator, or std::nullopt if no enumerator has this name
+   */
+  constexpr std::optional<Enum> find(std::string_view name) const noexcept
+  {
+    auto slot = m_slots[hash_(name, m_seed) & (s_num_slots - 1)];
+    if (slot != 0 && m_names[slot - 1] == name)
+      return static_cast<Enum>(slot - 1);
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Get the number of enumerators
+   */
+  constexpr size_t size() const noexcept { return N; }
+
+private:
+  /**
+   * @brief Smallest power of two that is at least 4 N, so that a collision-free seed is found after a few attempts
+   */
+  static constexpr size_t s_num_slots = [] {
+    size_t slots = 1;
+    while (slots < 4 * N)
+      slots *= 2;
+    return slots;
+  }();
+  static constexpr uint32_t s_max_seed = 1 << 16; // NOLINT(build/unsigned)
+
+  /**
+   * @brief FNV-1a, with the seed mixed into the offset basis
+   */
+  static constexpr uint32_t hash_(std::string_view name, uint32_t seed) noexcept // NOLINT(build/unsigned)
+  {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u); // NOLINT(build/unsigned)
+    for (char c : name)
+      hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u; // NOLINT(build/unsigned)
+    return hash;
+  }
+
+  constexpr bool fill_slots_()
+  {
+    for (auto& slot : m_slots)
+      slot = 0;
+    for (size_t i = 0; i < N; ++i) {
+      auto& slot = m_slots[hash_(m_names[i], m_seed) & (s_num_slots - 1)];
+      if (slot != 0)
+        return false;
+      slot = i + 1;
+    }
+    return true;
+  }
+
+  std::array<std::string_view, N> m_names;
+  std::array<size_t, s_num_slots> m_slots{}; ///< Index of the name plus one, 0 for an empty slot
+  uint32_t m_seed{ 0 };                      // NOLINT(build/unsigned)
+};
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_NAMETABLE_HPP_
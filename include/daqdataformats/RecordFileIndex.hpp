@@ -0,0 +1,163 @@
+/**
+ * @file RecordFileIndex.hpp Footer index structures of the indexed record file format
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_RECORDFILEINDEX_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_RECORDFILEINDEX_HPP_
+
+#include "daqdataformats/Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <tuple>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Footer index entry locating one TriggerRecord in an indexed record file
+ */
+struct RecordIndexEntry
+{
+  /**
+   * @brief Trigger Number of the TriggerRecord
+   */
+  trigger_number_t trigger_number{ TypeDefaults::s_invalid_trigger_number };
+
+  /**
+   * @brief Run Number of the TriggerRecord
+   */
+  run_number_t run_number{ TypeDefaults::s_invalid_run_number };
+
+  /**
+   * @brief Sequence Number of the TriggerRecord
+   */
+  sequence_number_t sequence_number{ TypeDefaults::s_invalid_sequence_number };
+
+  /**
+   * @brief Padding to ensure 64-bit alignment
+   */
+  uint16_t unused{ 0xFFFF }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Offset of the TriggerRecordHeader from the start of the file
+   */
+  uint64_t offset{ 0 }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Size of the TriggerRecordHeader and all Fragments of the TriggerRecord
+   */
+  uint64_t size{ 0 }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Number of Fragments following the TriggerRecordHeader
+   */
+  uint32_t num_fragments{ 0 }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Size of the TriggerRecordHeader flat array
+   */
+  uint32_t header_size{ 0 }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Key the footer index is sorted by
+   */
+  std::tuple<run_number_t, trigger_number_t, sequence_number_t> get_key() const
+  {
+    return std::make_tuple(run_number, trigger_number, sequence_number);
+  }
+
+  /**
+   * @brief Comparison operator, ordering entries by (run_number, trigger_number, sequence_number)
+   * @param other Entry to compare
+   * @return The result of the comparison of the keys
+   */
+  bool operator<(const RecordIndexEntry& other) const { return get_key() < other.get_key(); }
+};
+static_assert(sizeof(RecordIndexEntry) == 40, "RecordIndexEntry struct size different than expected!");
+static_assert(offsetof(RecordIndexEntry, trigger_number) == 0,
+              "RecordIndexEntry trigger_number field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, run_number) == 8, "RecordIndexEntry run_number field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, sequence_number) == 12,
+              "RecordIndexEntry sequence_number field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, unused) == 14, "RecordIndexEntry unused field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, offset) == 16, "RecordIndexEntry offset field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, size) == 24, "RecordIndexEntry size field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, num_fragments) == 32,
+              "RecordIndexEntry num_fragments field not at expected offset!");
+static_assert(offsetof(RecordIndexEntry, header_size) == 36,
+              "RecordIndexEntry header_size field not at expected offset!");
+
+/**
+ * @brief Trailer closing an indexed record file, stored in its last bytes
+ */
+struct RecordFileTrailer
+{
+  /**
+   * @brief Marker bytes to identify a RecordFileTrailer at the end of a file
+   */
+  static constexpr uint32_t s_record_file_trailer_marker = 0x77778888; // NOLINT(build/unsigned)
+
+  /**
+   * @brief The current version of the RecordFileTrailer
+   */
+  static constexpr uint32_t s_record_file_trailer_version = 1; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Alignment of the footer index within the file
+   */
+  static constexpr size_t s_index_alignment = 8;
+
+  /**
+   * @brief Offset of the first RecordIndexEntry from the start of the file
+   */
+  uint64_t index_offset{ 0 }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Number of RecordIndexEntry structs in the footer index
+   */
+  uint64_t num_entries{ 0 }; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Version of the RecordFileTrailer structure
+   */
+  uint32_t version = s_record_file_trailer_version; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Marker bytes, last so that they end the file
+   */
+  uint32_t record_file_trailer_marker = s_record_file_trailer_marker; // NOLINT(build/unsigned)
+};
+static_assert(sizeof(RecordFileTrailer) == 24, "RecordFileTrailer struct size different than expected!");
+static_assert(offsetof(RecordFileTrailer, index_offset) == 0,
+              "RecordFileTrailer index_offset field not at expected offset!");
+static_assert(offsetof(RecordFileTrailer, num_entries) == 8,
+              "RecordFileTrailer num_entries field not at expected offset!");
+static_assert(offsetof(RecordFileTrailer, version) == 16, "RecordFileTrailer version field not at expected offset!");
+static_assert(offsetof(RecordFileTrailer, record_file_trailer_marker) == 20,
+              "RecordFileTrailer record_file_trailer_marker field not at expected offset!");
+
+/**
+ * @brief Stream a RecordIndexEntry in human-readable form
+ * @param o Stream to write to
+ * @param entry RecordIndexEntry to write
+ * @return Stream instance for further streaming
+ */
+inline std::ostream&
+operator<<(std::ostream& o, RecordIndexEntry const& entry)
+{
+  return o << "run_number: " << entry.run_number << ", "
+           << "trigger_number: " << entry.trigger_number << ", "
+           << "sequence_number: " << entry.sequence_number << ", "
+           << "offset: " << entry.offset << ", "
+           << "size: " << entry.size << ", "
+           << "num_fragments: " << entry.num_fragments;
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_RECORDFILEINDEX_HPP_
@@ -0,0 +1,266 @@
+/**
+ * @file ScatterGatherFragment.hpp Fragment made of a header and a list of separate payload chunks
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SCATTERGATHERFRAGMENT_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SCATTERGATHERFRAGMENT_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentBuilder.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/Types.hpp"
+
+#include <sys/uio.h>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief A Fragment whose payload is kept as a list of chunks instead of one contiguous array
+ *
+ * Chunks are borrowed or owned buffers (e.g. DMA superchunks) and are only copied when a contiguous view of the
+ * payload is requested through get_data(). The header and chunks can be handed to writev()/sendmsg() as an iovec
+ * array, which produces the same byte stream as the storage location of the equivalent contiguous Fragment.
+ */
+class ScatterGatherFragment
+{
+public:
+  /**
+   * @brief Construct an empty ScatterGatherFragment with a default FragmentHeader
+   */
+  ScatterGatherFragment()
+  {
+    m_header.size = sizeof(FragmentHeader);
+    m_iovecs.push_back({ &m_header, sizeof(FragmentHeader) });
+  }
+
+  /**
+   * @brief ScatterGatherFragment destructor, freeing all owned chunks
+   */
+  ~ScatterGatherFragment() { release_chunks_(); }
+
+  ScatterGatherFragment(ScatterGatherFragment const&) = delete; ///< ScatterGatherFragment is not copy-constructible
+  ScatterGatherFragment& operator=(ScatterGatherFragment const&) =
+    delete; ///< ScatterGatherFragment is not copy-assignable
+  ScatterGatherFragment(ScatterGatherFragment&& other)
+    : m_header(other.m_header)
+    , m_chunks(std::move(other.m_chunks))
+    , m_iovecs(std::move(other.m_iovecs))
+  {
+    m_iovecs.front().iov_base = &m_header;
+    other.m_chunks.clear();
+    other.m_iovecs.assign(1, { &other.m_header, sizeof(FragmentHeader) });
+    other.m_header.size = sizeof(FragmentHeader);
+  }
+  ScatterGatherFragment& operator=(ScatterGatherFragment&& other)
+  {
+    if (&other == this)
+      return *this;
+
+    release_chunks_();
+    m_header = other.m_header;
+    m_chunks = std::move(other.m_chunks);
+    m_iovecs = std::move(other.m_iovecs);
+    m_iovecs.front().iov_base = &m_header;
+    other.m_chunks.clear();
+    other.m_iovecs.assign(1, { &other.m_header, sizeof(FragmentHeader) });
+    other.m_header.size = sizeof(FragmentHeader);
+    return *this;
+  }
+
+  /**
+   * @brief Get the FragmentHeader
+   * @return Reference to the header. Its size field is maintained by the ScatterGatherFragment.
+   */
+  const FragmentHeader& get_header() const { return m_header; }
+  /**
+   * @brief Copy fields from the provided header in this ScatterGatherFragment's header
+   * @param header Header to copy fields from
+   *
+   * The size FragmentHeader field is *not* copied from the given FragmentHeader
+   */
+  void set_header_fields(const FragmentHeader& header)
+  {
+    auto size = m_header.size;
+    m_header = header;
+    m_header.size = size;
+  }
+
+  // Header setters, for every field but size
+  void set_trigger_number(trigger_number_t trigger_number) { m_header.trigger_number = trigger_number; }
+  void set_run_number(run_number_t run_number) { m_header.run_number = run_number; }
+  void set_trigger_timestamp(timestamp_t trigger_timestamp) { m_header.trigger_timestamp = trigger_timestamp; }
+  void set_window_begin(timestamp_t window_begin) { m_header.window_begin = window_begin; }
+  void set_window_end(timestamp_t window_end) { m_header.window_end = window_end; }
+  void set_element_id(SourceID element_id) { m_header.element_id = element_id; }
+  void set_detector_id(uint16_t detector_id) { m_header.detector_id = detector_id; } // NOLINT(build/unsigned)
+  void set_error_bits(std::bitset<32> error_bits) { m_header.error_bits = error_bits.to_ulong(); }
+  void set_type(FragmentType fragment_type) { m_header.fragment_type = static_cast<fragment_type_t>(fragment_type); }
+  void set_sequence_number(sequence_number_t number) { m_header.sequence_number = number; }
+
+  /**
+   * @brief Append a chunk to the payload
+   * @param data Pointer to the chunk
+   * @param size Size of the chunk
+   * @param adoption_mode kReadOnlyMode borrows the chunk, kTakeOverBuffer takes ownership of a malloc'd chunk,
+   * kCopyFromBuffer stores an owned copy
+   *
+   * An empty chunk is not stored (a taken-over one is freed). If add_chunk throws, the chunk is not added and a
+   * kTakeOverBuffer chunk remains owned by the caller.
+   */
+  inline void add_chunk(void* data,
+                        size_t size,
+                        Fragment::BufferAdoptionMode adoption_mode = Fragment::BufferAdoptionMode::kReadOnlyMode);
+
+  /**
+   * @brief Get the number of payload chunks
+   */
+  size_t get_num_chunks() const { return m_chunks.size(); }
+
+  /**
+   * @brief Get the total size of the Fragment
+   * @return Size of the header plus all payload chunks
+   */
+  fragment_size_t get_size() const { return m_header.size; }
+
+  /**
+   * @brief Get the size of the payload
+   */
+  fragment_size_t get_data_size() const { return m_header.size - sizeof(FragmentHeader); }
+
+  /**
+   * @brief Get the Fragment as a scatter-gather list
+   * @return iovec array with the header as first entry followed by one entry per payload chunk
+   */
+  const std::vector<iovec>& get_iovecs() const { return m_iovecs; }
+
+  /**
+   * @brief Get a contiguous view of the payload
+   * @return Pointer to the payload, or nullptr if there is none
+   *
+   * A payload made of several chunks is flattened into a single owned chunk by the first call.
+   */
+  inline void* get_data();
+
+  /**
+   * @brief Copy header and payload into a contiguous Fragment
+   * @param memory_resource Memory resource to allocate the Fragment array from (nullptr means malloc/free)
+   * @return The contiguous Fragment
+   */
+  inline Fragment to_fragment(std::pmr::memory_resource* memory_resource = nullptr) const;
+
+private:
+  /**
+   * @brief One payload chunk
+   */
+  struct Chunk
+  {
+    void* data;
+    size_t size;
+    bool owned; ///< Whether the chunk must be freed by this ScatterGatherFragment
+  };
+
+  inline void release_chunks_();
+
+  FragmentHeader m_header{};
+  std::vector<Chunk> m_chunks;
+  std::vector<iovec> m_iovecs; ///< Header followed by the chunks, ready for writev
+};
+
+//------
+
+void
+ScatterGatherFragment::add_chunk(void* data, size_t size, Fragment::BufferAdoptionMode adoption_mode)
+{
+  if (data == nullptr) {
+    throw std::invalid_argument("The Fragment buffer point to NULL.");
+  }
+
+  if (size == 0) {
+    if (adoption_mode == Fragment::BufferAdoptionMode::kTakeOverBuffer)
+      free(data);
+    return;
+  }
+
+  // Make room first, so that the push_backs below cannot throw once the chunk is owned
+  m_chunks.reserve(m_chunks.size() + 1);
+  m_iovecs.reserve(m_iovecs.size() + 1);
+
+  Chunk chunk{ data, size, adoption_mode != Fragment::BufferAdoptionMode::kReadOnlyMode };
+  if (adoption_mode == Fragment::BufferAdoptionMode::kCopyFromBuffer) {
+    chunk.data = malloc(size); // NOLINT(build/unsigned)
+    if (chunk.data == nullptr) {
+      throw std::bad_alloc();
+    }
+    std::memcpy(chunk.data, data, size);
+  }
+
+  m_chunks.push_back(chunk);
+  m_iovecs.push_back({ chunk.data, chunk.size });
+  m_header.size += size;
+}
+
+void*
+ScatterGatherFragment::get_data()
+{
+  auto data_size = get_data_size();
+  if (data_size == 0)
+    return nullptr;
+  if (m_chunks.size() == 1)
+    return m_chunks.front().data;
+
+  auto flat = static_cast<uint8_t*>(malloc(data_size)); // NOLINT(build/unsigned)
+  if (flat == nullptr) {
+    throw std::bad_alloc();
+  }
+  size_t offset = 0;
+  for (auto const& chunk : m_chunks) {
+    std::memcpy(flat + offset, chunk.data, chunk.size);
+    offset += chunk.size;
+  }
+
+  release_chunks_();
+  m_chunks.assign(1, { flat, data_size, true });
+  m_iovecs.resize(1);
+  m_iovecs.push_back({ flat, data_size });
+  return flat;
+}
+
+Fragment
+ScatterGatherFragment::to_fragment(std::pmr::memory_resource* memory_resource) const
+{
+  FragmentBuilder builder(get_data_size(), memory_resource);
+  for (auto const& chunk : m_chunks)
+    builder.append(chunk.data, chunk.size);
+
+  auto fragment = builder.finalize();
+  fragment.set_header_fields(m_header);
+  return fragment;
+}
+
+void
+ScatterGatherFragment::release_chunks_()
+{
+  for (auto const& chunk : m_chunks)
+    if (chunk.owned)
+      free(chunk.data);
+  m_chunks.clear();
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SCATTERGATHERFRAGMENT_HPP_
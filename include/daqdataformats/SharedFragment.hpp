@@ -0,0 +1,159 @@
+/**
+ * @file SharedFragment.hpp Reference-counted, read-only Fragment shared by several consumers without copies
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SHAREDFRAGMENT_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SHAREDFRAGMENT_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/Instrumentation.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Handle to a read-only Fragment whose array is shared by every copy of the handle
+ *
+ * The Fragment array is allocated once, right after a control block holding an atomic reference count, so copying a
+ * handle only increments the count and the array is released with the last handle. Handles can be copied to and
+ * released from any thread, e.g. to fan a Fragment out to storage, monitoring and trigger consumers.
+ *
+ * The Fragment is immutable once shared: set its header fields before creating the SharedFragment.
+ */
+class SharedFragment
+{
+public:
+  /**
+   * @brief Construct an empty handle
+   */
+  SharedFragment() = default;
+
+  /**
+   * @brief Construct a SharedFragment with a copy of a Fragment's array. This is the only copy made.
+   * @param fragment Fragment to copy
+   * @param memory_resource Memory resource to allocate the array from (nullptr means malloc/free)
+   */
+  inline explicit SharedFragment(const Fragment& fragment, std::pmr::memory_resource* memory_resource = nullptr);
+
+  /**
+   * @brief Construct a SharedFragment from a header and payload pieces, written directly into the shared array
+   * @param header Header fields of the Fragment. The size field is computed from the pieces.
+   * @param pieces Vector of pairs of pointer/size pairs used to initialize the Fragment payload
+   * @param memory_resource Memory resource to allocate the array from (nullptr means malloc/free)
+   */
+  inline SharedFragment(const FragmentHeader& header,
+                        const std::vector<std::pair<void*, size_t>>& pieces,
+                        std::pmr::memory_resource* memory_resource = nullptr);
+
+  SharedFragment(SharedFragment const& other) noexcept
+    : m_control(other.m_control)
+  {
+    if (m_control != nullptr)
+      m_control->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  SharedFragment& operator=(SharedFragment const& other) noexcept
+  {
+    SharedFragment(other).swap(*this);
+    return *this;
+  }
+  SharedFragment(SharedFragment&& other) noexcept
+    : m_control(std::exchange(other.m_control, nullptr))
+  {
+  }
+  SharedFragment& operator=(SharedFragment&& other) noexcept
+  {
+    SharedFragment(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief SharedFragment destructor, releasing the array if this is the last handle
+   */
+  ~SharedFragment() { release_(); }
+
+  /**
+   * @brief Read-only view of the Fragment, valid as long as this handle
+   */
+  const Fragment& operator*() const { return m_control->view; }
+  const Fragment* operator->() const { return &m_control->view; }
+
+  /**
+   * @brief Pointer to the read-only view of the Fragment, nullptr for an empty handle
+   */
+  const Fragment* get() const { return m_control != nullptr ? &m_control->view : nullptr; }
+
+  /**
+   * @brief Whether the handle refers to a Fragment
+   */
+  explicit operator bool() const { return m_control != nullptr; }
+
+  /**
+   * @brief Number of handles sharing the Fragment, 0 for an empty handle
+   *
+   * The value may be out of date as soon as it is returned if other threads copy or release handles.
+   */
+  size_t use_count() const { return m_control != nullptr ? m_control->ref_count.load(std::memory_order_relaxed) : 0; }
+
+  /**
+   * @brief Release this handle's reference and make it empty
+   */
+  void reset() noexcept
+  {
+    release_();
+    m_control = nullptr;
+  }
+
+  void swap(SharedFragment& other) noexcept { std::swap(m_control, other.m_control); }
+
+private:
+  /**
+   * @brief Allocated in front of the Fragment array
+   */
+  struct ControlBlock
+  {
+    std::atomic<size_t> ref_count;
+    std::pmr::memory_resource* memory_resource; ///< Where the allocation is returned to, nullptr for free()
+    size_t alloc_size;                          ///< Size of the whole allocation, control block included
+    Fragment view;                              ///< kReadOnlyMode Fragment over the array
+  };
+
+  /**
+   * @brief Offset of the Fragment array in the allocation, keeping it aligned as the arrays of Fragment are
+   */
+  static constexpr size_t s_array_offset =
+    (sizeof(ControlBlock) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  /**
+   * @brief Allocate the control block and an array of the given size, and initialize the control block
+   * @return Pointer to the array, whose contents are left to the caller
+   */
+  inline void* allocate_(size_t fragment_size, std::pmr::memory_resource* memory_resource);
+
+  /**
+   * @brief Drop this handle's reference, destroying the control block and array with the last one
+   */
+  inline void release_() noexcept;
+
+  ControlBlock* m_control{ nullptr };
+};
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/SharedFragment.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SHAREDFRAGMENT_HPP_
@@ -9,15 +9,22 @@
 #ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SOURCEID_HPP_
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SOURCEID_HPP_
 
+#include "daqdataformats/CharReader.hpp"
+#include "daqdataformats/CharWriter.hpp"
+#include "daqdataformats/NameTable.hpp"
+
 #include <cassert>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <istream>
 #include <limits>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 namespace dunedaq::daqdataformats {
@@ -82,24 +89,77 @@ struct SourceID
 
   std::string to_string() const
   {
-    std::ostringstream ostr;
-    ostr << subsystem_to_string(subsystem) << "_0x" << std::hex << std::setfill('0') << std::setw(2 * sizeof(id)) << id;
-    return ostr.str();
+    char buffer[s_to_chars_max_size];
+    auto result = to_string_chars(buffer, buffer + sizeof(buffer));
+    return std::string(buffer, result.ptr);
   }
 
+  /**
+   * @brief Write the to_string() form of this SourceID (e.g. "Trigger_0x0000002a") into a buffer, without allocating
+   * @param first Start of the buffer
+   * @param last End of the buffer
+   * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+   *
+   * This is not the operator<< form written by the free to_chars(first, last, source_id).
+   */
+  inline std::to_chars_result to_string_chars(char* first, char* last) const noexcept;
+
   bool is_in_valid_state() const noexcept { return subsystem != Subsystem::kUnknown && id != s_invalid_id; }
 
+  /**
+   * @brief Get the subsystem and id packed into one integer, e.g. for hashing
+   * @return (subsystem << 32) | id. The version is not part of the key, as it is not part of the comparison operators.
+   */
+  constexpr uint64_t packed_key() const noexcept // NOLINT(build/unsigned)
+  {
+    return (static_cast<uint64_t>(subsystem) << 32) | id; // NOLINT(build/unsigned)
+  }
+
   /**
    * @brief Comparison operators to allow SourceID to be used in std::map
+   *
+   * SourceIDs are ordered by subsystem then id, and compared as a single packed_key(); the version is ignored.
    */
   inline bool operator<(const SourceID& other) const noexcept;
   inline bool operator!=(const SourceID& other) const noexcept;
   inline bool operator==(const SourceID& other) const noexcept;
 
+  /**
+   * @brief Get the name of a Subsystem, without allocating
+   * @return Name of the given subsystem, "Unknown" for values that are not Subsystems
+   */
+  static constexpr std::string_view get_subsystem_name(Subsystem type) noexcept;
+
+  /**
+   * @brief Find the Subsystem with a given name, without allocating
+   * @return Subsystem with this name, Subsystem::kUnknown if there is none
+   */
+  static constexpr Subsystem find_subsystem(std::string_view name) noexcept;
+
   inline static std::string subsystem_to_string(const Subsystem& type);
   inline static Subsystem string_to_subsystem(const std::string& typestring);
 };
 
+/**
+ * @brief Check whether a SourceID is in an array, using vector instructions when the CPU supports them
+ * @param source_id SourceID to look for
+ * @param source_ids Array of SourceIDs
+ * @param count Number of SourceIDs in the array
+ * @return Whether one of the SourceIDs compares equal to source_id (ignoring the version, as operator== does)
+ */
+inline bool
+match_any(SourceID const& source_id, const SourceID* source_ids, size_t count);
+
+/**
+ * @brief Find the first occurrence of a SourceID in an array, using vector instructions when the CPU supports them
+ * @param source_id SourceID to look for
+ * @param source_ids Array of SourceIDs
+ * @param count Number of SourceIDs in the array
+ * @return Position of the first SourceID comparing equal to source_id, or count if there is none
+ */
+inline size_t
+find_match(SourceID const& source_id, const SourceID* source_ids, size_t count);
+
 } // namespace dunedaq::daqdataformats
 
 #include "detail/SourceID.hxx"
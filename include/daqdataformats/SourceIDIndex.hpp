@@ -0,0 +1,140 @@
+/**
+ * @file SourceIDIndex.hpp Hash index from SourceID to a position in an array
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SOURCEIDINDEX_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SOURCEIDINDEX_HPP_
+
+#include "daqdataformats/SourceID.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Open-addressing hash table mapping SourceID::packed_key() to the position of the first element with that
+ * key in an array (ComponentRequests, Fragments, ...)
+ *
+ * The table is at most half full and uses linear probing, so lookups take constant time on average and touch one or
+ * two cache lines. It does not keep a reference to the array: callers check the element at the returned position.
+ */
+class SourceIDIndex
+{
+public:
+  /**
+   * @brief Position returned by find() for a key that is not in the index
+   */
+  static constexpr size_t s_not_found = std::numeric_limits<size_t>::max();
+
+  /**
+   * @brief Build the index over an array
+   * @param size Number of elements in the array
+   * @param key_at Callable returning the packed SourceID key of the element at a position
+   *
+   * When several elements have the same key, the first one is indexed.
+   */
+  template<typename KeyAt>
+  void build(size_t size, KeyAt key_at)
+  {
+    resize_(size);
+    for (size_t position = 0; position < size; ++position)
+      insert_(key_at(position), position + 1);
+  }
+
+  /**
+   * @brief Add one element to the index, growing the table as needed
+   * @param key Packed SourceID key of the element
+   * @param position Position of the element in the array. It is not indexed if the key already is.
+   *
+   * Inserting n elements one by one takes O(n) time on average.
+   */
+  void insert(uint64_t key, size_t position) // NOLINT(build/unsigned)
+  {
+    if (2 * (m_num_keys + 1) > m_slots.size()) {
+      auto slots = std::move(m_slots);
+      resize_(m_num_keys + 1);
+      for (auto const& slot : slots)
+        if (slot.position != 0)
+          insert_(slot.key, slot.position);
+    }
+    insert_(key, position + 1);
+  }
+
+  /**
+   * @brief Find the position of a key
+   * @param key Packed SourceID key
+   * @return Position of the first element with this key, or s_not_found
+   */
+  size_t find(uint64_t key) const // NOLINT(build/unsigned)
+  {
+    if (m_slots.empty())
+      return s_not_found;
+    auto mask = m_slots.size() - 1;
+    for (auto slot = hash_slot_(key);; slot = (slot + 1) & mask) {
+      if (m_slots[slot].position == 0)
+        return s_not_found;
+      if (m_slots[slot].key == key)
+        return m_slots[slot].position - 1;
+    }
+  }
+
+  /**
+   * @brief Find the position of a SourceID
+   * @param source_id SourceID to look for
+   * @return Position of the first element with this SourceID, or s_not_found
+   */
+  size_t find(SourceID const& source_id) const { return find(source_id.packed_key()); }
+
+private:
+  /**
+   * @brief Empty the table and size it for the given number of keys, keeping it at most half full
+   */
+  void resize_(size_t num_keys)
+  {
+    unsigned log2_slots = 1;
+    while ((size_t(1) << log2_slots) < 2 * num_keys)
+      ++log2_slots;
+    m_slots.assign(size_t(1) << log2_slots, { 0, 0 });
+    m_shift = 64 - log2_slots;
+    m_num_keys = 0;
+  }
+
+  void insert_(uint64_t key, size_t stored_position) // NOLINT(build/unsigned)
+  {
+    auto mask = m_slots.size() - 1;
+    auto slot = hash_slot_(key);
+    while (m_slots[slot].position != 0 && m_slots[slot].key != key)
+      slot = (slot + 1) & mask;
+    if (m_slots[slot].position == 0) {
+      m_slots[slot] = { key, stored_position };
+      ++m_num_keys;
+    }
+  }
+
+  size_t hash_slot_(uint64_t key) const // NOLINT(build/unsigned)
+  {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> m_shift);
+  }
+
+  struct Slot
+  {
+    uint64_t key;    ///< SourceID::packed_key() // NOLINT(build/unsigned)
+    size_t position; ///< Position in the array plus one, 0 for an empty slot
+  };
+
+  std::vector<Slot> m_slots; ///< Power-of-two number of slots
+  unsigned m_shift{ 63 };    ///< 64 - log2(m_slots.size()), to take the top bits of the hash
+  size_t m_num_keys{ 0 };    ///< Number of occupied slots
+};
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_SOURCEIDINDEX_HPP_
@@ -9,10 +9,13 @@
 #ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TIMESLICEHEADER_HPP_
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TIMESLICEHEADER_HPP_
 
+#include "daqdataformats/CharReader.hpp"
+#include "daqdataformats/CharWriter.hpp"
 #include "daqdataformats/ComponentRequest.hpp"
 #include "daqdataformats/SourceID.hpp"
 #include "daqdataformats/Types.hpp"
 
+#include <charconv>
 #include <cstddef>
 #include <limits>
 #include <ostream>
@@ -90,6 +93,48 @@ operator<<(std::ostream& o, TimeSliceHeader const& hdr)
            << "element_id: { " << hdr.element_id << " }";
 }
 
+/**
+ * @brief Write a TimeSliceHeader into a buffer, as operator<< streams it, without allocating
+ * @param first Start of the buffer
+ * @param last End of the buffer
+ * @param hdr TimeSliceHeader to write
+ * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+ */
+inline std::to_chars_result
+to_chars(char* first, char* last, TimeSliceHeader const& hdr) noexcept
+{
+  CharWriter writer(first, last);
+  writer.write("check_word: ").write_hex(hdr.timeslice_header_marker).write(", ")
+    .write("version: ").write_dec(hdr.version).write(", ")
+    .write("timeslice_number: ").write_dec(hdr.timeslice_number).write(", ")
+    .write("run_number: ").write_dec(hdr.run_number).write(", ")
+    .write("element_id: { ").write_object(hdr.element_id).write(" }");
+  return writer.result();
+}
+
+/**
+ * @brief Parse a TimeSliceHeader from the text written by operator<< and to_chars, without allocating
+ * @param first Start of the text
+ * @param last End of the text
+ * @param hdr TimeSliceHeader to fill. It is only modified if parsing succeeds.
+ * @return One past the last character parsed, or the position of the first mismatch and std::errc::invalid_argument
+ * (or std::errc::result_out_of_range for a number too large for its field)
+ */
+inline std::from_chars_result
+from_chars(const char* first, const char* last, TimeSliceHeader& hdr) noexcept
+{
+  TimeSliceHeader parsed = hdr;
+  CharReader reader(first, last);
+  reader.expect("check_word: ").read_hex(parsed.timeslice_header_marker).expect(", ")
+    .expect("version: ").read_dec(parsed.version).expect(", ")
+    .expect("timeslice_number: ").read_dec(parsed.timeslice_number).expect(", ")
+    .expect("run_number: ").read_dec(parsed.run_number).expect(", ")
+    .expect("element_id: { ").read_object(parsed.element_id).expect(" }");
+  if (reader.ok())
+    hdr = parsed;
+  return reader.result();
+}
+
 /**
  * @brief Read a TimeSliceHeader instance from a string stream
  * @param is Stream to read from
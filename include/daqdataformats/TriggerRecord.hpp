@@ -10,10 +10,18 @@
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORD_HPP_
 
 #include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/Instrumentation.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/SourceIDIndex.hpp"
 #include "daqdataformats/TriggerRecordHeader.hpp"
 #include "daqdataformats/Types.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -26,6 +34,11 @@ namespace dunedaq::daqdataformats {
 class TriggerRecord
 {
 public:
+  /**
+   * @brief Alignment of the offset table and of each Fragment in the serialized image
+   */
+  static constexpr size_t s_serialized_alignment = 8;
+
   /**
    * @brief Construct a TriggerRecord using the given vector of components to initialize the TriggerRecordHeader
    * @param components List of components requested for this TriggerRecord
@@ -38,6 +51,22 @@ public:
    */
   inline explicit TriggerRecord(TriggerRecordHeader const& header);
 
+  /**
+   * @brief Tag selecting the constructor that takes over a TriggerRecordHeader instead of copying it
+   */
+  struct AdoptHeader
+  {
+    explicit AdoptHeader() = default;
+  };
+  static constexpr AdoptHeader s_adopt_header{}; ///< Value of the AdoptHeader tag
+
+  /**
+   * @brief Construct a TriggerRecord taking over the given TriggerRecordHeader
+   * @param header TriggerRecordHeader to *move* into the TriggerRecord. A non-owning header stays non-owning, i.e.
+   * the TriggerRecord then points into the header's buffer, which must outlive it.
+   */
+  inline TriggerRecord(AdoptHeader, TriggerRecordHeader&& header);
+
   virtual ~TriggerRecord() = default; ///< TriggerRecord default destructor
 
   TriggerRecord(TriggerRecord const&) = delete;            ///< TriggerRecords are not copy-constructible
@@ -45,6 +74,28 @@ public:
   TriggerRecord& operator=(TriggerRecord const&) = delete; ///< TriggerRecords are not copy-assignable
   TriggerRecord& operator=(TriggerRecord&&) = default;     ///< Default TriggerRecord move assignment operator
 
+  /**
+   * @brief Contiguous range of Fragment pointers, as returned by fragments_for_subsystem
+   */
+  class FragmentRange
+  {
+  public:
+    FragmentRange(Fragment* const* first, Fragment* const* last)
+      : m_first(first)
+      , m_last(last)
+    {}
+
+    Fragment* const* begin() const { return m_first; }
+    Fragment* const* end() const { return m_last; }
+    size_t size() const { return static_cast<size_t>(m_last - m_first); }
+    bool empty() const { return m_first == m_last; }
+    Fragment* operator[](size_t idx) const { return m_first[idx]; }
+
+  private:
+    Fragment* const* m_first;
+    Fragment* const* m_last;
+  };
+
   /**
    * @brief Get a handle to the TriggerRecordHeader
    * @return A reference to the TriggerRecordHeader
@@ -67,17 +118,61 @@ public:
    * @return A reference to the Fragments vector
    */
   const std::vector<std::unique_ptr<Fragment>>& get_fragments_ref() const { return m_fragments; }
+  /**
+   * @brief Get a modifiable handle to the Fragments
+   * @return A reference to the Fragments vector
+   *
+   * The SourceID index used by find_fragment and fragments_for_subsystem is maintained by add_fragment and
+   * set_fragments. Call reindex_fragments after changing the Fragments vector through this reference, or a
+   * Fragment's element_id.
+   */
   std::vector<std::unique_ptr<Fragment>>& get_fragments_ref() { return m_fragments; }
   /**
    * @brief Set the Fragments vector to the given vector of Fragments
    * @param fragments Fragments vector to use
    */
-  void set_fragments(std::vector<std::unique_ptr<Fragment>>&& fragments) { m_fragments = std::move(fragments); }
+  void set_fragments(std::vector<std::unique_ptr<Fragment>>&& fragments)
+  {
+    m_fragments = std::move(fragments);
+    reindex_fragments();
+  }
   /**
    * @brief Add a Fragment pointer to the Fragments vector
    * @param fragment Fragment to add
+   *
+   * The Fragment is added to the SourceID index in constant time on average. Keeping its subsystem in id order is
+   * an append when the Fragment has the largest id so far, and otherwise takes time linear in the number of
+   * Fragments of the subsystem with larger ids, so Fragments added in reverse id order cost quadratic time in total.
+   */
+  void add_fragment(std::unique_ptr<Fragment>&& fragment)
+  {
+    m_fragments.emplace_back(std::move(fragment));
+    index_fragment_(m_fragments.size() - 1);
+  }
+
+  /**
+   * @brief Find a Fragment by SourceID
+   * @param source_id SourceID to look for
+   * @return Pointer to the first Fragment with this element_id, or nullptr if there is none
+   *
+   * Lookups take constant time on average. They only read the index, so they may run concurrently with each other.
+   */
+  inline Fragment* find_fragment(SourceID const& source_id) const;
+
+  /**
+   * @brief Get the Fragments of one subsystem
+   * @param subsystem Subsystem to look for
+   * @return Range of the Fragments whose element_id is in this subsystem, ordered by id then by position in the
+   * Fragments vector. It is invalidated by add_fragment, set_fragments and reindex_fragments.
    */
-  void add_fragment(std::unique_ptr<Fragment>&& fragment) { m_fragments.emplace_back(std::move(fragment)); }
+  inline FragmentRange fragments_for_subsystem(SourceID::Subsystem subsystem) const;
+
+  /**
+   * @brief Rebuild the SourceID index from the Fragments vector
+   *
+   * Needed only after changing the Fragments vector through get_fragments_ref, or a Fragment's element_id.
+   */
+  inline void reindex_fragments();
 
   /**
    * @brief Get size of trigger record from underlying TriggerRecordHeader and Fragments
@@ -105,9 +200,54 @@ public:
     return total_size;
   }
 
+  /**
+   * @brief Get the size of the contiguous image written by serialize_into
+   * @return Size in bytes of the serialized TriggerRecord
+   */
+  inline size_t serialized_size() const;
+
+  /**
+   * @brief Write the TriggerRecord as one contiguous image
+   * @param buffer Destination buffer
+   * @param size Size of the destination buffer
+   * @return Number of bytes written, equal to serialized_size()
+   * @throws std::length_error if the buffer is smaller than serialized_size()
+   *
+   * The image holds the TriggerRecordHeader flat array, an offset table (uint64_t number of Fragments followed by
+   * the uint64_t offset of each Fragment from the start of the image) and the Fragment flat arrays. The offset table
+   * and each Fragment start on an s_serialized_alignment boundary, padding is zero-filled. Use TriggerRecordView to
+   * read it back.
+   */
+  inline size_t serialize_into(void* buffer, size_t size) const;
+
+  /**
+   * @brief Round a size up to the next s_serialized_alignment boundary
+   */
+  static constexpr size_t align_serialized(size_t size)
+  {
+    return (size + s_serialized_alignment - 1) & ~(s_serialized_alignment - 1);
+  }
+
 private:
-  TriggerRecordHeader m_header;                       ///< TriggerRecordHeader object
-  std::vector<std::unique_ptr<Fragment>> m_fragments; ///< Vector of unique_ptrs to Fragment objects
+  /**
+   * @brief Fragments of one subsystem, sorted by id
+   */
+  struct SubsystemFragments
+  {
+    SourceID::Subsystem subsystem;
+    std::vector<SourceID::ID_t> ids;  ///< Sorted ids
+    std::vector<Fragment*> fragments; ///< Fragments, in the order of ids then of position in m_fragments
+  };
+
+  /**
+   * @brief Add the Fragment at a position of m_fragments to the SourceID index
+   */
+  inline void index_fragment_(size_t position);
+
+  TriggerRecordHeader m_header;                          ///< TriggerRecordHeader object
+  std::vector<std::unique_ptr<Fragment>> m_fragments;    ///< Vector of unique_ptrs to Fragment objects
+  SourceIDIndex m_fragment_index;                        ///< Position of the first Fragment of each SourceID
+  std::vector<SubsystemFragments> m_subsystem_fragments; ///< Fragments of each subsystem present, for range queries
 };
 
 //-------
@@ -122,6 +262,115 @@ TriggerRecord::TriggerRecord(TriggerRecordHeader const& header)
   , m_fragments()
 {}
 
+TriggerRecord::TriggerRecord(AdoptHeader, TriggerRecordHeader&& header)
+  : m_header(std::move(header))
+  , m_fragments()
+{}
+
+Fragment*
+TriggerRecord::find_fragment(SourceID const& source_id) const
+{
+  auto position = m_fragment_index.find(source_id);
+  return position == SourceIDIndex::s_not_found ? nullptr : m_fragments[position].get();
+}
+
+TriggerRecord::FragmentRange
+TriggerRecord::fragments_for_subsystem(SourceID::Subsystem subsystem) const
+{
+  for (auto const& entry : m_subsystem_fragments)
+    if (entry.subsystem == subsystem)
+      return FragmentRange(entry.fragments.data(), entry.fragments.data() + entry.fragments.size());
+  return FragmentRange(nullptr, nullptr);
+}
+
+void
+TriggerRecord::reindex_fragments()
+{
+  m_fragment_index = SourceIDIndex();
+  std::vector<std::pair<uint64_t, Fragment*>> sorted; // NOLINT(build/unsigned)
+  sorted.reserve(m_fragments.size());
+  for (size_t position = 0; position < m_fragments.size(); ++position) {
+    if (m_fragments[position] == nullptr)
+      continue;
+    auto key = m_fragments[position]->get_element_id().packed_key();
+    m_fragment_index.insert(key, position);
+    sorted.emplace_back(key, m_fragments[position].get());
+  }
+  std::stable_sort(
+    sorted.begin(), sorted.end(), [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+
+  m_subsystem_fragments.clear();
+  for (auto const& entry : sorted) {
+    auto subsystem = static_cast<SourceID::Subsystem>(entry.first >> 32);
+    if (m_subsystem_fragments.empty() || m_subsystem_fragments.back().subsystem != subsystem)
+      m_subsystem_fragments.push_back({ subsystem, {}, {} });
+    m_subsystem_fragments.back().ids.push_back(static_cast<SourceID::ID_t>(entry.first));
+    m_subsystem_fragments.back().fragments.push_back(entry.second);
+  }
+}
+
+void
+TriggerRecord::index_fragment_(size_t position)
+{
+  auto fragment = m_fragments[position].get();
+  if (fragment == nullptr)
+    return;
+  auto source_id = fragment->get_element_id();
+  m_fragment_index.insert(source_id.packed_key(), position);
+
+  auto entry = std::find_if(m_subsystem_fragments.begin(), m_subsystem_fragments.end(), [&](auto const& candidate) {
+    return candidate.subsystem == source_id.subsystem;
+  });
+  if (entry == m_subsystem_fragments.end())
+    entry = m_subsystem_fragments.insert(entry, { source_id.subsystem, {}, {} });
+
+  // Fragments usually arrive in id order, in which case this appends
+  auto at = std::upper_bound(entry->ids.begin(), entry->ids.end(), source_id.id) - entry->ids.begin();
+  entry->ids.insert(entry->ids.begin() + at, source_id.id);
+  entry->fragments.insert(entry->fragments.begin() + at, fragment);
+}
+
+size_t
+TriggerRecord::serialized_size() const
+{
+  size_t size = align_serialized(m_header.get_total_size_bytes()) + sizeof(uint64_t) * (1 + m_fragments.size());
+  for (auto const& frag_ptr : m_fragments)
+    size = align_serialized(size) + frag_ptr->get_size();
+  return size;
+}
+
+size_t
+TriggerRecord::serialize_into(void* buffer, size_t size) const
+{
+  if (size < serialized_size()) {
+    throw std::length_error("Buffer is too small to serialize the TriggerRecord.");
+  }
+
+  auto image = static_cast<uint8_t*>(buffer); // NOLINT(build/unsigned)
+  size_t header_size = m_header.get_total_size_bytes();
+  std::memcpy(image, m_header.get_storage_location(), header_size);
+  size_t offset = align_serialized(header_size);
+  std::memset(image + header_size, 0, offset - header_size);
+
+  auto offset_table = image + offset;
+  uint64_t num_fragments = m_fragments.size(); // NOLINT(build/unsigned)
+  std::memcpy(offset_table, &num_fragments, sizeof(num_fragments));
+  offset += sizeof(uint64_t) * (1 + m_fragments.size());
+
+  for (size_t idx = 0; idx < m_fragments.size(); ++idx) {
+    size_t fragment_offset = align_serialized(offset);
+    std::memset(image + offset, 0, fragment_offset - offset);
+    uint64_t table_entry = fragment_offset; // NOLINT(build/unsigned)
+    std::memcpy(offset_table + sizeof(uint64_t) * (1 + idx), &table_entry, sizeof(table_entry));
+
+    auto fragment_size = m_fragments[idx]->get_size();
+    std::memcpy(image + fragment_offset, m_fragments[idx]->get_storage_location(), fragment_size);
+    offset = fragment_offset + fragment_size;
+  }
+  instrumentation::record_copy(instrumentation::InstrumentedClass::kTriggerRecord, offset);
+  return offset;
+}
+
 } // namespace dunedaq::daqdataformats
 
 #endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORD_HPP_
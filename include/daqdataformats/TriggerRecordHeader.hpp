@@ -10,17 +10,22 @@
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORDHEADER_HPP_
 
 #include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/Instrumentation.hpp"
 #include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/SourceIDIndex.hpp"
 #include "daqdataformats/TriggerRecordHeaderData.hpp"
 #include "daqdataformats/Types.hpp"
 
+#include <atomic>
 #include <bitset>
 #include <cstddef>
 #include <cstring>
+#include <memory_resource>
 #include <new>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace dunedaq::daqdataformats {
@@ -35,26 +40,35 @@ public:
   /**
    * @brief Construct a TriggerRecordHeader using a vector of ComponentRequest objects
    * @param components Vector of ComponentRequests to copy into TriggerRecordHeader
+   * @param memory_resource Memory resource to allocate the data array from (nullptr means malloc/free)
    */
-  inline explicit TriggerRecordHeader(const std::vector<ComponentRequest>& components);
+  inline explicit TriggerRecordHeader(const std::vector<ComponentRequest>& components,
+                                      std::pmr::memory_resource* memory_resource = nullptr);
 
   /**
    * @brief Construct a TriggerRecordHeader using an existing TriggerRecordHeader data array
    * @param existing_trigger_record_header_buffer Pointer to existing TriggerRecordHeader array
    * @param copy_from_buffer Whether to create a copy of the exiting buffer (true) or use that memory without taking
    * ownership (false)
+   * @param memory_resource Memory resource to allocate the copy from (nullptr means malloc/free)
    */
-  inline explicit TriggerRecordHeader(void* existing_trigger_record_header_buffer, bool copy_from_buffer = false);
+  inline explicit TriggerRecordHeader(void* existing_trigger_record_header_buffer,
+                                      bool copy_from_buffer = false,
+                                      std::pmr::memory_resource* memory_resource = nullptr);
 
   /**
    * @brief TriggerRecordHeader Copy Constructor
    * @param other TriggerRecordHeader to copy
+   *
+   * The copy is allocated from the same memory resource as other
    */
   inline TriggerRecordHeader(TriggerRecordHeader const& other);
   /**
    * @brief TriggerRecordHeader copy assignment operator
    * @param other TriggerRecordHeader to copy
    * @return Reference to TriggerRecordHeader copy
+   *
+   * The copy is allocated from the memory resource of this TriggerRecordHeader, which is not changed
    */
   inline TriggerRecordHeader& operator=(TriggerRecordHeader const& other);
 
@@ -63,12 +77,22 @@ public:
     m_alloc = other.m_alloc;
     other.m_alloc = false;
     m_data_arr = other.m_data_arr;
+    m_memory_resource = other.m_memory_resource;
+    m_alloc_size = other.m_alloc_size;
+    m_component_index.store(other.m_component_index.exchange(nullptr));
   }
   TriggerRecordHeader& operator=(TriggerRecordHeader&& other)
   {
+    if (&other == this)
+      return *this;
+
+    deallocate_();
     m_alloc = other.m_alloc;
     other.m_alloc = false;
     m_data_arr = other.m_data_arr;
+    m_memory_resource = other.m_memory_resource;
+    m_alloc_size = other.m_alloc_size;
+    delete m_component_index.exchange(other.m_component_index.exchange(nullptr));
     return *this;
   }
 
@@ -77,15 +101,20 @@ public:
    */
   ~TriggerRecordHeader()
   {
-    if (m_alloc)
-      free(m_data_arr);
+    deallocate_();
+    delete m_component_index.load();
   }
 
   /**
    * @brief Get a copy of the TriggerRecordHeaderData struct
    * @return A copy of the TriggerRecordHeaderData struct stored in this TriggerRecordHeader
    */
-  TriggerRecordHeaderData get_header() const { return *header_(); }
+  TriggerRecordHeaderData get_header() const
+  {
+    instrumentation::record_copy(instrumentation::InstrumentedClass::kTriggerRecordHeader,
+                                 sizeof(TriggerRecordHeaderData));
+    return *header_();
+  }
 
   /**
    * @brief Get the trigger number for this TriggerRecordHeader
@@ -215,6 +244,12 @@ public:
 
   const void* get_storage_location() const { return m_data_arr; }
 
+  /**
+   * @brief Get the memory resource the data array is returned to on destruction
+   * @return Pointer to the memory resource, or nullptr if the array is managed with malloc/free
+   */
+  std::pmr::memory_resource* get_memory_resource() const { return m_memory_resource; }
+
   /**
    * @brief Access ComponentRequest and copy result
    * @param idx Index to access
@@ -228,6 +263,9 @@ public:
    * @param idx Index to access
    * @return ComponentRequest reference
    * @throws std::range_error exception if idx is outside of allowable range
+   *
+   * As the returned reference allows the SourceID to be modified, this discards the SourceID index used by
+   * find_component. It must not be called concurrently with lookups.
    */
   inline ComponentRequest& operator[](size_t idx);
 
@@ -239,6 +277,21 @@ public:
    */
   inline ComponentRequest const& get_component_for_source_id(SourceID const& source_id) const;
 
+  /**
+   * @brief Find the ComponentRequest for a SourceID, without throwing
+   * @param source_id SourceID to look for
+   * @return Pointer to the first ComponentRequest with this SourceID, or nullptr if there is none
+   *
+   * With more than s_component_index_threshold components, the first lookup builds a hash index of the SourceIDs and
+   * later lookups take constant time. Lookups may run concurrently with each other.
+   */
+  inline const ComponentRequest* find_component(SourceID const& source_id) const;
+
+  /**
+   * @brief Number of components above which find_component uses a hash index instead of a linear search
+   */
+  static constexpr size_t s_component_index_threshold = 16;
+
 private:
   /**
    * @brief Get the TriggerRecordHeaderData from the m_data_arr array
@@ -246,23 +299,41 @@ private:
    */
   TriggerRecordHeaderData* header_() const { return static_cast<TriggerRecordHeaderData*>(m_data_arr); }
 
+  /**
+   * @brief Allocate m_data_arr from m_memory_resource (or malloc) and take ownership of it
+   * @param size Number of bytes to allocate
+   */
+  inline void allocate_(size_t size);
+  /**
+   * @brief Release m_data_arr to where it came from, if this TriggerRecordHeader owns it
+   */
+  inline void deallocate_();
+
+  /**
+   * @brief Get the ComponentRequest array following the TriggerRecordHeaderData
+   */
+  ComponentRequest* components_() const { return reinterpret_cast<ComponentRequest*>(header_() + 1); } // NOLINT
+
+  inline const SourceIDIndex* get_component_index_() const;
+
   void* m_data_arr{
     nullptr
   };                     ///< Flat memory containing a TriggerRecordHeaderData header and an array of ComponentRequests
   bool m_alloc{ false }; ///< Whether the TriggerRecordHeader owns the memory pointed by m_data_arr
+  std::pmr::memory_resource* m_memory_resource{ nullptr }; ///< Where m_data_arr is returned to, nullptr for free()
+  size_t m_alloc_size{ 0 }; ///< Size of the m_data_arr allocation, as required by memory_resource::deallocate
+  mutable std::atomic<SourceIDIndex*> m_component_index{ nullptr }; ///< Lazily built SourceID index, owned
 };
 
 //------
 
-TriggerRecordHeader::TriggerRecordHeader(const std::vector<ComponentRequest>& components)
+TriggerRecordHeader::TriggerRecordHeader(const std::vector<ComponentRequest>& components,
+                                         std::pmr::memory_resource* memory_resource)
+  : m_memory_resource(memory_resource)
 {
   size_t size = sizeof(TriggerRecordHeaderData) + components.size() * sizeof(ComponentRequest);
 
-  m_data_arr = malloc(size); // NOLINT(build/unsigned)
-  if (m_data_arr == nullptr) {
-    throw std::bad_alloc();
-  }
-  m_alloc = true;
+  allocate_(size);
 
   TriggerRecordHeaderData header;
   header.num_requested_components = components.size();
@@ -273,27 +344,30 @@ TriggerRecordHeader::TriggerRecordHeader(const std::vector<ComponentRequest>& co
     std::memcpy(static_cast<uint8_t*>(m_data_arr) + offset, &component, sizeof(component)); // NOLINT
     offset += sizeof(component);
   }
+  instrumentation::record_copy(instrumentation::InstrumentedClass::kTriggerRecordHeader, size);
 }
 
-TriggerRecordHeader::TriggerRecordHeader(void* existing_trigger_record_header_buffer, bool copy_from_buffer)
+TriggerRecordHeader::TriggerRecordHeader(void* existing_trigger_record_header_buffer,
+                                         bool copy_from_buffer,
+                                         std::pmr::memory_resource* memory_resource)
 {
   if (!copy_from_buffer) {
     m_data_arr = existing_trigger_record_header_buffer;
   } else {
-    auto header = reinterpret_cast<TriggerRecordHeaderData*>(existing_trigger_record_header_buffer); // NOLINT
-    size_t size = header->num_requested_components * sizeof(ComponentRequest) + sizeof(TriggerRecordHeaderData);
+    // The buffer need not be aligned for a TriggerRecordHeaderData, so the header is read with memcpy
+    TriggerRecordHeaderData header;
+    std::memcpy(&header, existing_trigger_record_header_buffer, sizeof(header));
+    size_t size = header.num_requested_components * sizeof(ComponentRequest) + sizeof(TriggerRecordHeaderData);
 
-    m_data_arr = malloc(size);
-    if (m_data_arr == nullptr) {
-      throw std::bad_alloc();
-    }
-    m_alloc = true;
+    m_memory_resource = memory_resource;
+    allocate_(size);
     std::memcpy(m_data_arr, existing_trigger_record_header_buffer, size);
+    instrumentation::record_copy(instrumentation::InstrumentedClass::kTriggerRecordHeader, size);
   }
 }
 
 TriggerRecordHeader::TriggerRecordHeader(TriggerRecordHeader const& other)
-  : TriggerRecordHeader(other.m_data_arr, true)
+  : TriggerRecordHeader(other.m_data_arr, true, other.m_memory_resource)
 {}
 
 TriggerRecordHeader&
@@ -302,18 +376,45 @@ TriggerRecordHeader::operator=(TriggerRecordHeader const& other)
   if (&other == this)
     return *this;
 
-  if (m_alloc) {
-    free(m_data_arr);
-  }
-  m_data_arr = malloc(other.get_total_size_bytes());
-  if (m_data_arr == nullptr) {
-    throw std::bad_alloc();
-  }
-  m_alloc = true;
+  deallocate_();
+  allocate_(other.get_total_size_bytes());
   std::memcpy(m_data_arr, other.m_data_arr, other.get_total_size_bytes());
+  instrumentation::record_copy(instrumentation::InstrumentedClass::kTriggerRecordHeader, other.get_total_size_bytes());
+  delete m_component_index.exchange(nullptr);
   return *this;
 }
 
+void
+TriggerRecordHeader::allocate_(size_t size)
+{
+  if (m_memory_resource != nullptr) {
+    m_data_arr = m_memory_resource->allocate(size, alignof(std::max_align_t));
+  } else {
+    m_data_arr = malloc(size); // NOLINT(build/unsigned)
+    if (m_data_arr == nullptr) {
+      throw std::bad_alloc();
+    }
+  }
+  m_alloc = true;
+  m_alloc_size = size;
+  instrumentation::record_allocation(instrumentation::InstrumentedClass::kTriggerRecordHeader, size);
+}
+
+void
+TriggerRecordHeader::deallocate_()
+{
+  if (!m_alloc)
+    return;
+
+  instrumentation::record_free(instrumentation::InstrumentedClass::kTriggerRecordHeader, m_alloc_size);
+  if (m_memory_resource != nullptr) {
+    m_memory_resource->deallocate(m_data_arr, m_alloc_size, alignof(std::max_align_t));
+  } else {
+    free(m_data_arr);
+  }
+  m_alloc = false;
+}
+
 ComponentRequest
 TriggerRecordHeader::at(size_t idx) const
 {
@@ -330,6 +431,7 @@ TriggerRecordHeader::operator[](size_t idx)
   if (idx >= header_()->num_requested_components) {
     throw std::range_error("Supplied ComponentRequest index is larger than the maximum index.");
   }
+  delete m_component_index.exchange(nullptr);
   // Increment header pointer by one to skip header
   return *(reinterpret_cast<ComponentRequest*>(header_() + 1) + idx); // NOLINT
 }
@@ -337,13 +439,50 @@ TriggerRecordHeader::operator[](size_t idx)
 ComponentRequest const&
 TriggerRecordHeader::get_component_for_source_id(SourceID const& source_id) const
 {
-  for (uint64_t idx = 0; idx < get_num_requested_components(); ++idx) {
-    ComponentRequest const& component_obj = *(reinterpret_cast<ComponentRequest*>(header_() + 1) + idx); // NOLINT
-    if (source_id == component_obj.component) {
-      return component_obj;
-    }
+  auto component = find_component(source_id);
+  if (component == nullptr) {
+    throw std::invalid_argument("Supplied SourceID (" + source_id.to_string() +
+                                ") was not found in the ComponentRequest list.");
   }
-  throw std::invalid_argument("Supplied SourceID (" + source_id.to_string() + ") was not found in the ComponentRequest list.");
+  return *component;
+}
+
+const ComponentRequest*
+TriggerRecordHeader::find_component(SourceID const& source_id) const
+{
+  auto num_components = get_num_requested_components();
+  auto components = components_();
+
+  if (num_components <= s_component_index_threshold) {
+    for (uint64_t idx = 0; idx < num_components; ++idx) // NOLINT(build/unsigned)
+      if (source_id == components[idx].component)
+        return components + idx;
+    return nullptr;
+  }
+
+  // The array is checked as well, in case it was modified other than through operator[]
+  auto position = get_component_index_()->find(source_id);
+  if (position < num_components && components[position].component == source_id)
+    return components + position;
+  return nullptr;
+}
+
+const SourceIDIndex*
+TriggerRecordHeader::get_component_index_() const
+{
+  auto index = m_component_index.load(std::memory_order_acquire);
+  if (index != nullptr)
+    return index;
+
+  auto components = components_();
+  auto built = new SourceIDIndex();
+  built->build(get_num_requested_components(), [&](size_t idx) { return components[idx].component.packed_key(); });
+
+  // Concurrent lookups may build the index at the same time; the first one published is kept
+  if (m_component_index.compare_exchange_strong(index, built, std::memory_order_acq_rel, std::memory_order_acquire))
+    return built;
+  delete built;
+  return index;
 }
 
 } // namespace dunedaq::daqdataformats
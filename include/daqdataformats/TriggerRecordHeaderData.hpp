@@ -9,10 +9,13 @@
 #ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORDHEADERDATA_HPP_
 #define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORDHEADERDATA_HPP_
 
+#include "daqdataformats/CharReader.hpp"
+#include "daqdataformats/CharWriter.hpp"
 #include "daqdataformats/ComponentRequest.hpp"
 #include "daqdataformats/SourceID.hpp"
 #include "daqdataformats/Types.hpp"
 
+#include <charconv>
 #include <cstddef>
 #include <limits>
 #include <ostream>
@@ -197,6 +200,60 @@ operator<<(std::ostream& o, TriggerRecordHeaderData const& hdr)
            << "element_id: { " << hdr.element_id << " }";
 }
 
+/**
+ * @brief Write a TriggerRecordHeaderData into a buffer, as operator<< streams it, without allocating
+ * @param first Start of the buffer
+ * @param last End of the buffer
+ * @param hdr TriggerRecordHeaderData to write
+ * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+ */
+inline std::to_chars_result
+to_chars(char* first, char* last, TriggerRecordHeaderData const& hdr) noexcept
+{
+  CharWriter writer(first, last);
+  writer.write("check_word: ").write_hex(hdr.trigger_record_header_marker).write(", ")
+    .write("version: ").write_dec(hdr.version).write(", ")
+    .write("trigger_number: ").write_dec(hdr.trigger_number).write(", ")
+    .write("run_number: ").write_dec(hdr.run_number).write(", ")
+    .write("trigger_timestamp: ").write_dec(hdr.trigger_timestamp).write(", ")
+    .write("trigger_type: ").write_dec(hdr.trigger_type).write(", ")
+    .write("error_bits: ").write_dec(hdr.error_bits).write(", ")
+    .write("num_requested_components: ").write_dec(hdr.num_requested_components).write(", ")
+    .write("sequence_number: ").write_dec(hdr.sequence_number).write(", ")
+    .write("max_sequence_number: ").write_dec(hdr.max_sequence_number).write(", ")
+    .write("element_id: { ").write_object(hdr.element_id).write(" }");
+  return writer.result();
+}
+
+/**
+ * @brief Parse a TriggerRecordHeaderData from the text written by operator<< and to_chars, without allocating
+ * @param first Start of the text
+ * @param last End of the text
+ * @param hdr TriggerRecordHeaderData to fill. It is only modified if parsing succeeds.
+ * @return One past the last character parsed, or the position of the first mismatch and std::errc::invalid_argument
+ * (or std::errc::result_out_of_range for a number too large for its field)
+ */
+inline std::from_chars_result
+from_chars(const char* first, const char* last, TriggerRecordHeaderData& hdr) noexcept
+{
+  TriggerRecordHeaderData parsed = hdr;
+  CharReader reader(first, last);
+  reader.expect("check_word: ").read_hex(parsed.trigger_record_header_marker).expect(", ")
+    .expect("version: ").read_dec(parsed.version).expect(", ")
+    .expect("trigger_number: ").read_dec(parsed.trigger_number).expect(", ")
+    .expect("run_number: ").read_dec(parsed.run_number).expect(", ")
+    .expect("trigger_timestamp: ").read_dec(parsed.trigger_timestamp).expect(", ")
+    .expect("trigger_type: ").read_dec(parsed.trigger_type).expect(", ")
+    .expect("error_bits: ").read_dec(parsed.error_bits).expect(", ")
+    .expect("num_requested_components: ").read_dec(parsed.num_requested_components).expect(", ")
+    .expect("sequence_number: ").read_dec(parsed.sequence_number).expect(", ")
+    .expect("max_sequence_number: ").read_dec(parsed.max_sequence_number).expect(", ")
+    .expect("element_id: { ").read_object(parsed.element_id).expect(" }");
+  if (reader.ok())
+    hdr = parsed;
+  return reader.result();
+}
+
 /**
  * @brief Read a TriggerRecordHeaderData instance from a string stream
  * @param is Stream to read from
@@ -0,0 +1,189 @@
+/**
+ * @file TriggerRecordView.hpp Read-only view of a serialized TriggerRecord image
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORDVIEW_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORDVIEW_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Non-owning view of a TriggerRecord image produced by TriggerRecord::serialize_into
+ *
+ * The image is validated on construction using the TriggerRecordHeader and Fragment marker words and the sizes they
+ * declare, so that no accessor reads outside of the buffer.
+ */
+class TriggerRecordView
+{
+public:
+  /**
+   * @brief Construct a TriggerRecordView over a serialized TriggerRecord
+   * @param buffer Pointer to the image, aligned to TriggerRecord::s_serialized_alignment
+   * @param size Size of the buffer holding the image
+   * @throws std::length_error if the image is truncated
+   * @throws std::invalid_argument if the buffer is misaligned, or a marker word or offset is invalid
+   */
+  inline TriggerRecordView(const void* buffer, size_t size);
+
+  /**
+   * @brief Get the TriggerRecordHeaderData at the start of the image
+   */
+  const TriggerRecordHeaderData& get_header_data() const
+  {
+    return *reinterpret_cast<const TriggerRecordHeaderData*>(m_image); // NOLINT
+  }
+
+  /**
+   * @brief Get a TriggerRecordHeader wrapping the image's header without copying it
+   */
+  TriggerRecordHeader get_header() const
+  {
+    return TriggerRecordHeader(const_cast<uint8_t*>(m_image), false); // NOLINT
+  }
+
+  /**
+   * @brief Get the number of Fragments in the image
+   */
+  size_t get_num_fragments() const { return m_num_fragments; }
+
+  /**
+   * @brief Get the header of a Fragment in the image
+   * @param idx Index of the Fragment
+   * @throws std::range_error if idx is outside of allowable range
+   */
+  const FragmentHeader& get_fragment_header(size_t idx) const
+  {
+    return *reinterpret_cast<const FragmentHeader*>(fragment_location_(idx)); // NOLINT
+  }
+
+  /**
+   * @brief Get a Fragment in the image, in kReadOnlyMode
+   * @param idx Index of the Fragment
+   * @return Fragment pointing into the image
+   * @throws std::range_error if idx is outside of allowable range
+   */
+  Fragment get_fragment(size_t idx) const
+  {
+    return Fragment(const_cast<uint8_t*>(fragment_location_(idx)), Fragment::BufferAdoptionMode::kReadOnlyMode); // NOLINT
+  }
+
+  /**
+   * @brief Get the size of the image
+   */
+  size_t get_size() const { return m_size; }
+
+  /**
+   * @brief Build a TriggerRecord from the image
+   * @param copy_fragments Whether to copy the header and Fragments (true) or have them point into the image (false)
+   * @return The TriggerRecord
+   */
+  inline std::unique_ptr<TriggerRecord> make_trigger_record(bool copy_fragments = true) const;
+
+private:
+  inline const uint8_t* fragment_location_(size_t idx) const; // NOLINT(build/unsigned)
+  inline uint64_t read_table_entry_(size_t idx) const;        // NOLINT(build/unsigned)
+
+  const uint8_t* m_image;      ///< Start of the image // NOLINT(build/unsigned)
+  size_t m_size{ 0 };          ///< Size of the image, up to the end of the last Fragment
+  size_t m_table_offset{ 0 };  ///< Offset of the Fragment offset table
+  size_t m_num_fragments{ 0 }; ///< Number of Fragments in the image
+};
+
+//------
+
+TriggerRecordView::TriggerRecordView(const void* buffer, size_t size)
+  : m_image(static_cast<const uint8_t*>(buffer)) // NOLINT(build/unsigned)
+{
+  if (reinterpret_cast<uintptr_t>(buffer) % TriggerRecord::s_serialized_alignment != 0) { // NOLINT
+    throw std::invalid_argument("Buffer is not aligned to TriggerRecord::s_serialized_alignment.");
+  }
+  if (size < sizeof(TriggerRecordHeaderData)) {
+    throw std::length_error("Buffer is too small to hold a TriggerRecordHeader.");
+  }
+  auto const& header = get_header_data();
+  if (header.trigger_record_header_marker != TriggerRecordHeaderData::s_trigger_record_header_magic) {
+    throw std::invalid_argument("Buffer does not start with a TriggerRecordHeader marker.");
+  }
+  if (header.num_requested_components > (size - sizeof(TriggerRecordHeaderData)) / sizeof(ComponentRequest)) {
+    throw std::length_error("TriggerRecordHeader extends beyond the end of the buffer.");
+  }
+
+  m_table_offset = TriggerRecord::align_serialized(sizeof(TriggerRecordHeaderData) +
+                                                   header.num_requested_components * sizeof(ComponentRequest));
+  if (m_table_offset + sizeof(uint64_t) > size) { // NOLINT(build/unsigned)
+    throw std::length_error("Fragment offset table extends beyond the end of the buffer.");
+  }
+  auto num_fragments = read_table_entry_(0);
+  if (num_fragments > (size - m_table_offset) / sizeof(uint64_t) - 1) { // NOLINT(build/unsigned)
+    throw std::length_error("Fragment offset table extends beyond the end of the buffer.");
+  }
+  m_num_fragments = num_fragments;
+  m_size = m_table_offset + sizeof(uint64_t) * (1 + m_num_fragments); // NOLINT(build/unsigned)
+
+  for (size_t idx = 0; idx < m_num_fragments; ++idx) {
+    auto offset = read_table_entry_(1 + idx);
+    if (offset < m_table_offset + sizeof(uint64_t) * (1 + m_num_fragments) || offset > size || // NOLINT
+        size - offset < sizeof(FragmentHeader) || offset % TriggerRecord::s_serialized_alignment != 0) {
+      throw std::invalid_argument("Fragment " + std::to_string(idx) + " has an invalid offset.");
+    }
+    auto fragment_header = reinterpret_cast<const FragmentHeader*>(m_image + offset); // NOLINT
+    if (fragment_header->fragment_header_marker != FragmentHeader::s_fragment_header_marker) {
+      throw std::invalid_argument("Fragment " + std::to_string(idx) + " does not start with a FragmentHeader marker.");
+    }
+    if (fragment_header->size < sizeof(FragmentHeader) || fragment_header->size > size - offset) {
+      throw std::length_error("Fragment " + std::to_string(idx) + " extends beyond the end of the buffer.");
+    }
+    m_size = std::max<size_t>(m_size, offset + fragment_header->size);
+  }
+}
+
+std::unique_ptr<TriggerRecord>
+TriggerRecordView::make_trigger_record(bool copy_fragments) const
+{
+  auto record = std::make_unique<TriggerRecord>(TriggerRecord::s_adopt_header,
+                                                TriggerRecordHeader(const_cast<uint8_t*>(m_image), // NOLINT
+                                                                    copy_fragments));
+  auto mode = copy_fragments ? Fragment::BufferAdoptionMode::kCopyFromBuffer : Fragment::BufferAdoptionMode::kReadOnlyMode;
+  for (size_t idx = 0; idx < m_num_fragments; ++idx)
+    record->add_fragment(std::make_unique<Fragment>(const_cast<uint8_t*>(fragment_location_(idx)), mode)); // NOLINT
+  return record;
+}
+
+const uint8_t* // NOLINT(build/unsigned)
+TriggerRecordView::fragment_location_(size_t idx) const
+{
+  if (idx >= m_num_fragments) {
+    throw std::range_error("Supplied Fragment index is larger than the maximum index.");
+  }
+  return m_image + read_table_entry_(1 + idx);
+}
+
+uint64_t // NOLINT(build/unsigned)
+TriggerRecordView::read_table_entry_(size_t idx) const
+{
+  uint64_t entry; // NOLINT(build/unsigned)
+  std::memcpy(&entry, m_image + m_table_offset + sizeof(uint64_t) * idx, sizeof(entry));
+  return entry;
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_TRIGGERRECORDVIEW_HPP_
@@ -0,0 +1,192 @@
+/**
+ * @file Validation.hpp Consistency checks of the flat header structs, one at a time and in batches of Fragments
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_VALIDATION_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_VALIDATION_HPP_
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/TimeSlice.hpp"
+#include "daqdataformats/TimeSliceHeader.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Reasons a header fails validation, as bit indices of a ValidationResult
+ */
+enum class ValidationFailure : size_t
+{
+  kTruncated = 0,         ///< The buffer is smaller than the header struct
+  kBadMarker = 1,         ///< The marker word is not the one of the struct
+  kBadVersion = 2,        ///< The version is not the current version of the struct
+  kSizeTooSmall = 3,      ///< The size field is smaller than the header it includes
+  kSizeExceedsBuffer = 4, ///< The size field, or the ComponentRequests that follow the header, extend past the buffer
+  kReversedWindow = 5,    ///< window_begin is after window_end
+  kBadComponent = 6       ///< A ComponentRequest of a TriggerRecordHeader is itself invalid
+};
+
+constexpr size_t s_num_validation_failures = 7; ///< Number of ValidationFailures
+
+/**
+ * @brief Set of the ValidationFailures of a header; none() means the header is valid
+ */
+using ValidationResult = std::bitset<s_num_validation_failures>;
+
+/**
+ * @brief Whether a ValidationResult contains a given failure
+ */
+inline bool
+has_failure(const ValidationResult& result, ValidationFailure failure)
+{
+  return result.test(static_cast<size_t>(failure));
+}
+
+/**
+ * @brief Buffer size to pass when the size of the buffer holding a header is unknown
+ */
+constexpr size_t s_unknown_buffer_size = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief Check the marker, version, size and readout window of a FragmentHeader
+ * @param buffer_size Size of the buffer starting at the header, which the Fragment must fit in
+ */
+inline ValidationResult
+validate(const FragmentHeader& header, size_t buffer_size = s_unknown_buffer_size);
+
+/**
+ * @brief Check the marker and version of a TriggerRecordHeaderData, and that its ComponentRequests fit in the buffer
+ * @param buffer_size Size of the buffer starting at the header, which the TriggerRecordHeader must fit in
+ */
+inline ValidationResult
+validate(const TriggerRecordHeaderData& header, size_t buffer_size = s_unknown_buffer_size);
+
+/**
+ * @brief Check the marker and version of a TimeSliceHeader
+ */
+inline ValidationResult
+validate(const TimeSliceHeader& header);
+
+/**
+ * @brief Check the version and window of a ComponentRequest, and the version of its SourceID
+ */
+inline ValidationResult
+validate(const ComponentRequest& request);
+
+/**
+ * @brief Check the version of a SourceID
+ */
+inline ValidationResult
+validate(const SourceID& source_id);
+
+/**
+ * @brief Validate the header at the start of a raw buffer, which need not be aligned
+ * @tparam T FragmentHeader, TriggerRecordHeaderData or TimeSliceHeader
+ *
+ * For a TriggerRecordHeaderData, the ComponentRequests that follow it are validated too.
+ */
+template<typename T>
+ValidationResult
+validate_buffer(const void* buffer, size_t size);
+
+/**
+ * @brief Bitmap of the Fragments that failed a batched validation, one bit per Fragment
+ */
+class ValidationBitmap
+{
+public:
+  explicit ValidationBitmap(size_t size)
+    : m_words((size + 63) / 64, 0)
+    , m_size(size)
+  {
+  }
+
+  /**
+   * @brief Number of Fragments covered
+   */
+  size_t size() const { return m_size; }
+
+  /**
+   * @brief Whether Fragment i failed
+   */
+  bool test(size_t i) const { return (m_words[i / 64] >> (i % 64)) & 1; }
+
+  /**
+   * @brief Whether no Fragment failed
+   */
+  bool none() const;
+
+  /**
+   * @brief Number of Fragments that failed
+   */
+  size_t count() const;
+
+  /**
+   * @brief Indices of the Fragments that failed, in increasing order
+   */
+  std::vector<size_t> failures() const;
+
+  /**
+   * @brief The bitmap, bit i % 64 of word i / 64 for Fragment i
+   */
+  const std::vector<uint64_t>& words() const { return m_words; } // NOLINT(build/unsigned)
+  std::vector<uint64_t>& words() { return m_words; }             // NOLINT(build/unsigned)
+
+private:
+  std::vector<uint64_t> m_words; // NOLINT(build/unsigned)
+  size_t m_size;
+};
+
+/**
+ * @brief Check the marker, version, size and readout window of many FragmentHeaders at once
+ * @param headers Addresses of the FragmentHeaders, which need not be aligned
+ * @param count Number of FragmentHeaders
+ * @return Bitmap of the headers for which validate(header) would report a failure
+ *
+ * Reads the fields at their fixed offsets in four headers at a time with AVX2, when the CPU supports it. Call
+ * validate() on the failing headers to find out what is wrong with them.
+ */
+inline ValidationBitmap
+validate_fragments(const void* const* headers, size_t count);
+
+/**
+ * @brief Check the headers of a list of Fragments, as in validate_fragments(headers, count)
+ */
+inline ValidationBitmap
+validate_fragments(const std::vector<std::unique_ptr<Fragment>>& fragments);
+
+/**
+ * @brief Check the headers of the Fragments of a TriggerRecord, in Fragment order
+ */
+inline ValidationBitmap
+validate_fragments(const TriggerRecord& record);
+
+/**
+ * @brief Check the headers of the Fragments of a TimeSlice, in Fragment order
+ */
+inline ValidationBitmap
+validate_fragments(const TimeSlice& slice);
+
+} // namespace dunedaq::daqdataformats
+
+#include "detail/Validation.hxx"
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_VALIDATION_HPP_
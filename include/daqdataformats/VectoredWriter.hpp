@@ -0,0 +1,232 @@
+/**
+ * @file VectoredWriter.hpp Gathering writer for TriggerRecords, TimeSlices and Fragments
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_VECTOREDWRITER_HPP_
+#define DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_VECTOREDWRITER_HPP_
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/TimeSlice.hpp"
+#include "daqdataformats/TimeSliceHeader.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <system_error>
+#include <vector>
+
+namespace dunedaq::daqdataformats {
+
+/**
+ * @brief Writes TriggerRecords, TimeSlices and Fragments to a file descriptor with as few system calls as possible
+ *
+ * Objects are queued as iovec entries pointing at their flat storage (the TriggerRecordHeader array and each
+ * Fragment's array); flush() hands them to writev(), or pwritev() when the writer was given a file offset, in batches
+ * of at most IOV_MAX entries. Several objects can be queued before a single flush. The bytes written are the
+ * concatenation of the storage locations, in the order the objects were queued.
+ *
+ * Queued objects must stay alive and unmodified until flush() returns. TimeSliceHeaders are copied when queued, as
+ * TimeSlice only hands out its header by value.
+ */
+class VectoredWriter
+{
+public:
+  /**
+   * @brief Construct a VectoredWriter writing at the current position of the file descriptor, using writev()
+   * @param fd File descriptor to write to. It is not closed by the VectoredWriter.
+   */
+  explicit VectoredWriter(int fd)
+    : m_fd(fd)
+  {}
+
+  /**
+   * @brief Construct a VectoredWriter writing at the given offset, using pwritev()
+   * @param fd File descriptor to write to. It is not closed by the VectoredWriter.
+   * @param offset File offset of the first byte written. It is advanced by each flush().
+   *
+   * The file position of fd is not changed, so several writers can fill disjoint ranges of the same file.
+   */
+  VectoredWriter(int fd, off_t offset)
+    : m_fd(fd)
+    , m_offset(offset)
+    , m_positional(true)
+  {}
+
+  VectoredWriter(VectoredWriter const&) = delete;            ///< VectoredWriter is not copy-constructible
+  VectoredWriter& operator=(VectoredWriter const&) = delete; ///< VectoredWriter is not copy-assignable
+  VectoredWriter(VectoredWriter&&) = default;                ///< Default VectoredWriter move constructor
+  VectoredWriter& operator=(VectoredWriter&&) = default;     ///< Default VectoredWriter move assignment operator
+
+  /**
+   * @brief Queue a Fragment
+   * @param fragment Fragment to write
+   */
+  void add(const Fragment& fragment) { add_buffer(fragment.get_storage_location(), fragment.get_size()); }
+
+  /**
+   * @brief Queue a TriggerRecord: its TriggerRecordHeader followed by its Fragments
+   * @param record TriggerRecord to write
+   */
+  void add(const TriggerRecord& record)
+  {
+    auto const& header = record.get_header_ref();
+    add_buffer(header.get_storage_location(), header.get_total_size_bytes());
+    for (auto const& fragment : record.get_fragments_ref())
+      add(*fragment);
+  }
+
+  /**
+   * @brief Queue a TimeSlice: its TimeSliceHeader followed by its Fragments
+   * @param timeslice TimeSlice to write
+   */
+  void add(const TimeSlice& timeslice)
+  {
+    m_timeslice_headers.push_back(timeslice.get_header());
+    add_buffer(&m_timeslice_headers.back(), sizeof(TimeSliceHeader));
+    for (auto const& fragment : timeslice.get_fragments_ref())
+      add(*fragment);
+  }
+
+  /**
+   * @brief Queue a raw buffer, e.g. a file header or index written next to the records
+   * @param data Pointer to the buffer
+   * @param size Size of the buffer
+   */
+  void add_buffer(const void* data, size_t size)
+  {
+    if (size == 0)
+      return;
+    m_iovecs.push_back({ const_cast<void*>(data), size }); // NOLINT
+    m_pending_bytes += size;
+  }
+
+  /**
+   * @brief Write everything queued since the last flush
+   * @return Number of bytes written
+   * @throws std::system_error if writing fails. The queue is cleared and the offset is advanced past the bytes that
+   * were written.
+   */
+  inline size_t flush();
+
+  /**
+   * @brief Queue an object and flush immediately
+   * @param object TriggerRecord, TimeSlice or Fragment to write
+   * @return Number of bytes written, including anything queued before
+   */
+  template<typename T>
+  size_t write(const T& object)
+  {
+    add(object);
+    return flush();
+  }
+
+  /**
+   * @brief Get the number of bytes queued and not yet written
+   */
+  size_t get_pending_bytes() const { return m_pending_bytes; }
+
+  /**
+   * @brief Get the number of bytes written by this VectoredWriter
+   */
+  size_t get_bytes_written() const { return m_bytes_written; }
+
+  /**
+   * @brief Get the file offset the next flush writes at (only meaningful for positional writers)
+   */
+  off_t get_offset() const { return m_offset; }
+
+  /**
+   * @brief Maximum number of iovec entries passed to one system call
+   */
+  static constexpr size_t s_max_iovecs =
+#ifdef IOV_MAX
+    IOV_MAX;
+#else
+    1024;
+#endif
+
+private:
+  inline ssize_t write_batch_(const iovec* iov, int count);
+  inline void clear_();
+
+  int m_fd;
+  off_t m_offset{ 0 };
+  bool m_positional{ false }; ///< Whether to use pwritev() at m_offset instead of writev()
+  std::vector<iovec> m_iovecs;
+  std::deque<TimeSliceHeader> m_timeslice_headers; ///< Copies of queued TimeSliceHeaders, stable across push_back
+  size_t m_pending_bytes{ 0 };
+  size_t m_bytes_written{ 0 };
+};
+
+//------
+
+size_t
+VectoredWriter::flush()
+{
+  size_t written_total = 0;
+  size_t idx = 0;
+  while (idx < m_iovecs.size()) {
+    auto count = static_cast<int>(std::min(s_max_iovecs, m_iovecs.size() - idx));
+    auto written = write_batch_(&m_iovecs[idx], count);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      auto error = errno;
+      clear_();
+      throw std::system_error(error, std::generic_category(), "VectoredWriter failed to write");
+    }
+    if (written == 0) {
+      clear_();
+      throw std::system_error(EIO, std::generic_category(), "VectoredWriter made no progress");
+    }
+
+    written_total += written;
+    m_bytes_written += written;
+    m_offset += written;
+
+    // Skip the entries that were written completely and trim a partially written one, so that a short write
+    // resumes exactly where it stopped
+    auto remaining = static_cast<size_t>(written);
+    while (remaining > 0 && remaining >= m_iovecs[idx].iov_len)
+      remaining -= m_iovecs[idx++].iov_len;
+    if (remaining > 0) {
+      m_iovecs[idx].iov_base = static_cast<uint8_t*>(m_iovecs[idx].iov_base) + remaining; // NOLINT(build/unsigned)
+      m_iovecs[idx].iov_len -= remaining;
+    }
+  }
+
+  clear_();
+  return written_total;
+}
+
+ssize_t
+VectoredWriter::write_batch_(const iovec* iov, int count)
+{
+  if (m_positional)
+    return ::pwritev(m_fd, iov, count, m_offset);
+  return ::writev(m_fd, iov, count);
+}
+
+void
+VectoredWriter::clear_()
+{
+  m_iovecs.clear();
+  m_timeslice_headers.clear();
+  m_pending_bytes = 0;
+}
+
+} // namespace dunedaq::daqdataformats
+
+#endif // DAQDATAFORMATS_INCLUDE_DAQDATAFORMATS_VECTOREDWRITER_HPP_
@@ -0,0 +1,336 @@
+
+namespace dunedaq::daqdataformats {
+
+namespace detail {
+
+/**
+ * @brief Largest LEB128 encoding of an unsigned integer type
+ */
+template<typename T>
+constexpr size_t s_max_varint_size = (8 * sizeof(T) + 6) / 7;
+
+constexpr size_t s_max_source_id_size =
+  s_max_varint_size<SourceID::Version_t> + s_max_varint_size<SourceID::Subsystem_t> + s_max_varint_size<SourceID::ID_t>;
+
+/**
+ * @brief Writes varints to a buffer known to be large enough
+ */
+class BinaryEncoder
+{
+public:
+  explicit BinaryEncoder(uint8_t* position) // NOLINT(build/unsigned)
+    : m_position(position)
+  {}
+
+  void put_tag(BinaryRecordType type)
+  {
+    *m_position++ = static_cast<uint8_t>(s_binary_record_version << 4 | static_cast<uint8_t>(type)); // NOLINT
+  }
+
+  void put(uint64_t value) // NOLINT(build/unsigned)
+  {
+    while (value >= 0x80) {
+      *m_position++ = static_cast<uint8_t>(value | 0x80); // NOLINT(build/unsigned)
+      value >>= 7;
+    }
+    *m_position++ = static_cast<uint8_t>(value); // NOLINT(build/unsigned)
+  }
+
+  /**
+   * @brief Write the zigzag-encoded difference between two timestamps
+   */
+  void put_delta(uint64_t value, uint64_t reference) // NOLINT(build/unsigned)
+  {
+    auto delta = static_cast<int64_t>(value - reference);
+    put((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63)); // NOLINT(build/unsigned)
+  }
+
+  void put(const SourceID& source_id)
+  {
+    put(source_id.version);
+    put(static_cast<SourceID::Subsystem_t>(source_id.subsystem));
+    put(source_id.id);
+  }
+
+  uint8_t* get_position() const { return m_position; } // NOLINT(build/unsigned)
+
+private:
+  uint8_t* m_position; // NOLINT(build/unsigned)
+};
+
+/**
+ * @brief Reads varints from a buffer, throwing std::invalid_argument on malformed input
+ */
+class BinaryDecoder
+{
+public:
+  BinaryDecoder(const uint8_t* first, const uint8_t* last, const uint8_t* origin) // NOLINT(build/unsigned)
+    : m_position(first)
+    , m_last(last)
+    , m_origin(origin)
+  {}
+
+  void get_tag(BinaryRecordType type)
+  {
+    if (m_position == m_last)
+      fail_("truncated record", m_position);
+    auto tag = *m_position;
+    if ((tag & 0xF) != static_cast<uint8_t>(type)) // NOLINT(build/unsigned)
+      fail_("unexpected record type", m_position);
+    if ((tag >> 4) != s_binary_record_version)
+      fail_("unsupported record version", m_position);
+    ++m_position;
+  }
+
+  uint64_t get() // NOLINT(build/unsigned)
+  {
+    auto start = m_position;
+    uint64_t value = 0; // NOLINT(build/unsigned)
+    for (unsigned shift = 0;; shift += 7) {
+      if (m_position == m_last)
+        fail_("truncated record", start);
+      auto byte = *m_position++;
+      if (shift == 63 && byte > 1)
+        fail_("varint too long", start);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift; // NOLINT(build/unsigned)
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+  }
+
+  template<typename T>
+  void get(T& field)
+  {
+    auto start = m_position;
+    auto value = get();
+    if (value > std::numeric_limits<T>::max())
+      fail_("value out of range", start);
+    field = static_cast<T>(value);
+  }
+
+  uint64_t get_delta(uint64_t reference) // NOLINT(build/unsigned)
+  {
+    auto zigzag = get();
+    auto delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    return reference + static_cast<uint64_t>(delta); // NOLINT(build/unsigned)
+  }
+
+  void get(SourceID& source_id)
+  {
+    get(source_id.version);
+    SourceID::Subsystem_t subsystem;
+    get(subsystem);
+    source_id.subsystem = static_cast<SourceID::Subsystem>(subsystem);
+    get(source_id.id);
+  }
+
+  const uint8_t* get_position() const { return m_position; } // NOLINT(build/unsigned)
+
+private:
+  [[noreturn]] void fail_(const char* what, const uint8_t* at) const // NOLINT(build/unsigned)
+  {
+    throw std::invalid_argument(std::string("Invalid binary record: ") + what + " at byte " +
+                                std::to_string(at - m_origin));
+  }
+
+  const uint8_t* m_position; // NOLINT(build/unsigned)
+  const uint8_t* m_last;     // NOLINT(build/unsigned)
+  const uint8_t* m_origin;   // NOLINT(build/unsigned)
+};
+
+template<>
+struct BinaryRecordTraits<SourceID>
+{
+  static constexpr BinaryRecordType s_type = BinaryRecordType::kSourceID;
+  static constexpr size_t s_max_size = 1 + s_max_source_id_size;
+
+  static void encode(BinaryEncoder& encoder, const SourceID& value) { encoder.put(value); }
+  static void decode(BinaryDecoder& decoder, SourceID& value) { decoder.get(value); }
+};
+
+template<>
+struct BinaryRecordTraits<ComponentRequest>
+{
+  static constexpr BinaryRecordType s_type = BinaryRecordType::kComponentRequest;
+  static constexpr size_t s_max_size =
+    1 + s_max_varint_size<uint32_t> + s_max_source_id_size + 2 * s_max_varint_size<timestamp_t>; // NOLINT
+
+  static void encode(BinaryEncoder& encoder, const ComponentRequest& value)
+  {
+    encoder.put(value.version);
+    encoder.put(value.component);
+    encoder.put(value.window_begin);
+    encoder.put_delta(value.window_end, value.window_begin);
+  }
+
+  static void decode(BinaryDecoder& decoder, ComponentRequest& value)
+  {
+    decoder.get(value.version);
+    decoder.get(value.component);
+    decoder.get(value.window_begin);
+    value.window_end = decoder.get_delta(value.window_begin);
+  }
+};
+
+template<>
+struct BinaryRecordTraits<FragmentHeader>
+{
+  static constexpr BinaryRecordType s_type = BinaryRecordType::kFragmentHeader;
+  static constexpr size_t s_max_size = 1 + s_max_varint_size<uint32_t> + s_max_varint_size<fragment_size_t> + // NOLINT
+                                       s_max_varint_size<trigger_number_t> + s_max_varint_size<run_number_t> +
+                                       3 * s_max_varint_size<timestamp_t> + s_max_varint_size<uint32_t> + // NOLINT
+                                       s_max_varint_size<fragment_type_t> + s_max_varint_size<sequence_number_t> +
+                                       s_max_varint_size<uint16_t> + s_max_source_id_size; // NOLINT(build/unsigned)
+
+  static void encode(BinaryEncoder& encoder, const FragmentHeader& value)
+  {
+    encoder.put(value.version);
+    encoder.put(value.size);
+    encoder.put(value.trigger_number);
+    encoder.put(value.run_number);
+    encoder.put(value.trigger_timestamp);
+    encoder.put_delta(value.window_begin, value.trigger_timestamp);
+    encoder.put_delta(value.window_end, value.window_begin);
+    encoder.put(value.error_bits);
+    encoder.put(value.fragment_type);
+    encoder.put(value.sequence_number);
+    encoder.put(value.detector_id);
+    encoder.put(value.element_id);
+  }
+
+  static void decode(BinaryDecoder& decoder, FragmentHeader& value)
+  {
+    decoder.get(value.version);
+    decoder.get(value.size);
+    decoder.get(value.trigger_number);
+    decoder.get(value.run_number);
+    decoder.get(value.trigger_timestamp);
+    value.window_begin = decoder.get_delta(value.trigger_timestamp);
+    value.window_end = decoder.get_delta(value.window_begin);
+    decoder.get(value.error_bits);
+    decoder.get(value.fragment_type);
+    decoder.get(value.sequence_number);
+    decoder.get(value.detector_id);
+    decoder.get(value.element_id);
+  }
+};
+
+template<>
+struct BinaryRecordTraits<TriggerRecordHeaderData>
+{
+  static constexpr BinaryRecordType s_type = BinaryRecordType::kTriggerRecordHeaderData;
+  static constexpr size_t s_max_size = 1 + s_max_varint_size<uint32_t> + s_max_varint_size<trigger_number_t> + // NOLINT
+                                       s_max_varint_size<run_number_t> + s_max_varint_size<timestamp_t> +
+                                       s_max_varint_size<trigger_type_t> + s_max_varint_size<uint32_t> + // NOLINT
+                                       s_max_varint_size<uint64_t> + 2 * s_max_varint_size<sequence_number_t> + // NOLINT
+                                       s_max_source_id_size;
+
+  static void encode(BinaryEncoder& encoder, const TriggerRecordHeaderData& value)
+  {
+    encoder.put(value.version);
+    encoder.put(value.trigger_number);
+    encoder.put(value.run_number);
+    encoder.put(value.trigger_timestamp);
+    encoder.put(value.trigger_type);
+    encoder.put(value.error_bits);
+    encoder.put(value.num_requested_components);
+    encoder.put(value.sequence_number);
+    encoder.put(value.max_sequence_number);
+    encoder.put(value.element_id);
+  }
+
+  static void decode(BinaryDecoder& decoder, TriggerRecordHeaderData& value)
+  {
+    decoder.get(value.version);
+    decoder.get(value.trigger_number);
+    decoder.get(value.run_number);
+    decoder.get(value.trigger_timestamp);
+    decoder.get(value.trigger_type);
+    decoder.get(value.error_bits);
+    decoder.get(value.num_requested_components);
+    decoder.get(value.sequence_number);
+    decoder.get(value.max_sequence_number);
+    decoder.get(value.element_id);
+  }
+};
+
+template<>
+struct BinaryRecordTraits<TimeSliceHeader>
+{
+  static constexpr BinaryRecordType s_type = BinaryRecordType::kTimeSliceHeader;
+  static constexpr size_t s_max_size = 1 + s_max_varint_size<uint32_t> + s_max_varint_size<timeslice_number_t> + // NOLINT
+                                       s_max_varint_size<run_number_t> + s_max_source_id_size;
+
+  static void encode(BinaryEncoder& encoder, const TimeSliceHeader& value)
+  {
+    encoder.put(value.version);
+    encoder.put(value.timeslice_number);
+    encoder.put(value.run_number);
+    encoder.put(value.element_id);
+  }
+
+  static void decode(BinaryDecoder& decoder, TimeSliceHeader& value)
+  {
+    decoder.get(value.version);
+    decoder.get(value.timeslice_number);
+    decoder.get(value.run_number);
+    decoder.get(value.element_id);
+  }
+};
+
+} // namespace detail
+
+template<typename T>
+void
+encode_binary(const T& value, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  encode_binary_all(&value, 1, out);
+}
+
+template<typename T>
+void
+encode_binary_all(const T* values, size_t count, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  using Traits = detail::BinaryRecordTraits<T>;
+
+  // Encode into the worst-case space, then trim
+  auto old_size = out.size();
+  out.resize(old_size + count * Traits::s_max_size);
+  detail::BinaryEncoder encoder(out.data() + old_size);
+  for (size_t i = 0; i < count; ++i) {
+    encoder.put_tag(Traits::s_type);
+    Traits::encode(encoder, values[i]);
+  }
+  out.resize(encoder.get_position() - out.data());
+}
+
+template<typename T>
+const uint8_t* // NOLINT(build/unsigned)
+decode_binary(const uint8_t* first, const uint8_t* last, T& value) // NOLINT(build/unsigned)
+{
+  using Traits = detail::BinaryRecordTraits<T>;
+
+  detail::BinaryDecoder decoder(first, last, first);
+  T decoded;
+  decoder.get_tag(Traits::s_type);
+  Traits::decode(decoder, decoded);
+  value = decoded;
+  return decoder.get_position();
+}
+
+template<typename T>
+std::vector<T>
+decode_binary_all(const uint8_t* data, size_t size) // NOLINT(build/unsigned)
+{
+  using Traits = detail::BinaryRecordTraits<T>;
+
+  std::vector<T> values;
+  detail::BinaryDecoder decoder(data, data + size, data);
+  while (decoder.get_position() != data + size) {
+    decoder.get_tag(Traits::s_type);
+    Traits::decode(decoder, values.emplace_back());
+  }
+  return values;
+}
+
+} // namespace dunedaq::daqdataformats
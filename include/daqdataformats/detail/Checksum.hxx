@@ -0,0 +1,285 @@
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace dunedaq::daqdataformats {
+
+namespace detail {
+
+constexpr uint32_t s_crc32c_polynomial = 0x82F63B78; // Castagnoli polynomial, bit-reflected // NOLINT(build/unsigned)
+
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>; // NOLINT(build/unsigned)
+
+/**
+ * @brief Tables of the slicing-by-8 algorithm: entry [k][i] is the CRC of byte i followed by k zero bytes
+ */
+constexpr Crc32cTables
+make_crc32c_tables()
+{
+  Crc32cTables tables{};
+  for (uint32_t i = 0; i < 256; ++i) { // NOLINT(build/unsigned)
+    uint32_t crc = i;                  // NOLINT(build/unsigned)
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 1) ? (crc >> 1) ^ s_crc32c_polynomial : crc >> 1;
+    tables[0][i] = crc;
+  }
+  for (size_t k = 1; k < tables.size(); ++k)
+    for (size_t i = 0; i < 256; ++i)
+      tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+  return tables;
+}
+
+inline constexpr Crc32cTables s_crc32c_tables = make_crc32c_tables();
+
+/**
+ * @brief Multiply two polynomials modulo the CRC32C polynomial, in the bit-reflected representation
+ */
+constexpr uint32_t                      // NOLINT(build/unsigned)
+crc32c_multiply(uint32_t a, uint32_t b) // NOLINT(build/unsigned)
+{
+  uint32_t product = 0; // NOLINT(build/unsigned)
+  for (uint32_t bit = uint32_t(1) << 31; bit != 0; bit >>= 1) { // NOLINT(build/unsigned)
+    if (a & bit)
+      product ^= b;
+    b = (b & 1) ? (b >> 1) ^ s_crc32c_polynomial : b >> 1;
+  }
+  return product;
+}
+
+/**
+ * @brief x^(8 * bytes) modulo the CRC32C polynomial
+ */
+constexpr uint32_t // NOLINT(build/unsigned)
+crc32c_zeros_operator(size_t bytes)
+{
+  uint32_t result = uint32_t(1) << 31;      // x^0 // NOLINT(build/unsigned)
+  uint32_t power = uint32_t(1) << (31 - 8); // x^8 // NOLINT(build/unsigned)
+  for (; bytes != 0; bytes >>= 1) {
+    if (bytes & 1)
+      result = crc32c_multiply(result, power);
+    power = crc32c_multiply(power, power);
+  }
+  return result;
+}
+
+using Crc32cShiftTable = std::array<std::array<uint32_t, 256>, 4>; // NOLINT(build/unsigned)
+
+/**
+ * @brief Table of the multiplication by x^(8 * bytes), one byte of the multiplicand at a time
+ *
+ * crc32c(A + B) is crc32c_shift(table for |B|, crc32c(A)) ^ crc32c(B), which is how the interleaved streams of the
+ * SSE4.2 implementation are joined.
+ */
+constexpr Crc32cShiftTable
+make_crc32c_shift_table(size_t bytes)
+{
+  Crc32cShiftTable table{};
+  auto zeros = crc32c_zeros_operator(bytes);
+  for (size_t k = 0; k < table.size(); ++k)
+    for (uint32_t i = 0; i < 256; ++i) // NOLINT(build/unsigned)
+      table[k][i] = crc32c_multiply(zeros, i << (8 * k));
+  return table;
+}
+
+inline uint32_t                                           // NOLINT(build/unsigned)
+crc32c_shift(const Crc32cShiftTable& table, uint32_t crc) // NOLINT(build/unsigned)
+{
+  return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+inline uint64_t                 // NOLINT(build/unsigned)
+load_le64(const uint8_t* bytes) // NOLINT(build/unsigned)
+{
+  uint64_t word; // NOLINT(build/unsigned)
+  std::memcpy(&word, bytes, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+/**
+ * @brief Slicing-by-8 CRC32C, on the inverted CRC register
+ */
+inline uint32_t                                                        // NOLINT(build/unsigned)
+crc32c_scalar(uint32_t reg, const uint8_t* data, size_t size) noexcept // NOLINT(build/unsigned)
+{
+  auto const& t = s_crc32c_tables;
+  for (; size >= 8; data += 8, size -= 8) {
+    auto word = load_le64(data);
+    auto low = reg ^ static_cast<uint32_t>(word);  // NOLINT(build/unsigned)
+    auto high = static_cast<uint32_t>(word >> 32); // NOLINT(build/unsigned)
+    reg = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+          t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+  }
+  for (; size > 0; ++data, --size)
+    reg = (reg >> 8) ^ t[0][(reg ^ *data) & 0xFF];
+  return reg;
+}
+
+#if defined(__x86_64__)
+
+// Stream lengths of the SSE4.2 implementation. The crc32 instruction has a latency of three cycles and a throughput
+// of one per cycle, so three independent streams keep it busy. Long streams make the cost of joining them negligible;
+// short ones let medium-sized buffers use the three streams as well.
+constexpr size_t s_crc32c_long_stream = 8192;
+constexpr size_t s_crc32c_short_stream = 256;
+
+inline constexpr Crc32cShiftTable s_crc32c_long_shift = make_crc32c_shift_table(s_crc32c_long_stream);
+inline constexpr Crc32cShiftTable s_crc32c_short_shift = make_crc32c_shift_table(s_crc32c_short_stream);
+
+/**
+ * @brief Process as many blocks of three interleaved streams of the given length as fit, on the inverted CRC register
+ */
+__attribute__((target("sse4.2"))) inline uint32_t // NOLINT(build/unsigned)
+crc32c_sse42_streams(uint32_t reg,                  // NOLINT(build/unsigned)
+                     const uint8_t*& data,          // NOLINT(build/unsigned)
+                     size_t& size,
+                     size_t stream_length,
+                     const Crc32cShiftTable& shift) noexcept
+{
+  while (size >= 3 * stream_length) {
+    uint64_t reg_a = reg, reg_b = 0xFFFFFFFF, reg_c = 0xFFFFFFFF; // NOLINT(build/unsigned)
+    auto a = data;
+    auto b = data + stream_length;
+    auto c = data + 2 * stream_length;
+    for (size_t offset = 0; offset < stream_length; offset += 8) {
+      reg_a = _mm_crc32_u64(reg_a, load_le64(a + offset));
+      reg_b = _mm_crc32_u64(reg_b, load_le64(b + offset));
+      reg_c = _mm_crc32_u64(reg_c, load_le64(c + offset));
+    }
+    // Join the final (non-inverted) CRCs of the streams
+    auto crc = crc32c_shift(shift, ~static_cast<uint32_t>(reg_a)) ^ ~static_cast<uint32_t>(reg_b); // NOLINT
+    crc = crc32c_shift(shift, crc) ^ ~static_cast<uint32_t>(reg_c);                                // NOLINT
+    reg = ~crc;
+    data += 3 * stream_length;
+    size -= 3 * stream_length;
+  }
+  return reg;
+}
+
+/**
+ * @brief SSE4.2 CRC32C, on the inverted CRC register
+ */
+__attribute__((target("sse4.2"))) inline uint32_t                     // NOLINT(build/unsigned)
+crc32c_sse42(uint32_t reg, const uint8_t* data, size_t size) noexcept // NOLINT(build/unsigned)
+{
+  reg = crc32c_sse42_streams(reg, data, size, s_crc32c_long_stream, s_crc32c_long_shift);
+  reg = crc32c_sse42_streams(reg, data, size, s_crc32c_short_stream, s_crc32c_short_shift);
+  uint64_t reg64 = reg; // NOLINT(build/unsigned)
+  for (; size >= 8; data += 8, size -= 8)
+    reg64 = _mm_crc32_u64(reg64, load_le64(data));
+  reg = static_cast<uint32_t>(reg64); // NOLINT(build/unsigned)
+  for (; size > 0; ++data, --size)
+    reg = _mm_crc32_u8(reg, *data);
+  return reg;
+}
+
+#endif
+
+/**
+ * @brief Run a function on each index in [0, count), spread over threads that take the next index as they finish
+ */
+template<typename F>
+void
+parallel_for_each_index(size_t count, size_t n_threads, F f)
+{
+  if (n_threads == 0)
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  n_threads = std::min(n_threads, count);
+  if (n_threads <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      f(i);
+    return;
+  }
+
+  std::atomic<size_t> next{ 0 };
+  auto work = [&]() {
+    for (;;) {
+      auto i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= count)
+        return;
+      f(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < n_threads; ++i)
+    threads.emplace_back(work);
+  work();
+  for (auto& thread : threads)
+    thread.join();
+}
+
+inline void
+check_checksum_version(const FragmentChecksum& checksum)
+{
+  if (checksum.version != FragmentChecksum::s_fragment_checksum_version)
+    throw std::invalid_argument("Unsupported FragmentChecksum version " + std::to_string(checksum.version));
+}
+
+} // namespace detail
+
+uint32_t                                                     // NOLINT(build/unsigned)
+crc32c(const void* data, size_t size, uint32_t crc) noexcept // NOLINT(build/unsigned)
+{
+  auto bytes = static_cast<const uint8_t*>(data); // NOLINT(build/unsigned)
+#if defined(__x86_64__)
+  static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+  if (has_sse42)
+    return ~detail::crc32c_sse42(~crc, bytes, size);
+#endif
+  return ~detail::crc32c_scalar(~crc, bytes, size);
+}
+
+FragmentChecksum
+compute_checksum(const Fragment& fragment)
+{
+  FragmentChecksum checksum;
+  checksum.crc32c = crc32c(fragment.get_storage_location(), fragment.get_size());
+  checksum.element_id = fragment.get_element_id();
+  checksum.size = fragment.get_size();
+  return checksum;
+}
+
+bool
+verify(const Fragment& fragment, const FragmentChecksum& checksum)
+{
+  detail::check_checksum_version(checksum);
+  return fragment.get_size() == checksum.size &&
+         crc32c(fragment.get_storage_location(), fragment.get_size()) == checksum.crc32c;
+}
+
+std::vector<FragmentChecksum>
+compute_checksums(const TriggerRecord& record, size_t n_threads)
+{
+  auto const& fragments = record.get_fragments_ref();
+  std::vector<FragmentChecksum> checksums(fragments.size());
+  detail::parallel_for_each_index(
+    fragments.size(), n_threads, [&](size_t i) { checksums[i] = compute_checksum(*fragments[i]); });
+  return checksums;
+}
+
+std::vector<size_t>
+verify(const TriggerRecord& record, const std::vector<FragmentChecksum>& checksums, size_t n_threads)
+{
+  auto const& fragments = record.get_fragments_ref();
+  if (checksums.size() != fragments.size())
+    throw std::length_error("Got " + std::to_string(checksums.size()) + " checksums for " +
+                            std::to_string(fragments.size()) + " Fragments");
+  for (auto const& checksum : checksums)
+    detail::check_checksum_version(checksum);
+
+  // One flag per Fragment rather than a shared list, so that the threads do not need to synchronize
+  std::vector<char> failed(fragments.size(), 0);
+  detail::parallel_for_each_index(
+    fragments.size(), n_threads, [&](size_t i) { failed[i] = !verify(*fragments[i], checksums[i]); });
+
+  std::vector<size_t> failures;
+  for (size_t i = 0; i < failed.size(); ++i)
+    if (failed[i])
+      failures.push_back(i);
+  return failures;
+}
+
+} // namespace dunedaq::daqdataformats
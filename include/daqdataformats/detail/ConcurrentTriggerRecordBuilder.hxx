@@ -0,0 +1,84 @@
+
+namespace dunedaq::daqdataformats {
+
+ConcurrentTriggerRecordBuilder::ConcurrentTriggerRecordBuilder(TriggerRecordHeader&& header)
+  : m_header(std::move(header))
+  , m_next_same_source(m_header.get_num_requested_components(), m_header.get_num_requested_components())
+  , m_slots(m_header.get_num_requested_components())
+  , m_num_missing(m_header.get_num_requested_components())
+{
+  auto num_slots = m_slots.size();
+  std::vector<SourceID> source_ids;
+  source_ids.reserve(num_slots);
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    source_ids.push_back(m_header.at(slot).component);
+    m_slots[slot].store(nullptr, std::memory_order_relaxed);
+  }
+  m_slot_index.build(num_slots, [&](size_t slot) { return source_ids[slot].packed_key(); });
+
+  // Chain the slots of each SourceID requested more than once, in request order
+  std::vector<size_t> last_same_source(num_slots);
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    auto first = m_slot_index.find(source_ids[slot]);
+    if (first != slot)
+      m_next_same_source[last_same_source[first]] = slot;
+    last_same_source[first] = slot;
+  }
+}
+
+ConcurrentTriggerRecordBuilder::~ConcurrentTriggerRecordBuilder()
+{
+  for (auto& slot : m_slots) {
+    auto fragment = slot.load(std::memory_order_acquire);
+    if (fragment != closed_slot_())
+      delete fragment;
+  }
+}
+
+ConcurrentTriggerRecordBuilder::AddResult
+ConcurrentTriggerRecordBuilder::add_fragment(std::unique_ptr<Fragment>&& fragment)
+{
+  auto num_slots = m_slots.size();
+  auto slot = m_slot_index.find(fragment->get_element_id());
+  if (slot == SourceIDIndex::s_not_found)
+    return AddResult::kUnknownSourceID;
+
+  for (; slot < num_slots; slot = m_next_same_source[slot]) {
+    Fragment* expected = nullptr;
+    // Release, so that the thread which finalizes sees the contents of the Fragment
+    if (m_slots[slot].compare_exchange_strong(
+          expected, fragment.get(), std::memory_order_release, std::memory_order_relaxed)) {
+      fragment.release();
+      return m_num_missing.fetch_sub(1, std::memory_order_acq_rel) == 1 ? AddResult::kCompleted : AddResult::kAdded;
+    }
+    if (expected == closed_slot_())
+      return AddResult::kFinalized;
+  }
+  return AddResult::kDuplicate;
+}
+
+TriggerRecord
+ConcurrentTriggerRecordBuilder::finalize()
+{
+  if (m_finalized.exchange(true, std::memory_order_acq_rel))
+    throw std::logic_error("ConcurrentTriggerRecordBuilder::finalize was already called");
+
+  // Closing each slot with an exchange settles any race with add_fragment: the Fragment is either taken here or
+  // refused there
+  std::vector<std::unique_ptr<Fragment>> fragments;
+  fragments.reserve(m_slots.size());
+  for (auto& slot : m_slots) {
+    auto fragment = slot.exchange(closed_slot_(), std::memory_order_acquire);
+    if (fragment != nullptr)
+      fragments.emplace_back(fragment);
+  }
+
+  auto incomplete = fragments.size() < m_slots.size();
+  TriggerRecord record(TriggerRecord::s_adopt_header, std::move(m_header));
+  record.set_fragments(std::move(fragments));
+  if (incomplete)
+    record.get_header_ref().set_error_bit(TriggerRecordErrorBits::kIncomplete, true);
+  return record;
+}
+
+} // namespace dunedaq::daqdataformats
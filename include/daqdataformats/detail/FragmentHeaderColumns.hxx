@@ -0,0 +1,189 @@
+
+namespace dunedaq::daqdataformats {
+
+namespace detail {
+
+// The reductions keep four independent accumulators, so that consecutive iterations do not depend on each other and
+// the compiler can keep them in vector lanes
+
+/**
+ * @brief Reduce an array with a binary operation, four elements per iteration
+ */
+template<typename T, typename Op>
+inline T
+reduce_column(const T* values, size_t count, T init, Op op)
+{
+  T acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    acc0 = op(acc0, values[i]);
+    acc1 = op(acc1, values[i + 1]);
+    acc2 = op(acc2, values[i + 2]);
+    acc3 = op(acc3, values[i + 3]);
+  }
+  for (; i < count; ++i)
+    acc0 = op(acc0, values[i]);
+  return op(op(acc0, acc1), op(acc2, acc3));
+}
+
+/**
+ * @brief Sum a function of each element of an array, four elements per iteration
+ */
+template<typename T, typename F>
+inline uint64_t // NOLINT(build/unsigned)
+sum_column(const T* values, size_t count, F f)
+{
+  uint64_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0; // NOLINT(build/unsigned)
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    acc0 += f(values[i]);
+    acc1 += f(values[i + 1]);
+    acc2 += f(values[i + 2]);
+    acc3 += f(values[i + 3]);
+  }
+  for (; i < count; ++i)
+    acc0 += f(values[i]);
+  return acc0 + acc1 + acc2 + acc3;
+}
+
+template<typename T>
+inline T
+load_field(const uint8_t* header, size_t offset) // NOLINT(build/unsigned)
+{
+  T value;
+  std::memcpy(&value, header + offset, sizeof(T));
+  return value;
+}
+
+} // namespace detail
+
+FragmentHeaderColumns
+FragmentHeaderColumns::from_buffer(const void* buffer, size_t size)
+{
+  auto data = static_cast<const uint8_t*>(buffer); // NOLINT(build/unsigned)
+  FragmentHeaderColumns columns;
+  size_t offset = 0;
+  while (offset < size) {
+    auto remaining = size - offset;
+    if (remaining < sizeof(FragmentHeader))
+      throw std::length_error("Truncated FragmentHeader at offset " + std::to_string(offset));
+    auto header = data + offset;
+    if (detail::load_field<uint32_t>(header, offsetof(FragmentHeader, fragment_header_marker)) != // NOLINT
+        FragmentHeader::s_fragment_header_marker)
+      throw std::invalid_argument("Invalid FragmentHeader marker at offset " + std::to_string(offset));
+    auto fragment_size = detail::load_field<fragment_size_t>(header, offsetof(FragmentHeader, size));
+    if (fragment_size < sizeof(FragmentHeader))
+      throw std::invalid_argument("Invalid Fragment size at offset " + std::to_string(offset));
+    if (fragment_size > remaining)
+      throw std::length_error("Truncated Fragment at offset " + std::to_string(offset));
+    columns.append(header);
+    offset += fragment_size;
+  }
+  return columns;
+}
+
+void
+FragmentHeaderColumns::append(const void* header)
+{
+  auto bytes = static_cast<const uint8_t*>(header); // NOLINT(build/unsigned)
+  m_size.push_back(detail::load_field<fragment_size_t>(bytes, offsetof(FragmentHeader, size)));
+  m_window_begin.push_back(detail::load_field<timestamp_t>(bytes, offsetof(FragmentHeader, window_begin)));
+  m_window_end.push_back(detail::load_field<timestamp_t>(bytes, offsetof(FragmentHeader, window_end)));
+  m_error_bits.push_back(detail::load_field<uint32_t>(bytes, offsetof(FragmentHeader, error_bits))); // NOLINT
+  m_fragment_type.push_back(detail::load_field<fragment_type_t>(bytes, offsetof(FragmentHeader, fragment_type)));
+  m_element_id.push_back(detail::load_field<SourceID>(bytes, offsetof(FragmentHeader, element_id)));
+}
+
+void
+FragmentHeaderColumns::reserve(size_t count)
+{
+  m_size.reserve(count);
+  m_window_begin.reserve(count);
+  m_window_end.reserve(count);
+  m_error_bits.reserve(count);
+  m_fragment_type.reserve(count);
+  m_element_id.reserve(count);
+}
+
+void
+FragmentHeaderColumns::clear()
+{
+  m_size.clear();
+  m_window_begin.clear();
+  m_window_end.clear();
+  m_error_bits.clear();
+  m_fragment_type.clear();
+  m_element_id.clear();
+}
+
+timestamp_t
+FragmentHeaderColumns::min_window_begin() const
+{
+  return detail::reduce_column(m_window_begin.data(),
+                               m_window_begin.size(),
+                               TypeDefaults::s_invalid_timestamp,
+                               [](timestamp_t a, timestamp_t b) { return b < a ? b : a; });
+}
+
+timestamp_t
+FragmentHeaderColumns::max_window_end() const
+{
+  return detail::reduce_column(m_window_end.data(),
+                               m_window_end.size(),
+                               timestamp_t(0),
+                               [](timestamp_t a, timestamp_t b) { return a < b ? b : a; });
+}
+
+uint64_t // NOLINT(build/unsigned)
+FragmentHeaderColumns::total_size() const
+{
+  return detail::sum_column(m_size.data(), m_size.size(), [](fragment_size_t size) { return size; });
+}
+
+uint32_t // NOLINT(build/unsigned)
+FragmentHeaderColumns::error_bits_or() const
+{
+  return detail::reduce_column(m_error_bits.data(),
+                               m_error_bits.size(),
+                               uint32_t(0),                                // NOLINT(build/unsigned)
+                               [](uint32_t a, uint32_t b) { return a | b; }); // NOLINT(build/unsigned)
+}
+
+uint64_t // NOLINT(build/unsigned)
+FragmentHeaderColumns::error_bits_popcount() const
+{
+  return detail::sum_column(
+    m_error_bits.data(), m_error_bits.size(), [](uint32_t bits) { return __builtin_popcount(bits); }); // NOLINT
+}
+
+size_t
+FragmentHeaderColumns::count_with_errors() const
+{
+  return detail::sum_column(
+    m_error_bits.data(), m_error_bits.size(), [](uint32_t bits) { return bits != 0 ? 1 : 0; }); // NOLINT
+}
+
+std::array<size_t, 32>
+FragmentHeaderColumns::error_bit_counts() const
+{
+  std::array<size_t, 32> counts{};
+  // Only the bits that are set somewhere need a pass over the column
+  auto any = error_bits_or();
+  while (any != 0) {
+    auto bit = __builtin_ctz(any);
+    counts[bit] = detail::sum_column(
+      m_error_bits.data(), m_error_bits.size(), [bit](uint32_t bits) { return (bits >> bit) & 1; }); // NOLINT
+    any &= any - 1;
+  }
+  return counts;
+}
+
+size_t
+FragmentHeaderColumns::count_of_type(FragmentType type) const
+{
+  auto code = static_cast<fragment_type_t>(type);
+  return detail::sum_column(
+    m_fragment_type.data(), m_fragment_type.size(), [code](fragment_type_t value) { return value == code ? 1 : 0; });
+}
+
+} // namespace dunedaq::daqdataformats
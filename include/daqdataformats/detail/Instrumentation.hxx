@@ -0,0 +1,205 @@
+
+namespace dunedaq::daqdataformats::instrumentation {
+
+namespace detail {
+
+/**
+ * @brief Counter written only by its owning thread, so that an update is a relaxed load and store rather than an
+ * atomic read-modify-write, while other threads can still read it
+ */
+class ThreadCounter
+{
+public:
+  void add(uint64_t amount) // NOLINT(build/unsigned)
+  {
+    m_value.store(m_value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+  uint64_t get() const { return m_value.load(std::memory_order_relaxed); } // NOLINT(build/unsigned)
+
+private:
+  std::atomic<uint64_t> m_value{ 0 }; // NOLINT(build/unsigned)
+};
+
+struct ThreadCounterSet
+{
+  ThreadCounter allocations;
+  ThreadCounter frees;
+  ThreadCounter bytes_allocated;
+  ThreadCounter bytes_freed;
+  ThreadCounter bytes_copied;
+
+  void add_to(Counters& counters) const
+  {
+    counters.allocations += allocations.get();
+    counters.frees += frees.get();
+    counters.bytes_allocated += bytes_allocated.get();
+    counters.bytes_freed += bytes_freed.get();
+    counters.bytes_copied += bytes_copied.get();
+  }
+};
+
+struct ThreadCounters
+{
+  std::array<ThreadCounterSet, s_num_instrumented_classes> by_class;
+  std::array<ThreadCounterSet, s_num_fragment_types> by_fragment_type;
+
+  void add_to(Snapshot& snapshot) const
+  {
+    for (size_t i = 0; i < by_class.size(); ++i)
+      by_class[i].add_to(snapshot.by_class[i]);
+    for (size_t i = 0; i < by_fragment_type.size(); ++i)
+      by_fragment_type[i].add_to(snapshot.by_fragment_type[i]);
+  }
+};
+
+/**
+ * @brief The ThreadCounters of the running threads, and the sum of those of the threads that have exited
+ */
+class CounterRegistry
+{
+public:
+  static CounterRegistry& instance()
+  {
+    // Never destroyed, as threads may exit after static destruction has started
+    static auto registry = new CounterRegistry();
+    return *registry;
+  }
+
+  void add(const ThreadCounters* counters)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_live.push_back(counters);
+  }
+
+  void remove(const ThreadCounters* counters)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    counters->add_to(m_retired);
+    m_live.erase(std::find(m_live.begin(), m_live.end(), counters));
+  }
+
+  Snapshot snapshot()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Snapshot result = m_retired;
+    for (auto counters : m_live)
+      counters->add_to(result);
+    return result;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::vector<const ThreadCounters*> m_live;
+  Snapshot m_retired;
+};
+
+struct RegisteredThreadCounters
+{
+  RegisteredThreadCounters() { CounterRegistry::instance().add(&counters); }
+  ~RegisteredThreadCounters() { CounterRegistry::instance().remove(&counters); }
+
+  ThreadCounters counters;
+};
+
+inline ThreadCounters&
+thread_counters()
+{
+  static thread_local RegisteredThreadCounters registered;
+  return registered.counters;
+}
+
+inline ThreadCounterSet&
+fragment_type_counters(ThreadCounters& counters, fragment_type_t fragment_type)
+{
+  return counters.by_fragment_type[fragment_type < s_num_fragment_types ? fragment_type : 0];
+}
+
+} // namespace detail
+
+Snapshot
+snapshot()
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  return detail::CounterRegistry::instance().snapshot();
+#else
+  return Snapshot();
+#endif
+}
+
+void
+record_allocation([[maybe_unused]] InstrumentedClass instrumented_class, [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  auto& counters = detail::thread_counters().by_class[static_cast<size_t>(instrumented_class)];
+  counters.allocations.add(1);
+  counters.bytes_allocated.add(bytes);
+#endif
+}
+
+void
+record_free([[maybe_unused]] InstrumentedClass instrumented_class, [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  auto& counters = detail::thread_counters().by_class[static_cast<size_t>(instrumented_class)];
+  counters.frees.add(1);
+  counters.bytes_freed.add(bytes);
+#endif
+}
+
+void
+record_copy([[maybe_unused]] InstrumentedClass instrumented_class, [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  detail::thread_counters().by_class[static_cast<size_t>(instrumented_class)].bytes_copied.add(bytes);
+#endif
+}
+
+void
+record_fragment_allocation([[maybe_unused]] fragment_type_t fragment_type, [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  record_allocation(InstrumentedClass::kFragment, bytes);
+  auto& counters = detail::fragment_type_counters(detail::thread_counters(), fragment_type);
+  counters.allocations.add(1);
+  counters.bytes_allocated.add(bytes);
+#endif
+}
+
+void
+record_fragment_free([[maybe_unused]] fragment_type_t fragment_type, [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  record_free(InstrumentedClass::kFragment, bytes);
+  auto& counters = detail::fragment_type_counters(detail::thread_counters(), fragment_type);
+  counters.frees.add(1);
+  counters.bytes_freed.add(bytes);
+#endif
+}
+
+void
+record_fragment_copy([[maybe_unused]] fragment_type_t fragment_type, [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  record_copy(InstrumentedClass::kFragment, bytes);
+  detail::fragment_type_counters(detail::thread_counters(), fragment_type).bytes_copied.add(bytes);
+#endif
+}
+
+void
+record_fragment_type_change([[maybe_unused]] fragment_type_t old_type,
+                            [[maybe_unused]] fragment_type_t new_type,
+                            [[maybe_unused]] size_t bytes)
+{
+#if DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+  // The old type's counters go down through unsigned wrap-around, which cancels out when the threads are summed
+  auto& thread = detail::thread_counters();
+  auto& old_counters = detail::fragment_type_counters(thread, old_type);
+  old_counters.allocations.add(~uint64_t(0));             // NOLINT(build/unsigned)
+  old_counters.bytes_allocated.add(uint64_t(0) - bytes);  // NOLINT(build/unsigned)
+  auto& new_counters = detail::fragment_type_counters(thread, new_type);
+  new_counters.allocations.add(1);
+  new_counters.bytes_allocated.add(bytes);
+#endif
+}
+
+} // namespace dunedaq::daqdataformats::instrumentation
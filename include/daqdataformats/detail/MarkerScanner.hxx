@@ -0,0 +1,219 @@
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace dunedaq::daqdataformats {
+
+namespace detail {
+
+/**
+ * @brief Whether a 32-bit word is one of the header marker words
+ */
+inline bool
+is_marker_word(uint32_t word) // NOLINT(build/unsigned)
+{
+  return word == FragmentHeader::s_fragment_header_marker ||
+         word == TriggerRecordHeaderData::s_trigger_record_header_magic ||
+         word == TimeSliceHeader::s_timeslice_header_marker;
+}
+
+/**
+ * @brief Read a possibly unaligned 32-bit word
+ */
+inline uint32_t // NOLINT(build/unsigned)
+load_word(const uint8_t* data) // NOLINT(build/unsigned)
+{
+  uint32_t word; // NOLINT(build/unsigned)
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/**
+ * @brief Scalar search for a marker word, one byte offset at a time
+ */
+inline size_t
+find_marker_scalar(const uint8_t* data, size_t size, size_t from) // NOLINT(build/unsigned)
+{
+  for (size_t i = from; i + sizeof(uint32_t) <= size; ++i) // NOLINT(build/unsigned)
+    if (is_marker_word(load_word(data + i)))
+      return i;
+  return size;
+}
+
+#if defined(__x86_64__)
+
+// The marker words are stored little-endian, so their first and last bytes are 0x22/0x11, 0x44/0x33 and 0x66/0x55.
+// The vector loops compare these two bytes at every offset of a block at once, and candidates are confirmed with a
+// full 32-bit comparison.
+
+/**
+ * @brief SSE2 search for a marker word, 16 byte offsets at a time
+ */
+inline size_t
+find_marker_sse2(const uint8_t* data, size_t size, size_t from) // NOLINT(build/unsigned)
+{
+  const __m128i first_fragment = _mm_set1_epi8(0x22);
+  const __m128i last_fragment = _mm_set1_epi8(0x11);
+  const __m128i first_record = _mm_set1_epi8(0x44);
+  const __m128i last_record = _mm_set1_epi8(0x33);
+  const __m128i first_slice = _mm_set1_epi8(0x66);
+  const __m128i last_slice = _mm_set1_epi8(0x55);
+
+  size_t i = from;
+  for (; i + 16 + 3 <= size; i += 16) {
+    __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));    // NOLINT
+    __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 3)); // NOLINT
+    __m128i hits = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(first, first_fragment), _mm_cmpeq_epi8(last, last_fragment)),
+                   _mm_and_si128(_mm_cmpeq_epi8(first, first_record), _mm_cmpeq_epi8(last, last_record))),
+      _mm_and_si128(_mm_cmpeq_epi8(first, first_slice), _mm_cmpeq_epi8(last, last_slice)));
+    auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits)); // NOLINT(build/unsigned)
+    while (mask != 0) {
+      size_t offset = i + __builtin_ctz(mask);
+      if (is_marker_word(load_word(data + offset)))
+        return offset;
+      mask &= mask - 1;
+    }
+  }
+  return find_marker_scalar(data, size, i);
+}
+
+/**
+ * @brief AVX2 search for a marker word, 32 byte offsets at a time
+ */
+__attribute__((target("avx2"))) inline size_t
+find_marker_avx2(const uint8_t* data, size_t size, size_t from) // NOLINT(build/unsigned)
+{
+  const __m256i first_fragment = _mm256_set1_epi8(0x22);
+  const __m256i last_fragment = _mm256_set1_epi8(0x11);
+  const __m256i first_record = _mm256_set1_epi8(0x44);
+  const __m256i last_record = _mm256_set1_epi8(0x33);
+  const __m256i first_slice = _mm256_set1_epi8(0x66);
+  const __m256i last_slice = _mm256_set1_epi8(0x55);
+
+  size_t i = from;
+  for (; i + 32 + 3 <= size; i += 32) {
+    __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));    // NOLINT
+    __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 3)); // NOLINT
+    __m256i hits = _mm256_or_si256(
+      _mm256_or_si256(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, first_fragment), _mm256_cmpeq_epi8(last, last_fragment)),
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, first_record), _mm256_cmpeq_epi8(last, last_record))),
+      _mm256_and_si256(_mm256_cmpeq_epi8(first, first_slice), _mm256_cmpeq_epi8(last, last_slice)));
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits)); // NOLINT(build/unsigned)
+    while (mask != 0) {
+      size_t offset = i + __builtin_ctz(mask);
+      if (is_marker_word(load_word(data + offset)))
+        return offset;
+      mask &= mask - 1;
+    }
+  }
+  return find_marker_sse2(data, size, i);
+}
+
+#endif
+
+/**
+ * @brief Search for a marker word with the widest vector instructions supported by the CPU
+ */
+inline size_t
+find_marker(const uint8_t* data, size_t size, size_t from) // NOLINT(build/unsigned)
+{
+#if defined(__x86_64__)
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2 ? find_marker_avx2(data, size, from) : find_marker_sse2(data, size, from);
+#else
+  return find_marker_scalar(data, size, from);
+#endif
+}
+
+} // namespace detail
+
+size_t
+MarkerScanner::find_candidate(const void* buffer, size_t size, size_t from)
+{
+  return detail::find_marker(static_cast<const uint8_t*>(buffer), size, from); // NOLINT(build/unsigned)
+}
+
+bool
+MarkerScanner::next(RecordBoundary& boundary)
+{
+  while (true) {
+    auto offset = detail::find_marker(m_data, m_size, m_position);
+    if (offset == m_size) {
+      m_position = m_size;
+      return false;
+    }
+
+    if (!validate_(offset, boundary)) {
+      ++m_num_rejected_candidates;
+      m_position = offset + 1;
+      continue;
+    }
+
+    // Skip the payload of complete records; resume right after the marker of truncated ones, as their size may be
+    // the corrupted part
+    m_position = offset + (boundary.complete ? boundary.size : sizeof(uint32_t)); // NOLINT(build/unsigned)
+    return true;
+  }
+}
+
+std::vector<RecordBoundary>
+MarkerScanner::scan_all()
+{
+  std::vector<RecordBoundary> boundaries;
+  RecordBoundary boundary;
+  while (next(boundary))
+    boundaries.push_back(boundary);
+  return boundaries;
+}
+
+bool
+MarkerScanner::validate_(size_t offset, RecordBoundary& boundary) const
+{
+  auto remaining = m_size - offset;
+  auto marker = detail::load_word(m_data + offset);
+  boundary.offset = offset;
+
+  if (marker == FragmentHeader::s_fragment_header_marker) {
+    if (remaining < offsetof(FragmentHeader, size) + sizeof(fragment_size_t))
+      return false;
+    fragment_size_t size;
+    std::memcpy(&size, m_data + offset + offsetof(FragmentHeader, size), sizeof(size));
+    if (detail::load_word(m_data + offset + offsetof(FragmentHeader, version)) !=
+          FragmentHeader::s_fragment_header_version ||
+        size < sizeof(FragmentHeader) || size > m_max_record_size)
+      return false;
+    boundary.type = RecordBoundary::Type::kFragment;
+    boundary.size = size;
+  } else if (marker == TriggerRecordHeaderData::s_trigger_record_header_magic) {
+    if (remaining < offsetof(TriggerRecordHeaderData, num_requested_components) + sizeof(uint64_t)) // NOLINT
+      return false;
+    uint64_t num_components; // NOLINT(build/unsigned)
+    std::memcpy(&num_components,
+                m_data + offset + offsetof(TriggerRecordHeaderData, num_requested_components),
+                sizeof(num_components));
+    if (detail::load_word(m_data + offset + offsetof(TriggerRecordHeaderData, version)) !=
+          TriggerRecordHeaderData::s_trigger_record_header_version ||
+        m_max_record_size < sizeof(TriggerRecordHeaderData) ||
+        num_components > (m_max_record_size - sizeof(TriggerRecordHeaderData)) / sizeof(ComponentRequest))
+      return false;
+    boundary.type = RecordBoundary::Type::kTriggerRecordHeader;
+    boundary.size = sizeof(TriggerRecordHeaderData) + num_components * sizeof(ComponentRequest);
+  } else {
+    if (remaining < offsetof(TimeSliceHeader, version) + sizeof(uint32_t) || // NOLINT(build/unsigned)
+        detail::load_word(m_data + offset + offsetof(TimeSliceHeader, version)) !=
+          TimeSliceHeader::s_timeslice_header_version)
+      return false;
+    boundary.type = RecordBoundary::Type::kTimeSliceHeader;
+    boundary.size = sizeof(TimeSliceHeader);
+  }
+
+  boundary.complete = boundary.size <= remaining;
+  return true;
+}
+
+} // namespace dunedaq::daqdataformats
@@ -0,0 +1,76 @@
+
+namespace dunedaq::daqdataformats {
+
+SharedFragment::SharedFragment(const Fragment& fragment, std::pmr::memory_resource* memory_resource)
+{
+  auto size = fragment.get_size();
+  auto array = allocate_(size, memory_resource);
+  std::memcpy(array, fragment.get_storage_location(), size);
+  instrumentation::record_fragment_allocation(fragment.get_fragment_type_code(), m_control->alloc_size);
+  instrumentation::record_fragment_copy(fragment.get_fragment_type_code(), size);
+}
+
+SharedFragment::SharedFragment(const FragmentHeader& header,
+                               const std::vector<std::pair<void*, size_t>>& pieces,
+                               std::pmr::memory_resource* memory_resource)
+{
+  size_t size = sizeof(FragmentHeader);
+  for (auto& piece : pieces) {
+    if (piece.first == nullptr)
+      throw std::invalid_argument("The Fragment buffer point to NULL.");
+    size += piece.second;
+  }
+
+  auto array = static_cast<uint8_t*>(allocate_(size, memory_resource)); // NOLINT(build/unsigned)
+  auto fragment_header = header;
+  fragment_header.size = size;
+  std::memcpy(array, &fragment_header, sizeof(fragment_header));
+  size_t offset = sizeof(FragmentHeader);
+  for (auto& piece : pieces) {
+    std::memcpy(array + offset, piece.first, piece.second);
+    offset += piece.second;
+  }
+  instrumentation::record_fragment_allocation(header.fragment_type, m_control->alloc_size);
+  instrumentation::record_fragment_copy(header.fragment_type, size);
+}
+
+void*
+SharedFragment::allocate_(size_t fragment_size, std::pmr::memory_resource* memory_resource)
+{
+  auto alloc_size = s_array_offset + fragment_size;
+  void* block = nullptr;
+  if (memory_resource != nullptr) {
+    block = memory_resource->allocate(alloc_size, alignof(std::max_align_t));
+  } else {
+    block = malloc(alloc_size); // NOLINT(build/unsigned)
+    if (block == nullptr) {
+      throw std::bad_alloc();
+    }
+  }
+
+  auto array = static_cast<char*>(block) + s_array_offset;
+  m_control = new (block) ControlBlock{ { 1 },
+                                        memory_resource,
+                                        alloc_size,
+                                        Fragment(array, Fragment::BufferAdoptionMode::kReadOnlyMode) };
+  return array;
+}
+
+void
+SharedFragment::release_() noexcept
+{
+  if (m_control == nullptr || m_control->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    return;
+
+  instrumentation::record_fragment_free(m_control->view.get_fragment_type_code(), m_control->alloc_size);
+  auto memory_resource = m_control->memory_resource;
+  auto alloc_size = m_control->alloc_size;
+  m_control->~ControlBlock();
+  if (memory_resource != nullptr) {
+    memory_resource->deallocate(m_control, alloc_size, alignof(std::max_align_t));
+  } else {
+    free(m_control);
+  }
+}
+
+} // namespace dunedaq::daqdataformats
@@ -1,4 +1,10 @@
 
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 namespace dunedaq::daqdataformats {
 
 static_assert(SourceID::s_source_id_version == 2,
@@ -33,6 +39,80 @@ operator<<(std::ostream& o, SourceID const& source_id)
   return o << "subsystem: " << source_id.subsystem << " id: " << source_id.id;
 }
 
+/**
+ * @brief Write a Subsystem into a buffer, as operator<< streams it, without allocating
+ * @param first Start of the buffer
+ * @param last End of the buffer
+ * @param type Subsystem to write
+ * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+ */
+inline std::to_chars_result
+to_chars(char* first, char* last, SourceID::Subsystem const& type) noexcept
+{
+  return CharWriter(first, last).write(SourceID::get_subsystem_name(type)).result();
+}
+
+/**
+ * @brief Write a SourceID into a buffer, as operator<< streams it, without allocating
+ * @param first Start of the buffer
+ * @param last End of the buffer
+ * @param source_id SourceID to write
+ * @return One past the last character written, or last and std::errc::value_too_large if the buffer is too small
+ */
+inline std::to_chars_result
+to_chars(char* first, char* last, SourceID const& source_id) noexcept
+{
+  return CharWriter(first, last)
+    .write("subsystem: ")
+    .write(SourceID::get_subsystem_name(source_id.subsystem))
+    .write(" id: ")
+    .write_dec(source_id.id)
+    .result();
+}
+
+/**
+ * @brief Parse a Subsystem from the text written by operator<< and to_chars, without allocating
+ * @param first Start of the text
+ * @param last End of the text
+ * @param type Subsystem to fill. It is only modified if parsing succeeds.
+ * @return One past the last character parsed, or the position of the first mismatch and std::errc::invalid_argument
+ * (or std::errc::result_out_of_range for a number too large for its field)
+ */
+inline std::from_chars_result
+from_chars(const char* first, const char* last, SourceID::Subsystem& type) noexcept
+{
+  CharReader reader(first, last);
+  std::string_view name;
+  if (!reader.read_name(name).ok())
+    return reader.result();
+  auto parsed = SourceID::find_subsystem(name);
+  if (parsed == SourceID::Subsystem::kUnknown && name != SourceID::get_subsystem_name(parsed))
+    return reader.fail(first).result();
+  type = parsed;
+  return reader.result();
+}
+
+/**
+ * @brief Parse a SourceID from the text written by operator<< and to_chars, without allocating
+ * @param first Start of the text
+ * @param last End of the text
+ * @param source_id SourceID to fill. It is only modified if parsing succeeds.
+ * @return One past the last character parsed, or the position of the first mismatch and std::errc::invalid_argument
+ * (or std::errc::result_out_of_range for a number too large for its field)
+ *
+ * As with operator>>, only the subsystem and id are read; the version is left unchanged.
+ */
+inline std::from_chars_result
+from_chars(const char* first, const char* last, SourceID& source_id) noexcept
+{
+  SourceID parsed = source_id;
+  CharReader reader(first, last);
+  reader.expect("subsystem: ").read_object(parsed.subsystem).expect(" id: ").read_dec(parsed.id);
+  if (reader.ok())
+    source_id = parsed;
+  return reader.result();
+}
+
 /**
  * @brief Read a SourceID::Subsystem from a string stream
  * @param is Stream to read from
@@ -69,52 +149,174 @@ operator>>(std::istream& is, SourceID& source_id)
 bool
 SourceID::operator<(const SourceID& other) const noexcept
 {
-  return std::tuple(subsystem, id) < std::tuple(other.subsystem, other.id);
+  return packed_key() < other.packed_key();
 }
 
 bool
 SourceID::operator!=(const SourceID& other) const noexcept
 {
-  return (*this) < other || other < (*this);
+  return packed_key() != other.packed_key();
 }
 
 bool
 SourceID::operator==(const SourceID& other) const noexcept
 {
-  return !((*this) != other);
+  return packed_key() == other.packed_key();
+}
+
+namespace detail {
+
+// In memory, a SourceID is one 64-bit word holding the version in its first two bytes, the subsystem in the next two
+// and the id in the last four. Masking out the version makes SourceIDs comparable as plain integers. The version
+// bytes are the low 16 bits of the word on little-endian hosts (including every x86_64 host the AVX2 path runs on)
+// and the high 16 bits on big-endian ones.
+static_assert(offsetof(SourceID, version) == 0 && offsetof(SourceID, subsystem) == 2 && offsetof(SourceID, id) == 4,
+              "SourceID batch matching depends on the SourceID layout");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__,
+              "SourceID batch matching supports little- and big-endian hosts only");
+constexpr uint64_t s_source_id_word_mask = // NOLINT(build/unsigned)
+  __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? 0xFFFFFFFFFFFF0000ULL : 0x0000FFFFFFFFFFFFULL;
+
+/**
+ * @brief Get the in-memory word of a SourceID without its version
+ */
+inline uint64_t // NOLINT(build/unsigned)
+source_id_word(const SourceID& source_id)
+{
+  uint64_t word; // NOLINT(build/unsigned)
+  std::memcpy(&word, &source_id, sizeof(word));
+  return word & s_source_id_word_mask;
+}
+
+/**
+ * @brief Scalar search for a SourceID
+ */
+inline size_t
+find_match_scalar(const SourceID& source_id, const SourceID* source_ids, size_t from, size_t count)
+{
+  auto needle = source_id_word(source_id);
+  for (size_t i = from; i < count; ++i)
+    if (source_id_word(source_ids[i]) == needle)
+      return i;
+  return count;
+}
+
+#if defined(__x86_64__)
+/**
+ * @brief AVX2 search for a SourceID, eight at a time (two 256-bit vectors of four)
+ */
+__attribute__((target("avx2"))) inline size_t
+find_match_avx2(const SourceID& source_id, const SourceID* source_ids, size_t count)
+{
+  const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(s_source_id_word_mask)); // NOLINT(runtime/int)
+  const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(source_id_word(source_id))); // NOLINT(runtime/int)
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source_ids + i));      // NOLINT
+    __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source_ids + i + 4)); // NOLINT
+    __m256i first_hits = _mm256_cmpeq_epi64(_mm256_and_si256(first, mask), needle);
+    __m256i second_hits = _mm256_cmpeq_epi64(_mm256_and_si256(second, mask), needle);
+    auto hits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(first_hits))) |
+                static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(second_hits))) << 4;
+    if (hits != 0)
+      return i + __builtin_ctz(hits);
+  }
+  return find_match_scalar(source_id, source_ids, i, count);
+}
+#endif
+
+} // namespace detail
+
+size_t
+find_match(SourceID const& source_id, const SourceID* source_ids, size_t count)
+{
+#if defined(__x86_64__)
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2)
+    return detail::find_match_avx2(source_id, source_ids, count);
+#endif
+  return detail::find_match_scalar(source_id, source_ids, 0, count);
+}
+
+bool
+match_any(SourceID const& source_id, const SourceID* source_ids, size_t count)
+{
+  return find_match(source_id, source_ids, count) != count;
+}
+
+namespace detail {
+
+/**
+ * @brief Names of the SourceID Subsystems, indexed by value
+ */
+inline constexpr NameTable<SourceID::Subsystem, 5> s_subsystem_names{ {
+  "Unknown",
+  "Detector_Readout",
+  "HW_Signals_Interface",
+  "Trigger",
+  "TR_Builder",
+} };
+
+static_assert(s_subsystem_names.get_name(SourceID::Subsystem::kTRBuilder) == "TR_Builder",
+              "s_subsystem_names must list every Subsystem, in value order");
+
+} // namespace detail
+
+constexpr std::string_view
+SourceID::get_subsystem_name(Subsystem type) noexcept
+{
+  auto name = detail::s_subsystem_names.get_name(type);
+  return name.empty() ? detail::s_subsystem_names.get_name(Subsystem::kUnknown) : name;
+}
+
+constexpr SourceID::Subsystem
+SourceID::find_subsystem(std::string_view name) noexcept
+{
+  return detail::s_subsystem_names.find(name).value_or(Subsystem::kUnknown);
+}
+
+std::to_chars_result
+SourceID::to_string_chars(char* first, char* last) const noexcept
+{
+  return CharWriter(first, last)
+    .write(get_subsystem_name(subsystem))
+    .write("_0x")
+    .write_hex(id, 2 * sizeof(id))
+    .result();
 }
 
 std::string
 SourceID::subsystem_to_string(const Subsystem& type)
 {
-  switch (type) {
-    case Subsystem::kUnknown:
-      return "Unknown";
-    case Subsystem::kDetectorReadout:
-      return "Detector_Readout";
-    case Subsystem::kHwSignalsInterface:
-      return "HW_Signals_Interface";
-    case Subsystem::kTrigger:
-      return "Trigger";
-    case Subsystem::kTRBuilder:
-      return "TR_Builder";
-  }
-  return "Unknown";
+  return std::string(get_subsystem_name(type));
 }
 
 SourceID::Subsystem
 SourceID::string_to_subsystem(const std::string& typestring)
 {
-  if (typestring == "Detector_Readout")
-    return Subsystem::kDetectorReadout;
-  if (typestring == "HW_Signals_Interface")
-    return Subsystem::kHwSignalsInterface;
-  if (typestring == "Trigger")
-    return Subsystem::kTrigger;
-  if (typestring == "TR_Builder")
-    return Subsystem::kTRBuilder;
-
-  return Subsystem::kUnknown;
+  return find_subsystem(typestring);
 }
 
 } // namespace dunedaq::daqdataformats
+
+/**
+ * @brief Hash for SourceID, so that it can be used as key of unordered containers
+ *
+ * Consistent with SourceID::operator==: the version is not hashed.
+ */
+namespace std {
+
+template<>
+struct hash<dunedaq::daqdataformats::SourceID>
+{
+  size_t operator()(const dunedaq::daqdataformats::SourceID& source_id) const noexcept
+  {
+    // Multiplicative hashing, folding the high bits back so that the low bits used by std::unordered_map buckets
+    // depend on both subsystem and id
+    auto hash = source_id.packed_key() * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+  }
+};
+
+} // namespace std
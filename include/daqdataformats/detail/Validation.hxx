@@ -0,0 +1,273 @@
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace dunedaq::daqdataformats {
+
+ValidationResult
+validate(const FragmentHeader& header, size_t buffer_size)
+{
+  ValidationResult result;
+  result[static_cast<size_t>(ValidationFailure::kBadMarker)] =
+    header.fragment_header_marker != FragmentHeader::s_fragment_header_marker;
+  result[static_cast<size_t>(ValidationFailure::kBadVersion)] =
+    header.version != FragmentHeader::s_fragment_header_version;
+  result[static_cast<size_t>(ValidationFailure::kSizeTooSmall)] = header.size < sizeof(FragmentHeader);
+  result[static_cast<size_t>(ValidationFailure::kSizeExceedsBuffer)] = header.size > buffer_size;
+  result[static_cast<size_t>(ValidationFailure::kReversedWindow)] = header.window_begin > header.window_end;
+  return result;
+}
+
+ValidationResult
+validate(const TriggerRecordHeaderData& header, size_t buffer_size)
+{
+  ValidationResult result;
+  result[static_cast<size_t>(ValidationFailure::kBadMarker)] =
+    header.trigger_record_header_marker != TriggerRecordHeaderData::s_trigger_record_header_magic;
+  result[static_cast<size_t>(ValidationFailure::kBadVersion)] =
+    header.version != TriggerRecordHeaderData::s_trigger_record_header_version;
+  // Written as a division, so that a corrupted count cannot overflow the size computation
+  result[static_cast<size_t>(ValidationFailure::kSizeExceedsBuffer)] =
+    buffer_size < sizeof(TriggerRecordHeaderData) ||
+    (buffer_size != s_unknown_buffer_size &&
+     header.num_requested_components > (buffer_size - sizeof(TriggerRecordHeaderData)) / sizeof(ComponentRequest));
+  return result;
+}
+
+ValidationResult
+validate(const TimeSliceHeader& header)
+{
+  ValidationResult result;
+  result[static_cast<size_t>(ValidationFailure::kBadMarker)] =
+    header.timeslice_header_marker != TimeSliceHeader::s_timeslice_header_marker;
+  result[static_cast<size_t>(ValidationFailure::kBadVersion)] =
+    header.version != TimeSliceHeader::s_timeslice_header_version;
+  return result;
+}
+
+ValidationResult
+validate(const ComponentRequest& request)
+{
+  ValidationResult result = validate(request.component);
+  result[static_cast<size_t>(ValidationFailure::kBadVersion)] =
+    result[static_cast<size_t>(ValidationFailure::kBadVersion)] ||
+    request.version != ComponentRequest::s_component_request_version;
+  result[static_cast<size_t>(ValidationFailure::kReversedWindow)] = request.window_begin > request.window_end;
+  return result;
+}
+
+ValidationResult
+validate(const SourceID& source_id)
+{
+  ValidationResult result;
+  result[static_cast<size_t>(ValidationFailure::kBadVersion)] = source_id.version != SourceID::s_source_id_version;
+  return result;
+}
+
+template<typename T>
+ValidationResult
+validate_buffer(const void* buffer, size_t size)
+{
+  static_assert(std::is_same_v<T, FragmentHeader> || std::is_same_v<T, TriggerRecordHeaderData> ||
+                  std::is_same_v<T, TimeSliceHeader>,
+                "validate_buffer supports FragmentHeader, TriggerRecordHeaderData and TimeSliceHeader");
+  ValidationResult result;
+  if (size < sizeof(T)) {
+    result.set(static_cast<size_t>(ValidationFailure::kTruncated));
+    return result;
+  }
+
+  T header;
+  std::memcpy(&header, buffer, sizeof(header));
+  if constexpr (std::is_same_v<T, TimeSliceHeader>) {
+    result = validate(header);
+  } else {
+    result = validate(header, size);
+  }
+
+  if constexpr (std::is_same_v<T, TriggerRecordHeaderData>) {
+    if (result.none()) {
+      auto components = static_cast<const char*>(buffer) + sizeof(header);
+      for (uint64_t i = 0; i < header.num_requested_components; ++i) { // NOLINT(build/unsigned)
+        ComponentRequest request;
+        std::memcpy(&request, components + i * sizeof(request), sizeof(request));
+        if (validate(request).any()) {
+          result.set(static_cast<size_t>(ValidationFailure::kBadComponent));
+          break;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+bool
+ValidationBitmap::none() const
+{
+  for (auto word : m_words)
+    if (word != 0)
+      return false;
+  return true;
+}
+
+size_t
+ValidationBitmap::count() const
+{
+  size_t count = 0;
+  for (auto word : m_words)
+    count += static_cast<size_t>(__builtin_popcountll(word));
+  return count;
+}
+
+std::vector<size_t>
+ValidationBitmap::failures() const
+{
+  std::vector<size_t> failures;
+  for (size_t w = 0; w < m_words.size(); ++w)
+    for (auto word = m_words[w]; word != 0; word &= word - 1)
+      failures.push_back(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+  return failures;
+}
+
+namespace detail {
+
+/**
+ * @brief Scalar batch validation of FragmentHeaders, from index first on
+ */
+inline void
+validate_fragments_scalar(const void* const* headers, size_t first, size_t count, uint64_t* words) // NOLINT
+{
+  for (size_t i = first; i < count; ++i) {
+    FragmentHeader header;
+    std::memcpy(&header, headers[i], sizeof(header));
+    if (validate(header).any())
+      words[i / 64] |= uint64_t(1) << (i % 64); // NOLINT(build/unsigned)
+  }
+}
+
+#if defined(__x86_64__)
+
+/**
+ * @brief Load the [window_begin, window_end] of two headers into the two halves of a vector
+ */
+__attribute__((target("avx2"))) inline __m256i
+load_windows(const void* first, const void* second)
+{
+  auto window = [](const void* header) {
+    return reinterpret_cast<const __m128i*>( // NOLINT
+      static_cast<const char*>(header) + offsetof(FragmentHeader, window_begin));
+  };
+  return _mm256_inserti128_si256(
+    _mm256_castsi128_si256(_mm_loadu_si128(window(first))), _mm_loadu_si128(window(second)), 1);
+}
+
+/**
+ * @brief AVX2 batch validation of FragmentHeaders, four at a time
+ *
+ * Each header is read with one 32-byte load of the words from the marker to the size, and one 16-byte load of the
+ * readout window. The four headers are then transposed into one vector per field. This is a software gather: it is
+ * about twice as fast as the AVX2 gather instruction, which is microcoded on some CPUs, or as the scalar loop.
+ *
+ * The marker and version are checked as one 64-bit word. AVX2 only has signed 64-bit comparisons, so the unsigned
+ * size and window comparisons flip the sign bits of both operands first.
+ */
+__attribute__((target("avx2"))) inline void
+validate_fragments_avx2(const void* const* headers, size_t count, uint64_t* words) // NOLINT(build/unsigned)
+{
+  static_assert(offsetof(FragmentHeader, fragment_header_marker) == 0 && offsetof(FragmentHeader, version) == 4 &&
+                  offsetof(FragmentHeader, size) == 8,
+                "The AVX2 validation reads the marker, version and size as the first two words of a 32-byte load");
+  static_assert(offsetof(FragmentHeader, window_end) == offsetof(FragmentHeader, window_begin) + 8,
+                "The AVX2 validation reads the readout window with one 16-byte load");
+  const __m256i marker_and_version = _mm256_set1_epi64x(static_cast<long long>( // NOLINT(runtime/int)
+    uint64_t(FragmentHeader::s_fragment_header_version) << 32 | FragmentHeader::s_fragment_header_marker)); // NOLINT
+  const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min()); // NOLINT(runtime/int)
+  const __m256i min_size = _mm256_xor_si256(_mm256_set1_epi64x(sizeof(FragmentHeader)), sign);
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    // [marker and version, size, trigger_number, trigger_timestamp] of each header
+    __m256i a = _mm256_loadu_si256(static_cast<const __m256i*>(headers[i]));
+    __m256i b = _mm256_loadu_si256(static_cast<const __m256i*>(headers[i + 1]));
+    __m256i c = _mm256_loadu_si256(static_cast<const __m256i*>(headers[i + 2]));
+    __m256i d = _mm256_loadu_si256(static_cast<const __m256i*>(headers[i + 3]));
+    // [window_begin, window_end] of headers 0 and 2, and of headers 1 and 3
+    __m256i windows_ac = load_windows(headers[i], headers[i + 2]);
+    __m256i windows_bd = load_windows(headers[i + 1], headers[i + 3]);
+
+    __m256i marker_and_versions =
+      _mm256_permute2x128_si256(_mm256_unpacklo_epi64(a, b), _mm256_unpacklo_epi64(c, d), 0x20);
+    __m256i sizes = _mm256_permute2x128_si256(_mm256_unpackhi_epi64(a, b), _mm256_unpackhi_epi64(c, d), 0x20);
+    __m256i begins = _mm256_unpacklo_epi64(windows_ac, windows_bd);
+    __m256i ends = _mm256_unpackhi_epi64(windows_ac, windows_bd);
+
+    // A matching marker and version compare to all ones; flipping the sign bit turns that into a failure flag
+    __m256i failed = _mm256_xor_si256(_mm256_cmpeq_epi64(marker_and_versions, marker_and_version), sign);
+    failed = _mm256_or_si256(failed, _mm256_cmpgt_epi64(min_size, _mm256_xor_si256(sizes, sign)));
+    failed = _mm256_or_si256(failed, _mm256_cmpgt_epi64(_mm256_xor_si256(begins, sign), _mm256_xor_si256(ends, sign)));
+    auto bits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(failed)));
+    // i is a multiple of 4, so the four bits never straddle two words
+    words[i / 64] |= uint64_t(bits) << (i % 64); // NOLINT(build/unsigned)
+  }
+  validate_fragments_scalar(headers, i, count, words);
+}
+
+#endif
+
+/**
+ * @brief Set the bits of the failing headers in a zeroed bitmap, with the fastest implementation the CPU supports
+ */
+inline void
+validate_fragments_into(const void* const* headers, size_t count, uint64_t* words) // NOLINT(build/unsigned)
+{
+#if defined(__x86_64__)
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) {
+    validate_fragments_avx2(headers, count, words);
+    return;
+  }
+#endif
+  validate_fragments_scalar(headers, 0, count, words);
+}
+
+} // namespace detail
+
+ValidationBitmap
+validate_fragments(const void* const* headers, size_t count)
+{
+  ValidationBitmap bitmap(count);
+  detail::validate_fragments_into(headers, count, bitmap.words().data());
+  return bitmap;
+}
+
+ValidationBitmap
+validate_fragments(const std::vector<std::unique_ptr<Fragment>>& fragments)
+{
+  // Collect the header addresses a block at a time, so that the bitmap is the only allocation. The block size is a
+  // multiple of 64, so each block starts on a bitmap word.
+  constexpr size_t block_size = 256;
+  ValidationBitmap bitmap(fragments.size());
+  const void* headers[block_size];
+  for (size_t first = 0; first < fragments.size(); first += block_size) {
+    auto count = std::min(block_size, fragments.size() - first);
+    for (size_t i = 0; i < count; ++i)
+      headers[i] = fragments[first + i]->get_storage_location();
+    detail::validate_fragments_into(headers, count, bitmap.words().data() + first / 64);
+  }
+  return bitmap;
+}
+
+ValidationBitmap
+validate_fragments(const TriggerRecord& record)
+{
+  return validate_fragments(record.get_fragments_ref());
+}
+
+ValidationBitmap
+validate_fragments(const TimeSlice& slice)
+{
+  return validate_fragments(slice.get_fragments_ref());
+}
+
+} // namespace dunedaq::daqdataformats
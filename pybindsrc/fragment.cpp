@@ -8,10 +8,18 @@
 
 #include "daqdataformats/Fragment.hpp"
 #include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/TimeSlice.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
 namespace py = pybind11;
 using namespace pybind11::literals; // to bring in the `_a` literal
 
@@ -19,12 +27,83 @@ namespace dunedaq {
 namespace daqdataformats {
 namespace python {
 
+/**
+ * @brief Get the memory of a buffer-protocol object (bytes, bytearray, memoryview, NumPy array...)
+ * @throws std::invalid_argument if the buffer is not C-contiguous
+ */
+py::buffer_info
+request_contiguous_buffer(const py::buffer& buffer)
+{
+  auto info = buffer.request();
+  auto stride = info.itemsize;
+  for (auto dim = info.ndim; dim-- > 0;) {
+    if (info.shape[dim] > 1 && info.strides[dim] != stride)
+      throw std::invalid_argument("The buffer is not C-contiguous");
+    stride *= info.shape[dim];
+  }
+  return info;
+}
+
+/**
+ * @brief Refuse a daqdataformats object where a buffer holding a raw image is expected
+ * @throws py::type_error if object is a Fragment, TriggerRecordHeader, TriggerRecord or TimeSlice
+ *
+ * The buffer of a Fragment is its payload, and the other classes do not export one, so none of them can be parsed
+ * as an image.
+ */
+void
+reject_daqdataformats_object(const py::handle& object, const char* image)
+{
+  if (py::isinstance<Fragment>(object) || py::isinstance<TriggerRecordHeader>(object) ||
+      py::isinstance<TriggerRecord>(object) || py::isinstance<TimeSlice>(object)) {
+    throw py::type_error(std::string("Expected a buffer holding a complete ") + image + ", got a " +
+                         py::str(py::type::of(object).attr("__name__")).cast<std::string>() +
+                         " (a Fragment's buffer is its payload)");
+  }
+}
+
+/**
+ * @brief Get the memory of a buffer holding a complete Fragment array
+ * @throws py::type_error if the buffer is a daqdataformats object
+ * @throws std::invalid_argument if the buffer does not start with a FragmentHeader
+ * @throws std::length_error if the Fragment size in the header does not fit the buffer
+ */
+static py::buffer_info
+request_fragment_buffer(const py::buffer& buffer)
+{
+  reject_daqdataformats_object(buffer, "Fragment array");
+  auto info = request_contiguous_buffer(buffer);
+  auto size = static_cast<size_t>(info.size * info.itemsize);
+  if (size < sizeof(FragmentHeader))
+    throw std::length_error("The buffer is smaller than a FragmentHeader");
+  FragmentHeader header;
+  std::memcpy(&header, info.ptr, sizeof(header));
+  if (header.fragment_header_marker != FragmentHeader::s_fragment_header_marker)
+    throw std::invalid_argument("The buffer does not start with a FragmentHeader");
+  if (header.size < sizeof(FragmentHeader) || header.size > size)
+    throw std::length_error("The Fragment size in the header does not fit the buffer");
+  return info;
+}
+
 void
 register_fragment(py::module& m)
 {
 
   py::class_<Fragment> py_fragment(m, "Fragment", py::buffer_protocol());
 
+  // Expose the payload in place, so that memoryview(fragment) and numpy.frombuffer(fragment) do not copy it. The
+  // buffer is read-only when the Fragment does not own its data array (kReadOnlyMode). A memoryview holds a reference
+  // to the Fragment, and Fragments returned by TriggerRecord/TimeSlice.get_fragments_ref keep their owner alive.
+  py_fragment.def_buffer([](Fragment& self) -> py::buffer_info {
+    return py::buffer_info(self.get_data(),
+                           sizeof(uint8_t), // NOLINT(build/unsigned)
+                           py::format_descriptor<uint8_t>::format(), // NOLINT(build/unsigned)
+                           1,
+                           { static_cast<py::ssize_t>(self.get_data_size()) },
+                           { static_cast<py::ssize_t>(sizeof(uint8_t)) }, // NOLINT(build/unsigned)
+                           !self.owns_buffer());
+  });
+
   py_fragment.def("get_header", &Fragment::get_header, py::return_value_policy::reference_internal)
     .def("get_storage_location", &Fragment::get_storage_location, py::return_value_policy::reference_internal)
     .def("get_trigger_number", &Fragment::get_trigger_number)
@@ -41,6 +120,7 @@ register_fragment(py::module& m)
     .def("get_sequence_number", &Fragment::get_sequence_number)
     .def("get_size", &Fragment::get_size)
     .def("get_data_size", &Fragment::get_data_size)
+    .def("owns_buffer", &Fragment::owns_buffer)
     .def(
       "get_data", [](Fragment& self, size_t offset) { return static_cast<void*>(static_cast<char*>(self.get_data()) + offset); }, "offset"_a = 0, py::return_value_policy::reference_internal)
     .def(
@@ -61,6 +141,41 @@ register_fragment(py::module& m)
     .value("kCopyFromBuffer", Fragment::BufferAdoptionMode::kCopyFromBuffer)
     .export_values();
 
+  // Fragment(buffer) copies the Fragment array, so the buffer may be released or modified afterwards. Fragment.view
+  // uses the memory in place (kReadOnlyMode) and keeps the buffer alive as long as the returned Fragment.
+  // kTakeOverBuffer has no Python equivalent: Python memory cannot be released by the Fragment.
+  // The Fragment overload comes first, as a Fragment is also a buffer (its payload).
+  py_fragment
+    .def(py::init([](const Fragment& fragment) {
+           return std::make_unique<Fragment>(const_cast<void*>(fragment.get_storage_location()),
+                                             Fragment::BufferAdoptionMode::kCopyFromBuffer);
+         }),
+         "fragment"_a,
+         "Construct a copy of a Fragment")
+    .def(py::init([](py::buffer buffer) {
+           auto info = request_fragment_buffer(buffer);
+           return std::make_unique<Fragment>(info.ptr, Fragment::BufferAdoptionMode::kCopyFromBuffer);
+         }),
+         "buffer"_a,
+         "Construct a Fragment from a copy of a buffer holding a complete Fragment array")
+    .def_static(
+      "view",
+      [](py::buffer buffer) {
+        auto info = request_fragment_buffer(buffer);
+        return std::make_unique<Fragment>(info.ptr, Fragment::BufferAdoptionMode::kReadOnlyMode);
+      },
+      "buffer"_a,
+      py::keep_alive<0, 1>(),
+      "Construct a read-only Fragment over a buffer holding a complete Fragment array, without copying it")
+    .def_static(
+      "from_payload",
+      [](py::buffer payload) {
+        auto info = request_contiguous_buffer(payload);
+        return std::make_unique<Fragment>(info.ptr, static_cast<size_t>(info.size * info.itemsize));
+      },
+      "payload"_a,
+      "Construct a Fragment with a default header and a copy of the payload");
+
   py::class_<FragmentHeader>(m, "FragmentHeader")
     .def_property_readonly(
       "fragment_header_marker",
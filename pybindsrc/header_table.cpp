@@ -0,0 +1,158 @@
+/**
+ * @file header_table.cpp NumPy structured-array export of FragmentHeaders and ComponentRequests
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+#include "daqdataformats/TriggerRecordHeaderData.hpp"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace dunedaq {
+namespace daqdataformats {
+namespace python {
+
+// The dtypes reproduce the C++ layouts field by field, with explicit offsets and item sizes, so that rows can be
+// filled with a plain memcpy of each struct
+
+py::dtype
+source_id_dtype()
+{
+  return py::dtype(py::list(py::make_tuple("version", "subsystem", "id")),
+                   py::list(py::make_tuple(py::dtype::of<SourceID::Version_t>(),
+                                           py::dtype::of<SourceID::Subsystem_t>(),
+                                           py::dtype::of<SourceID::ID_t>())),
+                   py::list(py::make_tuple(
+                     offsetof(SourceID, version), offsetof(SourceID, subsystem), offsetof(SourceID, id))),
+                   sizeof(SourceID));
+}
+
+py::dtype
+fragment_header_dtype()
+{
+  return py::dtype(py::list(py::make_tuple("fragment_header_marker",
+                                           "version",
+                                           "size",
+                                           "trigger_number",
+                                           "trigger_timestamp",
+                                           "window_begin",
+                                           "window_end",
+                                           "run_number",
+                                           "error_bits",
+                                           "fragment_type",
+                                           "sequence_number",
+                                           "detector_id",
+                                           "element_id")),
+                   py::list(py::make_tuple(py::dtype::of<uint32_t>(), // NOLINT(build/unsigned)
+                                           py::dtype::of<uint32_t>(), // NOLINT(build/unsigned)
+                                           py::dtype::of<fragment_size_t>(),
+                                           py::dtype::of<trigger_number_t>(),
+                                           py::dtype::of<timestamp_t>(),
+                                           py::dtype::of<timestamp_t>(),
+                                           py::dtype::of<timestamp_t>(),
+                                           py::dtype::of<run_number_t>(),
+                                           py::dtype::of<uint32_t>(), // NOLINT(build/unsigned)
+                                           py::dtype::of<fragment_type_t>(),
+                                           py::dtype::of<sequence_number_t>(),
+                                           py::dtype::of<uint16_t>(), // NOLINT(build/unsigned)
+                                           source_id_dtype())),
+                   py::list(py::make_tuple(offsetof(FragmentHeader, fragment_header_marker),
+                                           offsetof(FragmentHeader, version),
+                                           offsetof(FragmentHeader, size),
+                                           offsetof(FragmentHeader, trigger_number),
+                                           offsetof(FragmentHeader, trigger_timestamp),
+                                           offsetof(FragmentHeader, window_begin),
+                                           offsetof(FragmentHeader, window_end),
+                                           offsetof(FragmentHeader, run_number),
+                                           offsetof(FragmentHeader, error_bits),
+                                           offsetof(FragmentHeader, fragment_type),
+                                           offsetof(FragmentHeader, sequence_number),
+                                           offsetof(FragmentHeader, detector_id),
+                                           offsetof(FragmentHeader, element_id))),
+                   sizeof(FragmentHeader));
+}
+
+py::dtype
+component_request_dtype()
+{
+  return py::dtype(
+    py::list(py::make_tuple("version", "unused", "component", "window_begin", "window_end")),
+    py::list(py::make_tuple(py::dtype::of<uint32_t>(), // NOLINT(build/unsigned)
+                            py::dtype::of<uint32_t>(), // NOLINT(build/unsigned)
+                            source_id_dtype(),
+                            py::dtype::of<timestamp_t>(),
+                            py::dtype::of<timestamp_t>())),
+    py::list(py::make_tuple(offsetof(ComponentRequest, version),
+                            offsetof(ComponentRequest, unused),
+                            offsetof(ComponentRequest, component),
+                            offsetof(ComponentRequest, window_begin),
+                            offsetof(ComponentRequest, window_end))),
+    sizeof(ComponentRequest));
+}
+
+py::array
+fragment_header_table(const std::vector<std::unique_ptr<Fragment>>& fragments)
+{
+  // The vector belongs to a Python-visible TriggerRecord or TimeSlice that another thread may modify, so it is only
+  // read while the GIL is held. The GIL is released for the copy of the headers.
+  std::vector<const void*> headers;
+  headers.reserve(fragments.size());
+  for (auto const& fragment : fragments)
+    headers.push_back(fragment->get_storage_location());
+
+  py::array table(fragment_header_dtype(), { static_cast<py::ssize_t>(headers.size()) });
+  auto row = static_cast<uint8_t*>(table.mutable_data()); // NOLINT(build/unsigned)
+  {
+    py::gil_scoped_release release;
+    for (auto header : headers) {
+      std::memcpy(row, header, sizeof(FragmentHeader));
+      row += sizeof(FragmentHeader);
+    }
+  }
+  return table;
+}
+
+py::array
+component_request_table(const TriggerRecordHeader& header)
+{
+  // As for fragment_header_table, the header is only read while the GIL is held
+  auto num_components = header.get_num_requested_components();
+  auto components = static_cast<const uint8_t*>(header.get_storage_location()) + // NOLINT(build/unsigned)
+                    sizeof(TriggerRecordHeaderData);
+
+  py::array table(component_request_dtype(), { static_cast<py::ssize_t>(num_components) });
+  auto destination = table.mutable_data();
+  if (num_components > 0) {
+    py::gil_scoped_release release;
+    std::memcpy(destination, components, num_components * sizeof(ComponentRequest));
+  }
+  return table;
+}
+
+void
+register_header_table(py::module& m)
+{
+  m.attr("source_id_dtype") = source_id_dtype();
+  m.attr("fragment_header_dtype") = fragment_header_dtype();
+  m.attr("component_request_dtype") = component_request_dtype();
+}
+
+} // namespace python
+} // namespace daqdataformats
+} // namespace dunedaq
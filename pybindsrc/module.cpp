@@ -25,6 +25,8 @@ extern void
 register_trigger_record(py::module&);
 extern void
 register_timeslice(py::module&);
+extern void
+register_header_table(py::module&);
 
 PYBIND11_MODULE(_daq_daqdataformats_py, m)
 {
@@ -36,6 +38,7 @@ PYBIND11_MODULE(_daq_daqdataformats_py, m)
   register_component_request(m);
   register_trigger_record(m);
   register_timeslice(m);
+  register_header_table(m);
 }
 
 } // namespace python
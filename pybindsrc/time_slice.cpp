@@ -9,6 +9,7 @@
 #include "daqdataformats/TimeSlice.hpp"
 #include "daqdataformats/TimeSliceHeader.hpp"
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -21,6 +22,9 @@ namespace dunedaq {
 namespace daqdataformats {
 namespace python {
 
+extern py::array
+fragment_header_table(const std::vector<std::unique_ptr<Fragment>>& fragments);
+
 void
 register_timeslice(py::module& m)
 {
@@ -52,17 +56,33 @@ register_timeslice(py::module& m)
     //    .def("set_header", &TimeSlice::set_header)
     .def(
       "get_fragments_ref",
-      [](TimeSlice& self) {
+      [](py::object py_self) {
+        // Each Fragment keeps the TimeSlice alive, so that its buffer stays valid after the list is dropped
+        auto& self = py_self.cast<TimeSlice&>();
         auto fragments = py::list();
         for (auto& fragment : self.get_fragments_ref()) {
-          auto py_fragment = py::cast(*fragment, py::return_value_policy::reference);
+          auto py_fragment = py::cast(fragment.get(), py::return_value_policy::reference_internal, py_self);
           fragments.append(py_fragment);
         }
         return fragments;
       },
       py::return_value_policy::reference_internal)
+    .def(
+      "add_fragment",
+      [](TimeSlice& self, const Fragment& fragment) {
+        // The TimeSlice gets a read-only view of the Fragment, which is kept alive as long as the TimeSlice
+        self.add_fragment(std::make_unique<Fragment>(const_cast<void*>(fragment.get_storage_location()),
+                                                     Fragment::BufferAdoptionMode::kReadOnlyMode));
+      },
+      py::arg("fragment"),
+      py::keep_alive<1, 2>(),
+      "Add a Fragment without copying its data")
     .def("get_total_size_bytes", &TimeSlice::get_total_size_bytes)
-    .def("get_sum_of_fragment_payload_sizes", &TimeSlice::get_sum_of_fragment_payload_sizes);
+    .def("get_sum_of_fragment_payload_sizes", &TimeSlice::get_sum_of_fragment_payload_sizes)
+    .def(
+      "header_table",
+      [](const TimeSlice& self) { return fragment_header_table(self.get_fragments_ref()); },
+      "Copy the FragmentHeaders into a NumPy structured array with one row per Fragment");
 } // NOLINT
 
 } // namespace python
@@ -9,10 +9,13 @@
 #include "daqdataformats/TriggerRecord.hpp"
 #include "daqdataformats/TriggerRecordHeader.hpp"
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace py = pybind11;
@@ -21,6 +24,38 @@ namespace dunedaq {
 namespace daqdataformats {
 namespace python {
 
+extern py::buffer_info
+request_contiguous_buffer(const py::buffer& buffer);
+extern void
+reject_daqdataformats_object(const py::handle& object, const char* image);
+extern py::array
+fragment_header_table(const std::vector<std::unique_ptr<Fragment>>& fragments);
+extern py::array
+component_request_table(const TriggerRecordHeader& header);
+
+/**
+ * @brief Get the memory of a buffer holding a TriggerRecordHeaderData followed by its ComponentRequests
+ * @throws py::type_error if the buffer is a daqdataformats object
+ * @throws std::invalid_argument if the buffer does not start with a TriggerRecordHeaderData
+ * @throws std::length_error if the ComponentRequests in the header do not fit the buffer
+ */
+static py::buffer_info
+request_trigger_record_header_buffer(const py::buffer& buffer)
+{
+  reject_daqdataformats_object(buffer, "TriggerRecordHeader image");
+  auto info = request_contiguous_buffer(buffer);
+  auto size = static_cast<size_t>(info.size * info.itemsize);
+  if (size < sizeof(TriggerRecordHeaderData))
+    throw std::length_error("The buffer is smaller than a TriggerRecordHeaderData");
+  TriggerRecordHeaderData header;
+  std::memcpy(&header, info.ptr, sizeof(header));
+  if (header.trigger_record_header_marker != TriggerRecordHeaderData::s_trigger_record_header_magic)
+    throw std::invalid_argument("The buffer does not start with a TriggerRecordHeaderData");
+  if (header.num_requested_components > (size - sizeof(header)) / sizeof(ComponentRequest))
+    throw std::length_error("The ComponentRequests in the header do not fit the buffer");
+  return info;
+}
+
 void
 register_trigger_record(py::module& m)
 {
@@ -29,7 +64,22 @@ register_trigger_record(py::module& m)
     .def(py::init([](py::capsule capsule, bool copy_from_buffer) {
       return std::unique_ptr<TriggerRecordHeader>(new TriggerRecordHeader(capsule.get_pointer(), copy_from_buffer));
     }))
-    .def(py::init<TriggerRecordHeader const&>())
+    .def(py::init<TriggerRecordHeader const&>()) // Before the buffer overload, which would refuse a TriggerRecordHeader
+    .def(py::init([](py::buffer buffer) {
+           auto info = request_trigger_record_header_buffer(buffer);
+           return std::make_unique<TriggerRecordHeader>(info.ptr, true);
+         }),
+         py::arg("buffer"),
+         "Construct a TriggerRecordHeader from a copy of a buffer holding a complete header image")
+    .def_static(
+      "view",
+      [](py::buffer buffer) {
+        auto info = request_trigger_record_header_buffer(buffer);
+        return std::make_unique<TriggerRecordHeader>(info.ptr, false);
+      },
+      py::arg("buffer"),
+      py::keep_alive<0, 1>(),
+      "Construct a TriggerRecordHeader over a buffer holding a complete header image, without copying it")
     .def("get_header", &TriggerRecordHeader::get_header)
     .def("get_trigger_number", &TriggerRecordHeader::get_trigger_number)
     //.def("set_trigger_number", &TriggerRecordHeader::set_trigger_number)
@@ -51,6 +101,9 @@ register_trigger_record(py::module& m)
     .def("get_total_size_bytes", &TriggerRecordHeader::get_total_size_bytes)
     .def(
       "get_storage_location", &TriggerRecordHeader::get_storage_location, py::return_value_policy::reference_internal)
+    .def("component_table",
+         &component_request_table,
+         "Copy the ComponentRequests into a NumPy structured array with one row per request")
     .def("at", &TriggerRecordHeader::at)
     .def("__getitem__", &TriggerRecordHeader::operator[], py::return_value_policy::reference_internal);
 
@@ -144,17 +197,33 @@ register_trigger_record(py::module& m)
     .def("get_header_data", &TriggerRecord::get_header_data)
     .def(
       "get_fragments_ref",
-      [](TriggerRecord& self) {
+      [](py::object py_self) {
+        // Each Fragment keeps the TriggerRecord alive, so that its buffer stays valid after the list is dropped
+        auto& self = py_self.cast<TriggerRecord&>();
         auto fragments = py::list();
         for (auto& fragment : self.get_fragments_ref()) {
-          auto py_fragment = py::cast(*fragment, py::return_value_policy::reference);
+          auto py_fragment = py::cast(fragment.get(), py::return_value_policy::reference_internal, py_self);
           fragments.append(py_fragment);
         }
         return fragments;
       },
       py::return_value_policy::reference_internal)
+    .def(
+      "add_fragment",
+      [](TriggerRecord& self, const Fragment& fragment) {
+        // The TriggerRecord gets a read-only view of the Fragment, which is kept alive as long as the TriggerRecord
+        self.add_fragment(std::make_unique<Fragment>(const_cast<void*>(fragment.get_storage_location()),
+                                                     Fragment::BufferAdoptionMode::kReadOnlyMode));
+      },
+      py::arg("fragment"),
+      py::keep_alive<1, 2>(),
+      "Add a Fragment without copying its data")
     .def("get_total_size_bytes", &TriggerRecord::get_total_size_bytes)
-    .def("get_sum_of_fragment_payload_sizes", &TriggerRecord::get_sum_of_fragment_payload_sizes);
+    .def("get_sum_of_fragment_payload_sizes", &TriggerRecord::get_sum_of_fragment_payload_sizes)
+    .def(
+      "header_table",
+      [](const TriggerRecord& self) { return fragment_header_table(self.get_fragments_ref()); },
+      "Copy the FragmentHeaders into a NumPy structured array with one row per Fragment");
 } // NOLINT
 
 } // namespace python
@@ -0,0 +1,202 @@
+/**
+ * @file BenchmarkHarness.hpp Timing and allocation-counting harness shared by the daqdataformats benchmark apps
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ *
+ * Include this file from exactly one translation unit of each benchmark executable: on glibc it replaces malloc and
+ * friends with counting wrappers, so that allocations made by both operator new and the direct malloc calls of
+ * Fragment and TriggerRecordHeader are seen.
+ */
+
+#ifndef DAQDATAFORMATS_TEST_APPS_BENCHMARKHARNESS_HPP_
+#define DAQDATAFORMATS_TEST_APPS_BENCHMARKHARNESS_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define DAQDATAFORMATS_BENCHMARK_COUNT_ALLOCATIONS 1
+#else
+#define DAQDATAFORMATS_BENCHMARK_COUNT_ALLOCATIONS 0
+#endif
+
+namespace dunedaq::daqdataformats::benchmark {
+
+namespace detail {
+// Plain thread_local with constant initialization, so that touching it from malloc does not itself allocate
+inline thread_local uint64_t t_allocation_count = 0; // NOLINT(build/unsigned)
+} // namespace detail
+
+/**
+ * @brief Whether heap allocations are counted in this build
+ */
+constexpr bool s_counts_allocations = DAQDATAFORMATS_BENCHMARK_COUNT_ALLOCATIONS;
+
+/**
+ * @brief Number of heap allocations made so far by the calling thread (always 0 if allocations are not counted)
+ */
+inline uint64_t // NOLINT(build/unsigned)
+thread_allocation_count()
+{
+  return detail::t_allocation_count;
+}
+
+/**
+ * @brief Prevent the compiler from optimizing away the computation of a value
+ */
+template<typename T>
+inline void
+do_not_optimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Runs benchmarks and prints one line per benchmark: ns/op, MB/s and allocations/op
+ *
+ * Command line: [--min-time=<seconds>] [filter]. Only benchmarks whose name contains the filter are run.
+ */
+class Harness
+{
+public:
+  static constexpr size_t s_max_iterations = size_t(1) << 30; ///< Upper bound on the calibrated iteration count
+
+  Harness(int argc, char** argv)
+  {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg(argv[i]);
+      if (arg.rfind("--min-time=", 0) == 0)
+        m_min_time = std::max(0.0, std::strtod(arg.c_str() + 11, nullptr));
+      else
+        m_filter = arg;
+    }
+  }
+
+  /**
+   * @brief Time an operation, calling it in batches of growing size until a batch takes at least the minimum time
+   * @param name Benchmark name, by convention "Operation/parameter=value/..."
+   * @param bytes_per_op Bytes processed by one call, for the MB/s column (0 to leave it empty)
+   * @param op Operation to time. It is called on the calling thread, whose allocations are counted.
+   */
+  template<typename Op>
+  void run(const std::string& name, size_t bytes_per_op, Op&& op)
+  {
+    if (!selected(name))
+      return;
+    for (size_t n_ops = 1;;) {
+      auto allocations = thread_allocation_count();
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < n_ops; ++i)
+        op();
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      allocations = thread_allocation_count() - allocations;
+      if (seconds >= m_min_time || n_ops >= s_max_iterations) {
+        record(name, seconds, n_ops, double(bytes_per_op) * n_ops, allocations);
+        return;
+      }
+      // Aim a little past the minimum time, growing by at most 10x per batch
+      double factor = seconds > 0 ? 1.4 * m_min_time / seconds : 10;
+      n_ops = std::min(s_max_iterations, std::max(n_ops + 1, size_t(n_ops * std::min(10.0, factor))));
+    }
+  }
+
+  /**
+   * @brief Report a measurement taken by the caller, e.g. across several threads
+   */
+  void record(const std::string& name, double seconds, size_t n_ops, double bytes, uint64_t allocations) // NOLINT
+  {
+    if (!m_header_printed) {
+      std::cout << std::left << std::setw(64) << "benchmark" << std::right << std::setw(12) << "ns/op" << std::setw(12)
+                << "MB/s" << std::setw(12) << "allocs/op" << std::endl;
+      m_header_printed = true;
+    }
+    std::cout << std::left << std::setw(64) << name << std::right << std::fixed << std::setw(12) << std::setprecision(1)
+              << seconds * 1e9 / n_ops << std::setw(12);
+    if (bytes > 0)
+      std::cout << bytes / seconds / 1e6;
+    else
+      std::cout << "-";
+    std::cout << std::setw(12);
+    if (s_counts_allocations)
+      std::cout << std::setprecision(2) << double(allocations) / n_ops;
+    else
+      std::cout << "n/a";
+    std::cout << std::endl;
+  }
+
+  /**
+   * @brief Whether a benchmark matches the command-line filter
+   */
+  bool selected(const std::string& name) const { return name.find(m_filter) != std::string::npos; }
+
+private:
+  double m_min_time{ 0.2 };
+  std::string m_filter;
+  bool m_header_printed{ false };
+};
+
+} // namespace dunedaq::daqdataformats::benchmark
+
+#if DAQDATAFORMATS_BENCHMARK_COUNT_ALLOCATIONS
+
+// Replace the allocation entry points of the executable, forwarding to glibc's internal implementations. operator new
+// in libstdc++ calls malloc, so it is counted as well.
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void*
+malloc(size_t size) noexcept
+{
+  ++dunedaq::daqdataformats::benchmark::detail::t_allocation_count;
+  return __libc_malloc(size);
+}
+
+void*
+calloc(size_t count, size_t size) noexcept
+{
+  ++dunedaq::daqdataformats::benchmark::detail::t_allocation_count;
+  return __libc_calloc(count, size);
+}
+
+void*
+realloc(void* pointer, size_t size) noexcept
+{
+  ++dunedaq::daqdataformats::benchmark::detail::t_allocation_count;
+  return __libc_realloc(pointer, size);
+}
+
+void*
+aligned_alloc(size_t alignment, size_t size) noexcept
+{
+  ++dunedaq::daqdataformats::benchmark::detail::t_allocation_count;
+  return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void** pointer, size_t alignment, size_t size) noexcept
+{
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+  ++dunedaq::daqdataformats::benchmark::detail::t_allocation_count;
+  *pointer = __libc_memalign(alignment, size);
+  return *pointer == nullptr ? ENOMEM : 0;
+}
+
+} // extern "C"
+
+#endif // DAQDATAFORMATS_BENCHMARK_COUNT_ALLOCATIONS
+
+#endif // DAQDATAFORMATS_TEST_APPS_BENCHMARKHARNESS_HPP_
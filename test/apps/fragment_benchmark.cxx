@@ -0,0 +1,121 @@
+/**
+ * @file fragment_benchmark.cxx Cost of the Fragment constructors and checksums, by payload size
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "BenchmarkHarness.hpp"
+
+#include "daqdataformats/Checksum.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentBufferPool.hpp"
+#include "daqdataformats/SharedFragment.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/Validation.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+using namespace dunedaq::daqdataformats::benchmark;
+
+namespace {
+
+/**
+ * @brief Representative payload sizes (small TP fragments up to multi-frame WIBEth fragments)
+ */
+const std::vector<size_t> s_payload_sizes{ 64, 1200, 28800, 115200, 1048576 };
+
+const std::vector<size_t> s_piece_counts{ 1, 4, 16 };
+
+/**
+ * @brief Fragments per TriggerRecord in the batched validation benchmarks
+ */
+const std::vector<size_t> s_record_fragment_counts{ 100, 20000 };
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  Harness harness(argc, argv);
+  FragmentBufferPool pool;
+
+  for (auto payload_size : s_payload_sizes) {
+    std::vector<char> payload(payload_size, 'x');
+    auto suffix = "/payload=" + std::to_string(payload_size);
+
+    for (auto piece_count : s_piece_counts) {
+      std::vector<std::pair<void*, size_t>> pieces;
+      for (size_t i = 0; i < piece_count; ++i) {
+        auto begin = payload_size * i / piece_count;
+        auto end = payload_size * (i + 1) / piece_count;
+        pieces.emplace_back(payload.data() + begin, end - begin);
+      }
+      harness.run("Fragment(pieces)/pieces=" + std::to_string(piece_count) + suffix, payload_size, [&]() {
+        Fragment fragment(pieces);
+        do_not_optimize(fragment.get_storage_location());
+      });
+    }
+
+    harness.run("Fragment(buffer,size,pool)" + suffix, payload_size, [&]() {
+      Fragment fragment(payload.data(), payload_size, &pool);
+      do_not_optimize(fragment.get_storage_location());
+    });
+
+    Fragment source(payload.data(), payload_size);
+    auto source_buffer = const_cast<void*>(source.get_storage_location());
+    harness.run("Fragment(kCopyFromBuffer)" + suffix, source.get_size(), [&]() {
+      Fragment fragment(source_buffer, Fragment::BufferAdoptionMode::kCopyFromBuffer);
+      do_not_optimize(fragment.get_storage_location());
+    });
+    harness.run("Fragment(kCopyFromBuffer,pool)" + suffix, source.get_size(), [&]() {
+      Fragment fragment(source_buffer, Fragment::BufferAdoptionMode::kCopyFromBuffer, &pool);
+      do_not_optimize(fragment.get_storage_location());
+    });
+    harness.run("Fragment(kReadOnlyMode)" + suffix, 0, [&]() {
+      Fragment fragment(source_buffer, Fragment::BufferAdoptionMode::kReadOnlyMode);
+      do_not_optimize(fragment.get_storage_location());
+    });
+
+    // Handing the Fragment to one more consumer: a copy of the array, or of a SharedFragment handle
+    SharedFragment shared(source);
+    harness.run("SharedFragment(copy)" + suffix, 0, [&]() {
+      SharedFragment handle(shared);
+      do_not_optimize(handle.get());
+    });
+
+    harness.run("compute_checksum" + suffix, source.get_size(), [&]() { do_not_optimize(compute_checksum(source)); });
+    auto source_bytes = static_cast<const uint8_t*>(source_buffer); // NOLINT(build/unsigned)
+    harness.run("crc32c(slicing-by-8)" + suffix, source.get_size(), [&]() {
+      do_not_optimize(dunedaq::daqdataformats::detail::crc32c_scalar(0xFFFFFFFF, source_bytes, source.get_size()));
+    });
+  }
+
+  for (auto fragment_count : s_record_fragment_counts) {
+    TriggerRecord record(std::vector<ComponentRequest>{});
+    std::vector<const void*> headers;
+    std::vector<char> payload(64, 'x');
+    for (size_t i = 0; i < fragment_count; ++i) {
+      record.add_fragment(std::make_unique<Fragment>(payload.data(), payload.size()));
+      headers.push_back(record.get_fragments_ref().back()->get_storage_location());
+    }
+    auto suffix = "/fragments=" + std::to_string(fragment_count);
+    auto header_bytes = fragment_count * sizeof(FragmentHeader);
+
+    harness.run("validate_fragments(TriggerRecord)" + suffix, header_bytes, [&]() {
+      do_not_optimize(validate_fragments(record).none());
+    });
+    std::vector<uint64_t> words((fragment_count + 63) / 64); // NOLINT(build/unsigned)
+    harness.run("validate_fragments(scalar)" + suffix, header_bytes, [&]() {
+      dunedaq::daqdataformats::detail::validate_fragments_scalar(headers.data(), 0, fragment_count, words.data());
+      do_not_optimize(words.data());
+    });
+  }
+
+  return 0;
+}
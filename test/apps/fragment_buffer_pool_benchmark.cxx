@@ -0,0 +1,107 @@
+/**
+ * @file fragment_buffer_pool_benchmark.cxx Compare Fragment construction/destruction using malloc and
+ * FragmentBufferPool under multi-threaded churn
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "BenchmarkHarness.hpp"
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentBufferPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+using namespace dunedaq::daqdataformats::benchmark;
+
+namespace {
+
+/**
+ * @brief Representative payload sizes (small TP fragments up to multi-frame WIBEth fragments)
+ */
+const std::vector<size_t> s_payload_sizes{ 64, 320, 1200, 7200, 28800, 115200 };
+
+/**
+ * @brief Each thread keeps a sliding window of live Fragments and replaces the oldest one on every iteration
+ * @param allocations Incremented by the number of heap allocations made by the threads
+ * @return Wall-clock seconds taken by all threads
+ */
+double
+run_churn(std::pmr::memory_resource* resource,
+          size_t n_threads,
+          size_t n_iterations,
+          size_t window_size,
+          std::atomic<uint64_t>& allocations) // NOLINT(build/unsigned)
+{
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t thread_index = 0; thread_index < n_threads; ++thread_index) {
+    threads.emplace_back([=, &allocations]() {
+      auto thread_allocations = thread_allocation_count();
+      std::vector<char> payload(s_payload_sizes.back(), 'x');
+      std::vector<std::unique_ptr<Fragment>> window(window_size);
+      for (size_t i = 0; i < n_iterations; ++i) {
+        auto size = s_payload_sizes[(i + thread_index) % s_payload_sizes.size()];
+        window[i % window_size] = std::make_unique<Fragment>(payload.data(), size, resource);
+      }
+      allocations += thread_allocation_count() - thread_allocations;
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Run the churn and report its time and allocations per Fragment
+ */
+void
+report_churn(Harness& harness,
+             const std::string& name,
+             std::pmr::memory_resource* resource,
+             size_t n_threads,
+             size_t n_iterations,
+             size_t window_size)
+{
+  std::atomic<uint64_t> allocations{ 0 }; // NOLINT(build/unsigned)
+  auto seconds = run_churn(resource, n_threads, n_iterations, window_size, allocations);
+  harness.record(name, seconds, n_threads * n_iterations, 0, allocations);
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t n_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+  size_t n_iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+  size_t window_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+  n_threads = std::max<size_t>(1, n_threads);
+
+  std::cout << "Fragment churn: " << n_threads << " threads x " << n_iterations << " fragments, window of "
+            << window_size << " live fragments per thread" << std::endl;
+
+  // The positional arguments above are not benchmark filters
+  Harness harness(1, argv);
+  report_churn(harness, "Fragment churn/malloc", nullptr, n_threads, n_iterations, window_size);
+
+  FragmentBufferPool pool;
+  std::atomic<uint64_t> warm_up_allocations{ 0 }; // NOLINT(build/unsigned)
+  run_churn(&pool, n_threads, window_size, window_size, warm_up_allocations); // Warm up the depot
+  report_churn(harness, "Fragment churn/FragmentBufferPool", &pool, n_threads, n_iterations, window_size);
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file name_conversion_benchmark.cxx Cost of the SourceID and FragmentType string conversions
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "BenchmarkHarness.hpp"
+
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/SourceID.hpp"
+
+#include <string>
+
+using namespace dunedaq::daqdataformats;
+using namespace dunedaq::daqdataformats::benchmark;
+
+int
+main(int argc, char** argv)
+{
+  Harness harness(argc, argv);
+
+  SourceID source_id(SourceID::Subsystem::kDetectorReadout, 0x1234);
+  harness.run("SourceID::to_string", 0, [&]() { do_not_optimize(source_id.to_string()); });
+  harness.run("SourceID::to_string_chars", 0, [&]() {
+    char buffer[64];
+    do_not_optimize(source_id.to_string_chars(buffer, buffer + sizeof(buffer)).ptr);
+  });
+  harness.run("SourceID::subsystem_to_string", 0, [&]() {
+    do_not_optimize(SourceID::subsystem_to_string(source_id.subsystem));
+  });
+  harness.run("SourceID::string_to_subsystem", 0, [&]() {
+    do_not_optimize(SourceID::string_to_subsystem("Detector_Readout"));
+  });
+
+  harness.run("get_fragment_type_names", 0, [&]() { do_not_optimize(get_fragment_type_names()); });
+  harness.run("get_fragment_type_name", 0, [&]() { do_not_optimize(get_fragment_type_name(FragmentType::kWIBEth)); });
+  harness.run("fragment_type_to_string", 0, [&]() {
+    do_not_optimize(fragment_type_to_string(FragmentType::kWIBEth));
+  });
+  std::string type_name("WIBEth");
+  harness.run("string_to_fragment_type", 0, [&]() { do_not_optimize(string_to_fragment_type(type_name)); });
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file trigger_record_builder_benchmark.cxx Compare assembling a TriggerRecord from many threads with a mutex and
+ * with ConcurrentTriggerRecordBuilder
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "BenchmarkHarness.hpp"
+
+#include "daqdataformats/ConcurrentTriggerRecordBuilder.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+using namespace dunedaq::daqdataformats::benchmark;
+
+namespace {
+
+/**
+ * @brief Number of readout links, i.e. of Fragments per TriggerRecord
+ */
+const std::vector<size_t> s_link_counts{ 100, 1000 };
+
+const std::vector<size_t> s_thread_counts{ 1, 4, 16 };
+
+/**
+ * @brief Number of TriggerRecords assembled per measurement
+ */
+constexpr size_t s_num_records = 200;
+
+/**
+ * @brief Assemble s_num_records TriggerRecords at once, with the Fragments made beforehand and added by n_threads
+ * threads, each owning every n_threads-th link and going through the records in order
+ * @param add Adds a Fragment to a record, from any thread
+ * @param allocations Incremented by the number of heap allocations made while adding the Fragments
+ * @return Seconds spent adding the Fragments
+ */
+template<typename Add>
+double
+run_assembly(size_t n_links, size_t n_threads, Add add, std::atomic<uint64_t>& allocations) // NOLINT(build/unsigned)
+{
+  std::vector<char> payload(64, 'x');
+  std::vector<std::vector<std::unique_ptr<Fragment>>> fragments(s_num_records);
+  for (auto& record_fragments : fragments)
+    for (size_t link = 0; link < n_links; ++link) {
+      record_fragments.push_back(std::make_unique<Fragment>(payload.data(), payload.size()));
+      record_fragments.back()->set_element_id(
+        SourceID(SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(link)));
+    }
+
+  std::atomic<size_t> ready{ 0 };
+  std::atomic<bool> go{ false };
+  std::vector<std::thread> threads;
+  for (size_t thread_index = 0; thread_index < n_threads; ++thread_index)
+    threads.emplace_back([&, thread_index]() {
+      ++ready;
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      auto thread_allocations = thread_allocation_count();
+      for (size_t record = 0; record < s_num_records; ++record)
+        for (size_t link = thread_index; link < n_links; link += n_threads)
+          add(record, std::move(fragments[record][link]));
+      allocations += thread_allocation_count() - thread_allocations;
+    });
+  while (ready.load() != n_threads)
+    std::this_thread::yield();
+
+  auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& thread : threads)
+    thread.join();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  Harness harness(argc, argv);
+
+  for (auto n_links : s_link_counts) {
+    std::vector<ComponentRequest> components;
+    for (size_t link = 0; link < n_links; ++link)
+      components.emplace_back(
+        SourceID(SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(link)), 0, 1);
+    TriggerRecordHeader header(components);
+
+    for (auto n_threads : s_thread_counts) {
+      auto suffix = "/links=" + std::to_string(n_links) + "/threads=" + std::to_string(n_threads);
+      auto n_ops = s_num_records * n_links;
+
+      auto name = "TriggerRecord::add_fragment(mutex)" + suffix;
+      if (harness.selected(name)) {
+        std::atomic<uint64_t> allocations{ 0 }; // NOLINT(build/unsigned)
+        std::vector<TriggerRecord> records;
+        std::vector<std::mutex> mutexes(s_num_records);
+        for (size_t record = 0; record < s_num_records; ++record)
+          records.emplace_back(header);
+        auto seconds = run_assembly(
+          n_links,
+          n_threads,
+          [&](size_t record, std::unique_ptr<Fragment>&& fragment) {
+            std::lock_guard<std::mutex> lock(mutexes[record]);
+            records[record].add_fragment(std::move(fragment));
+          },
+          allocations);
+        harness.record(name, seconds, n_ops, 0, allocations);
+      }
+
+      name = "ConcurrentTriggerRecordBuilder::add_fragment" + suffix;
+      if (harness.selected(name)) {
+        std::atomic<uint64_t> allocations{ 0 }; // NOLINT(build/unsigned)
+        std::vector<std::unique_ptr<ConcurrentTriggerRecordBuilder>> builders;
+        for (size_t record = 0; record < s_num_records; ++record)
+          builders.push_back(std::make_unique<ConcurrentTriggerRecordBuilder>(header));
+        auto seconds = run_assembly(
+          n_links,
+          n_threads,
+          [&](size_t record, std::unique_ptr<Fragment>&& fragment) {
+            builders[record]->add_fragment(std::move(fragment));
+          },
+          allocations);
+        harness.record(name, seconds, n_ops, 0, allocations);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file trigger_record_header_benchmark.cxx Cost of TriggerRecordHeader copies and ComponentRequest lookups, by
+ * component count
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "BenchmarkHarness.hpp"
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+using namespace dunedaq::daqdataformats::benchmark;
+
+namespace {
+
+const std::vector<size_t> s_component_counts{ 1, 10, 100, 1000, 10000 };
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  Harness harness(argc, argv);
+
+  for (auto component_count : s_component_counts) {
+    std::vector<ComponentRequest> components;
+    std::vector<SourceID> source_ids;
+    for (size_t i = 0; i < component_count; ++i) {
+      source_ids.emplace_back(SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(i * 7 + 3));
+      components.emplace_back(source_ids.back(), 1000 * i, 1000 * i + 500);
+    }
+    TriggerRecordHeader header(components);
+    auto suffix = "/components=" + std::to_string(component_count);
+    auto size = header.get_total_size_bytes();
+
+    harness.run("TriggerRecordHeader(copy)" + suffix, size, [&]() {
+      TriggerRecordHeader copy(header);
+      do_not_optimize(copy.get_storage_location());
+    });
+
+    TriggerRecordHeader target(components);
+    harness.run("TriggerRecordHeader::operator=" + suffix, size, [&]() {
+      target = header;
+      do_not_optimize(target.get_storage_location());
+    });
+
+    // Visit the SourceIDs with a prime stride, so that consecutive lookups are not neighbours
+    size_t next = 0;
+    header.get_component_for_source_id(source_ids.front()); // Build the index outside of the timed loop
+    harness.run("TriggerRecordHeader::get_component_for_source_id" + suffix, 0, [&]() {
+      do_not_optimize(header.get_component_for_source_id(source_ids[next]));
+      next = (next + 7919) % component_count;
+    });
+  }
+
+  return 0;
+}
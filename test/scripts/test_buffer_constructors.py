@@ -0,0 +1,123 @@
+"""
+Exercise the Python buffer constructors of Fragment and TriggerRecordHeader.
+
+Run with `pytest test/scripts` once the daqdataformats Python bindings are built.
+"""
+
+import struct
+
+import pytest
+
+daqdataformats = pytest.importorskip("daqdataformats")
+
+# FragmentHeader v5: marker, version, size, trigger_number, trigger_timestamp, window_begin, window_end,
+# run_number, error_bits, fragment_type, sequence_number, detector_id, element_id (version, subsystem, id)
+FRAGMENT_HEADER = struct.Struct("<IIQQQQQIIIHHHHI")
+# TriggerRecordHeaderData v4: marker, version, trigger_number, trigger_timestamp, num_requested_components,
+# run_number, error_bits, trigger_type, sequence_number, max_sequence_number, unused, element_id
+TRIGGER_RECORD_HEADER = struct.Struct("<IIQQQIIQHHIHHI")
+
+PAYLOAD = bytes(range(100))
+
+
+def fragment_image(payload=PAYLOAD):
+    size = FRAGMENT_HEADER.size + len(payload)
+    header = FRAGMENT_HEADER.pack(0x11112222, 5, size, 7, 1000, 900, 1100, 3, 0, 0, 0, 0, 2, 1, 42)
+    return header + payload
+
+
+def trigger_record_header_image():
+    return TRIGGER_RECORD_HEADER.pack(0x33334444, 4, 7, 1000, 0, 3, 0, 1, 0, 0, 0xFFFFFFFF, 2, 4, 0)
+
+
+def test_layouts_match_the_bindings():
+    assert FRAGMENT_HEADER.size == daqdataformats.FragmentHeader.sizeof()
+    assert TRIGGER_RECORD_HEADER.size == 64
+
+
+def test_fragment_copies_the_buffer():
+    image = bytearray(fragment_image())
+    fragment = daqdataformats.Fragment(image)
+    image[FRAGMENT_HEADER.size] ^= 0xFF
+    assert fragment.owns_buffer()
+    assert fragment.get_size() == len(image)
+    assert fragment.get_trigger_number() == 7
+    assert fragment.get_element_id().id == 42
+    assert fragment.get_data_bytes() == PAYLOAD
+
+
+def test_fragment_view_uses_the_buffer_in_place():
+    image = bytearray(fragment_image())
+    fragment = daqdataformats.Fragment.view(image)
+    del image
+    assert not fragment.owns_buffer()
+    assert fragment.get_trigger_number() == 7
+    assert fragment.get_data_bytes() == PAYLOAD
+    assert memoryview(fragment).readonly
+
+
+def test_fragment_from_payload():
+    fragment = daqdataformats.Fragment.from_payload(PAYLOAD)
+    assert fragment.owns_buffer()
+    assert fragment.get_data_size() == len(PAYLOAD)
+    assert fragment.get_data_bytes() == PAYLOAD
+
+
+def test_fragment_buffer_is_not_a_payload():
+    # A complete Fragment image given to from_payload becomes the payload of a new Fragment
+    image = fragment_image()
+    assert daqdataformats.Fragment.from_payload(image).get_data_size() == len(image)
+    assert daqdataformats.Fragment(image).get_data_size() == len(PAYLOAD)
+
+
+@pytest.mark.parametrize("construct", [daqdataformats.Fragment, daqdataformats.Fragment.view])
+def test_fragment_rejects_invalid_buffers(construct):
+    with pytest.raises(ValueError):
+        construct(bytes(FRAGMENT_HEADER.size))
+    with pytest.raises(ValueError):
+        construct(fragment_image()[:-1])
+
+
+def test_trigger_record_header_copies_the_buffer():
+    image = bytearray(trigger_record_header_image())
+    header = daqdataformats.TriggerRecordHeader(image)
+    image[8] = 0
+    assert header.get_trigger_number() == 7
+    assert header.get_run_number() == 3
+    assert header.get_num_requested_components() == 0
+
+
+def test_trigger_record_header_view_uses_the_buffer_in_place():
+    image = bytearray(trigger_record_header_image())
+    header = daqdataformats.TriggerRecordHeader.view(image)
+    image[8] = 8
+    assert header.get_trigger_number() == 8
+
+
+def test_fragment_copies_a_fragment():
+    original = daqdataformats.Fragment(fragment_image())
+    copy = daqdataformats.Fragment(original)
+    assert copy.owns_buffer()
+    assert copy.get_size() == original.get_size()
+    assert copy.get_trigger_number() == 7
+    assert copy.get_data_bytes() == PAYLOAD
+
+
+def test_buffer_constructors_reject_daqdataformats_objects():
+    fragment = daqdataformats.Fragment(fragment_image())
+    header = daqdataformats.TriggerRecordHeader(trigger_record_header_image())
+    with pytest.raises(TypeError):
+        daqdataformats.Fragment.view(fragment)
+    with pytest.raises(TypeError):
+        daqdataformats.Fragment.view(header)
+    with pytest.raises(TypeError):
+        daqdataformats.TriggerRecordHeader(fragment)
+    with pytest.raises(TypeError):
+        daqdataformats.TriggerRecordHeader.view(header)
+
+
+def test_trigger_record_header_copies_a_trigger_record_header():
+    original = daqdataformats.TriggerRecordHeader(trigger_record_header_image())
+    copy = daqdataformats.TriggerRecordHeader(original)
+    assert copy.get_trigger_number() == 7
+    assert copy.get_run_number() == 3
@@ -0,0 +1,195 @@
+/**
+ * @file BinaryRecord_test.cxx Binary record encoding Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/BinaryRecord.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE BinaryRecord_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+FragmentHeader
+make_fragment_header(uint64_t trigger_number) // NOLINT(build/unsigned)
+{
+  FragmentHeader header;
+  header.size = sizeof(FragmentHeader) + 5568;
+  header.trigger_number = trigger_number;
+  header.run_number = 12345;
+  header.trigger_timestamp = 0x0123456789ABCDEFULL + 32 * trigger_number;
+  header.window_begin = header.trigger_timestamp - 1000;
+  header.window_end = header.trigger_timestamp + 2000;
+  header.error_bits = 0;
+  header.fragment_type = static_cast<fragment_type_t>(FragmentType::kWIBEth);
+  header.sequence_number = 0;
+  header.detector_id = 3;
+  header.element_id = SourceID(SourceID::Subsystem::kDetectorReadout, 100 + trigger_number % 7);
+  return header;
+}
+
+bool
+same_bytes(const FragmentHeader& lhs, const FragmentHeader& rhs)
+{
+  return std::memcmp(&lhs, &rhs, sizeof(FragmentHeader)) == 0;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(BinaryRecord_test)
+
+/**
+ * @brief Test that every field of every record type survives encoding and decoding
+ */
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  std::vector<uint8_t> buffer; // NOLINT(build/unsigned)
+
+  SourceID source_id(SourceID::Subsystem::kTrigger, std::numeric_limits<SourceID::ID_t>::max());
+  source_id.version = 7;
+  encode_binary(source_id, buffer);
+  BOOST_REQUIRE_EQUAL(buffer.size(), 1 + 1 + 1 + 5);
+  BOOST_REQUIRE_EQUAL(buffer[0], 0x11);
+  SourceID decoded_source_id;
+  BOOST_REQUIRE(decode_binary(buffer.data(), buffer.data() + buffer.size(), decoded_source_id) ==
+                buffer.data() + buffer.size());
+  BOOST_REQUIRE_EQUAL(decoded_source_id.version, 7);
+  BOOST_REQUIRE_EQUAL(decoded_source_id, source_id);
+
+  // Windows before, around and after the reference timestamps, including wrapping differences
+  for (auto window_end : { timestamp_t(0), timestamp_t(5), std::numeric_limits<timestamp_t>::max() }) {
+    ComponentRequest request(SourceID(SourceID::Subsystem::kDetectorReadout, 3), 10, window_end);
+    buffer.clear();
+    encode_binary(request, buffer);
+    ComponentRequest decoded_request;
+    decode_binary(buffer.data(), buffer.data() + buffer.size(), decoded_request);
+    BOOST_REQUIRE_EQUAL(std::memcmp(&decoded_request, &request, sizeof(ComponentRequest)), 0);
+  }
+
+  FragmentHeader default_header;
+  default_header.detector_id = 0;
+  for (auto const& header : { make_fragment_header(1), default_header }) {
+    buffer.clear();
+    encode_binary(header, buffer);
+    BOOST_REQUIRE_LE(buffer.size(), s_binary_record_max_size<FragmentHeader>);
+    FragmentHeader decoded_header;
+    decode_binary(buffer.data(), buffer.data() + buffer.size(), decoded_header);
+    BOOST_REQUIRE(same_bytes(decoded_header, header));
+  }
+
+  TriggerRecordHeaderData record_header;
+  record_header.trigger_number = 42;
+  record_header.run_number = 1;
+  record_header.trigger_timestamp = std::numeric_limits<timestamp_t>::max();
+  record_header.trigger_type = 2;
+  record_header.num_requested_components = 17;
+  record_header.sequence_number = 3;
+  record_header.max_sequence_number = 4;
+  record_header.element_id = SourceID(SourceID::Subsystem::kTRBuilder, 0);
+  buffer.clear();
+  encode_binary(record_header, buffer);
+  BOOST_REQUIRE_LE(buffer.size(), s_binary_record_max_size<TriggerRecordHeaderData>);
+  TriggerRecordHeaderData decoded_record_header;
+  decode_binary(buffer.data(), buffer.data() + buffer.size(), decoded_record_header);
+  BOOST_REQUIRE_EQUAL(std::memcmp(&decoded_record_header, &record_header, sizeof(TriggerRecordHeaderData)), 0);
+
+  TimeSliceHeader slice_header;
+  slice_header.timeslice_number = 99;
+  slice_header.run_number = 2;
+  slice_header.element_id = SourceID(SourceID::Subsystem::kHwSignalsInterface, 1);
+  buffer.clear();
+  encode_binary(slice_header, buffer);
+  TimeSliceHeader decoded_slice_header;
+  decode_binary(buffer.data(), buffer.data() + buffer.size(), decoded_slice_header);
+  BOOST_REQUIRE_EQUAL(std::memcmp(&decoded_slice_header, &slice_header, sizeof(TimeSliceHeader)), 0);
+}
+
+/**
+ * @brief Test bulk encoding and decoding, and the size of typical FragmentHeaders
+ */
+BOOST_AUTO_TEST_CASE(Bulk)
+{
+  std::vector<FragmentHeader> headers;
+  for (uint64_t i = 0; i < 1000; ++i) // NOLINT(build/unsigned)
+    headers.push_back(make_fragment_header(i));
+
+  std::vector<uint8_t> buffer{ 0xAA }; // NOLINT(build/unsigned)
+  encode_binary_all(headers.data(), headers.size(), buffer);
+  BOOST_TEST_MESSAGE("Encoded " << headers.size() << " FragmentHeaders in " << buffer.size() - 1 << " bytes");
+  BOOST_REQUIRE_EQUAL(buffer[0], 0xAA);
+  BOOST_REQUIRE_LT(buffer.size() - 1, headers.size() * sizeof(FragmentHeader) * 2 / 3);
+
+  auto decoded = decode_binary_all<FragmentHeader>(buffer.data() + 1, buffer.size() - 1);
+  BOOST_REQUIRE_EQUAL(decoded.size(), headers.size());
+  for (size_t i = 0; i < headers.size(); ++i)
+    BOOST_REQUIRE(same_bytes(decoded[i], headers[i]));
+
+  BOOST_REQUIRE(decode_binary_all<FragmentHeader>(buffer.data(), 0).empty());
+}
+
+/**
+ * @brief Test that malformed records are rejected
+ */
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  std::vector<uint8_t> buffer; // NOLINT(build/unsigned)
+  encode_binary(make_fragment_header(5), buffer);
+
+  FragmentHeader header;
+  for (size_t size = 0; size < buffer.size(); ++size)
+    BOOST_REQUIRE_THROW(decode_binary(buffer.data(), buffer.data() + size, header), std::invalid_argument);
+
+  // Wrong type, then wrong version
+  TimeSliceHeader slice_header;
+  BOOST_REQUIRE_THROW(decode_binary(buffer.data(), buffer.data() + buffer.size(), slice_header),
+                      std::invalid_argument);
+  auto bad_version = buffer;
+  bad_version[0] = 0x23;
+  BOOST_REQUIRE_THROW(decode_binary(bad_version.data(), bad_version.data() + bad_version.size(), header),
+                      std::invalid_argument);
+
+  // A SourceID version that does not fit in 16 bits
+  std::vector<uint8_t> too_large{ 0x11, 0x80, 0x80, 0x04, 0x01, 0x01 }; // NOLINT(build/unsigned)
+  SourceID source_id;
+  try {
+    decode_binary(too_large.data(), too_large.data() + too_large.size(), source_id);
+    BOOST_FAIL("Out-of-range value was accepted");
+  } catch (const std::invalid_argument& e) {
+    BOOST_REQUIRE(std::string(e.what()).find("out of range at byte 1") != std::string::npos);
+  }
+  BOOST_REQUIRE(source_id == SourceID());
+
+  // A varint longer than ten bytes
+  std::vector<uint8_t> too_long{ 0x11 }; // NOLINT(build/unsigned)
+  too_long.insert(too_long.end(), 10, 0xFF);
+  too_long.push_back(0x01);
+  BOOST_REQUIRE_THROW(decode_binary(too_long.data(), too_long.data() + too_long.size(), source_id),
+                      std::invalid_argument);
+
+  // The offset is counted from the start of the buffer in bulk decoding
+  std::vector<uint8_t> two_records; // NOLINT(build/unsigned)
+  encode_binary(SourceID(SourceID::Subsystem::kTrigger, 1), two_records);
+  encode_binary(SourceID(SourceID::Subsystem::kTrigger, 2), two_records);
+  two_records.pop_back();
+  try {
+    decode_binary_all<SourceID>(two_records.data(), two_records.size());
+    BOOST_FAIL("Truncated record was accepted");
+  } catch (const std::invalid_argument& e) {
+    BOOST_REQUIRE(std::string(e.what()).find("truncated record at byte 7") != std::string::npos);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+/**
+ * @file CharReader_test.cxx CharReader class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/CharReader.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE CharReader_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+using namespace dunedaq::daqdataformats;
+
+BOOST_AUTO_TEST_SUITE(CharReader_test)
+
+/**
+ * @brief Test reading literals, integers and names
+ */
+BOOST_AUTO_TEST_CASE(Read)
+{
+  std::string_view text = "check_word: 11112222, size: 18446744073709551615, name: HW_Signals_Interface";
+  uint32_t marker = 0;   // NOLINT(build/unsigned)
+  uint64_t size = 0;     // NOLINT(build/unsigned)
+  std::string_view name;
+
+  CharReader reader(text.data(), text.data() + text.size());
+  reader.expect("check_word: ").read_hex(marker).expect(", size: ").read_dec(size).expect(", name: ").read_name(name);
+  BOOST_REQUIRE(reader.ok());
+  BOOST_REQUIRE(reader.result().ptr == text.data() + text.size());
+  BOOST_REQUIRE_EQUAL(marker, 0x11112222);
+  BOOST_REQUIRE_EQUAL(size, 18446744073709551615ULL);
+  BOOST_REQUIRE_EQUAL(name, "HW_Signals_Interface");
+}
+
+/**
+ * @brief Test that failures report their position and are sticky
+ */
+BOOST_AUTO_TEST_CASE(Errors)
+{
+  std::string_view text = "a: 70000, b: x";
+  uint16_t a = 1; // NOLINT(build/unsigned)
+  uint16_t b = 2; // NOLINT(build/unsigned)
+
+  CharReader out_of_range(text.data(), text.data() + text.size());
+  out_of_range.expect("a: ").read_dec(a).expect(", b: ").read_dec(b);
+  BOOST_REQUIRE(out_of_range.result().ec == std::errc::result_out_of_range);
+  BOOST_REQUIRE(out_of_range.result().ptr == text.data() + 3);
+  BOOST_REQUIRE_EQUAL(b, 2);
+
+  uint32_t wide_a = 0; // NOLINT(build/unsigned)
+  CharReader not_a_number(text.data(), text.data() + text.size());
+  not_a_number.expect("a: ").read_dec(wide_a).expect(", b: ").read_dec(b);
+  BOOST_REQUIRE_EQUAL(wide_a, 70000);
+  BOOST_REQUIRE(not_a_number.result().ec == std::errc::invalid_argument);
+  BOOST_REQUIRE(not_a_number.result().ptr == text.data() + 13);
+
+  CharReader mismatch(text.data(), text.data() + text.size());
+  mismatch.expect("a: 7").expect("1");
+  BOOST_REQUIRE(mismatch.result().ec == std::errc::invalid_argument);
+  BOOST_REQUIRE(mismatch.result().ptr == text.data() + 4);
+
+  // Literals longer than the remaining text, and empty names
+  CharReader short_text(text.data(), text.data() + 2);
+  short_text.expect("a: ");
+  BOOST_REQUIRE(!short_text.ok());
+  std::string_view name;
+  CharReader empty_name(text.data() + 1, text.data() + text.size());
+  BOOST_REQUIRE(!empty_name.read_name(name).ok());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
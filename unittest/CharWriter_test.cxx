@@ -0,0 +1,75 @@
+/**
+ * @file CharWriter_test.cxx CharWriter class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/CharWriter.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE CharWriter_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+using namespace dunedaq::daqdataformats;
+
+BOOST_AUTO_TEST_SUITE(CharWriter_test)
+
+/**
+ * @brief Test that integers are written as std::ostream writes them
+ */
+BOOST_AUTO_TEST_CASE(Integers)
+{
+  char buffer[128];
+  CharWriter writer(buffer, buffer + sizeof(buffer));
+  writer.write_dec(uint16_t(0))
+    .write(" ")
+    .write_dec(std::numeric_limits<uint64_t>::max())
+    .write(" ")
+    .write_hex(uint32_t(0x11112222))
+    .write(" ")
+    .write_hex(uint32_t(0x2a), 8)
+    .write(" ")
+    .write_hex(uint64_t(0), 0);
+  auto result = writer.result();
+  BOOST_REQUIRE(result.ec == std::errc());
+
+  std::ostringstream ostr;
+  ostr << uint16_t(0) << " " << std::numeric_limits<uint64_t>::max() << " " << std::hex << uint32_t(0x11112222) << " "
+       << std::setfill('0') << std::setw(8) << uint32_t(0x2a) << " " << uint64_t(0);
+  BOOST_REQUIRE_EQUAL(std::string(buffer, result.ptr), ostr.str());
+}
+
+/**
+ * @brief Test that output that does not fit is reported like std::to_chars does
+ */
+BOOST_AUTO_TEST_CASE(Overflow)
+{
+  char buffer[8];
+  CharWriter writer(buffer, buffer + sizeof(buffer));
+  writer.write("12345");
+  BOOST_REQUIRE(writer.result().ec == std::errc());
+  BOOST_REQUIRE(writer.result().ptr == buffer + 5);
+
+  // Once a write fails, later writes that would fit are dropped too
+  writer.write_dec(uint32_t(123456)).write("6");
+  BOOST_REQUIRE(writer.result().ec == std::errc::value_too_large);
+  BOOST_REQUIRE(writer.result().ptr == buffer + sizeof(buffer));
+
+  CharWriter padded(buffer, buffer + sizeof(buffer));
+  padded.write_hex(uint64_t(1), 9);
+  BOOST_REQUIRE(padded.result().ec == std::errc::value_too_large);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/**
+ * @file Checksum_test.cxx CRC32C and FragmentChecksum Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/Checksum.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE Checksum_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+
+/**
+ * @brief Bit-at-a-time CRC32C, as a reference
+ */
+uint32_t // NOLINT(build/unsigned)
+reference_crc32c(const uint8_t* data, size_t size) // NOLINT(build/unsigned)
+{
+  uint32_t crc = 0xFFFFFFFF; // NOLINT(build/unsigned)
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+  }
+  return ~crc;
+}
+
+std::vector<uint8_t> // NOLINT(build/unsigned)
+random_bytes(size_t size, unsigned seed)
+{
+  std::mt19937 generator(seed);
+  std::vector<uint8_t> bytes(size); // NOLINT(build/unsigned)
+  for (auto& byte : bytes)
+    byte = static_cast<uint8_t>(generator()); // NOLINT(build/unsigned)
+  return bytes;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Checksum_test)
+
+/**
+ * @brief Check the standard CRC32C check value
+ */
+BOOST_AUTO_TEST_CASE(KnownValues)
+{
+  BOOST_REQUIRE_EQUAL(crc32c("123456789", 9), 0xE3069283);
+  BOOST_REQUIRE_EQUAL(crc32c(nullptr, 0), 0);
+  std::vector<uint8_t> zeros(32, 0); // NOLINT(build/unsigned)
+  BOOST_REQUIRE_EQUAL(crc32c(zeros.data(), zeros.size()), 0x8A9136AA);
+}
+
+/**
+ * @brief Check the accelerated and table implementations against a bitwise reference, across the stream thresholds
+ * and at unaligned addresses
+ */
+BOOST_AUTO_TEST_CASE(MatchesReference)
+{
+  auto bytes = random_bytes(3 * 8192 * 2 + 3 * 256 + 100, 42);
+  std::vector<size_t> sizes{ 0, 1, 7, 8, 9, 63, 64, 767, 768, 769, 1000, 24575, 24576, 24577, 50000 };
+  sizes.push_back(bytes.size() - 3);
+  for (auto size : sizes) {
+    for (size_t offset : { 0, 1, 3 }) {
+      auto expected = reference_crc32c(bytes.data() + offset, size);
+      BOOST_REQUIRE_EQUAL(crc32c(bytes.data() + offset, size), expected);
+      BOOST_REQUIRE_EQUAL(~detail::crc32c_scalar(0xFFFFFFFF, bytes.data() + offset, size), expected);
+    }
+  }
+}
+
+/**
+ * @brief Check that a CRC32C can be computed piece by piece
+ */
+BOOST_AUTO_TEST_CASE(Incremental)
+{
+  auto bytes = random_bytes(30000, 7);
+  auto whole = crc32c(bytes.data(), bytes.size());
+  for (size_t split : { 0, 1, 100, 777, 25000, 30000 })
+    BOOST_REQUIRE_EQUAL(crc32c(bytes.data() + split, bytes.size() - split, crc32c(bytes.data(), split)), whole);
+}
+
+/**
+ * @brief Check computing and verifying the checksum of a Fragment
+ */
+BOOST_AUTO_TEST_CASE(FragmentChecksums)
+{
+  auto payload = random_bytes(1000, 3);
+  Fragment fragment(payload.data(), payload.size());
+  fragment.set_element_id(SourceID(SourceID::Subsystem::kDetectorReadout, 12));
+
+  auto checksum = compute_checksum(fragment);
+  BOOST_REQUIRE_EQUAL(checksum.version, FragmentChecksum::s_fragment_checksum_version);
+  BOOST_REQUIRE_EQUAL(checksum.size, fragment.get_size());
+  BOOST_REQUIRE_EQUAL(checksum.element_id, fragment.get_element_id());
+  BOOST_REQUIRE_EQUAL(checksum.crc32c, crc32c(fragment.get_storage_location(), fragment.get_size()));
+  BOOST_REQUIRE(verify(fragment, checksum));
+
+  static_cast<uint8_t*>(fragment.get_data())[500] ^= 0x10; // NOLINT(build/unsigned)
+  BOOST_REQUIRE(!verify(fragment, checksum));
+  static_cast<uint8_t*>(fragment.get_data())[500] ^= 0x10; // NOLINT(build/unsigned)
+  fragment.set_run_number(99);
+  BOOST_REQUIRE(!verify(fragment, checksum));
+
+  checksum.version = 2;
+  BOOST_REQUIRE_THROW(verify(fragment, checksum), std::invalid_argument);
+}
+
+/**
+ * @brief Check computing and verifying the checksums of a TriggerRecord on several threads
+ */
+BOOST_AUTO_TEST_CASE(TriggerRecordChecksums)
+{
+  TriggerRecord record(std::vector<ComponentRequest>{});
+  for (size_t i = 0; i < 20; ++i) {
+    auto payload = random_bytes(100 + 997 * i, static_cast<unsigned>(i));
+    record.add_fragment(std::make_unique<Fragment>(payload.data(), payload.size()));
+  }
+
+  auto checksums = compute_checksums(record, 4);
+  BOOST_REQUIRE_EQUAL(checksums.size(), 20);
+  auto serial = compute_checksums(record);
+  for (size_t i = 0; i < checksums.size(); ++i)
+    BOOST_REQUIRE_EQUAL(checksums[i].crc32c, serial[i].crc32c);
+  BOOST_REQUIRE(verify(record, checksums, 0).empty());
+
+  static_cast<uint8_t*>(record.get_fragments_ref()[3]->get_data())[50] ^= 1; // NOLINT(build/unsigned)
+  static_cast<uint8_t*>(record.get_fragments_ref()[17]->get_data())[0] ^= 1;  // NOLINT(build/unsigned)
+  BOOST_REQUIRE(verify(record, checksums, 4) == (std::vector<size_t>{ 3, 17 }));
+
+  checksums.pop_back();
+  BOOST_REQUIRE_THROW(verify(record, checksums), std::length_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+/**
+ * @file ConcurrentTriggerRecordBuilder_test.cxx ConcurrentTriggerRecordBuilder class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/ConcurrentTriggerRecordBuilder.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE ConcurrentTriggerRecordBuilder_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+
+SourceID
+readout_link(size_t i)
+{
+  return SourceID(SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(i));
+}
+
+std::vector<ComponentRequest>
+make_components(size_t count)
+{
+  std::vector<ComponentRequest> components;
+  for (size_t i = 0; i < count; ++i)
+    components.emplace_back(readout_link(i), 100, 200);
+  return components;
+}
+
+std::unique_ptr<Fragment>
+make_fragment(SourceID const& source_id, run_number_t run_number = 0)
+{
+  std::vector<char> payload(16, 'x');
+  auto fragment = std::make_unique<Fragment>(payload.data(), payload.size());
+  fragment->set_element_id(source_id);
+  fragment->set_run_number(run_number);
+  return fragment;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ConcurrentTriggerRecordBuilder_test)
+
+/**
+ * @brief Check that Fragments are finalized in request order, whatever the order they were added in
+ */
+BOOST_AUTO_TEST_CASE(RequestOrder)
+{
+  TriggerRecordHeader header(make_components(5));
+  header.set_trigger_number(42);
+  ConcurrentTriggerRecordBuilder builder(header);
+  BOOST_REQUIRE_EQUAL(builder.get_num_slots(), 5);
+  BOOST_REQUIRE_EQUAL(builder.get_num_missing(), 5);
+
+  for (size_t i : { 3, 0, 4, 1 })
+    BOOST_REQUIRE(builder.add_fragment(make_fragment(readout_link(i))) ==
+                  ConcurrentTriggerRecordBuilder::AddResult::kAdded);
+  BOOST_REQUIRE(!builder.is_complete());
+  BOOST_REQUIRE(builder.add_fragment(make_fragment(readout_link(2))) ==
+                ConcurrentTriggerRecordBuilder::AddResult::kCompleted);
+  BOOST_REQUIRE(builder.is_complete());
+
+  auto record = builder.finalize();
+  BOOST_REQUIRE_EQUAL(record.get_header_ref().get_trigger_number(), 42);
+  BOOST_REQUIRE(!record.get_header_ref().get_error_bit(TriggerRecordErrorBits::kIncomplete));
+  BOOST_REQUIRE_EQUAL(record.get_fragments_ref().size(), 5);
+  for (size_t i = 0; i < 5; ++i)
+    BOOST_REQUIRE_EQUAL(record.get_fragments_ref()[i]->get_element_id(), readout_link(i));
+  BOOST_REQUIRE_THROW(builder.finalize(), std::logic_error);
+}
+
+/**
+ * @brief Check the Fragments that are refused, and that they are left with the caller
+ */
+BOOST_AUTO_TEST_CASE(RefusedFragments)
+{
+  ConcurrentTriggerRecordBuilder builder(TriggerRecordHeader(make_components(3)));
+
+  auto unknown = make_fragment(readout_link(7));
+  BOOST_REQUIRE(builder.add_fragment(std::move(unknown)) ==
+                ConcurrentTriggerRecordBuilder::AddResult::kUnknownSourceID);
+  BOOST_REQUIRE(unknown != nullptr);
+
+  builder.add_fragment(make_fragment(readout_link(1)));
+  auto duplicate = make_fragment(readout_link(1));
+  BOOST_REQUIRE(builder.add_fragment(std::move(duplicate)) == ConcurrentTriggerRecordBuilder::AddResult::kDuplicate);
+  BOOST_REQUIRE(duplicate != nullptr);
+
+  auto record = builder.finalize();
+  BOOST_REQUIRE(record.get_header_ref().get_error_bit(TriggerRecordErrorBits::kIncomplete));
+  BOOST_REQUIRE_EQUAL(record.get_fragments_ref().size(), 1);
+
+  auto late = make_fragment(readout_link(0));
+  BOOST_REQUIRE(builder.add_fragment(std::move(late)) == ConcurrentTriggerRecordBuilder::AddResult::kFinalized);
+  BOOST_REQUIRE(late != nullptr);
+}
+
+/**
+ * @brief Check that a SourceID requested several times fills its slots in request order
+ */
+BOOST_AUTO_TEST_CASE(RepeatedSourceID)
+{
+  std::vector<ComponentRequest> components{ ComponentRequest(readout_link(1), 0, 1),
+                                            ComponentRequest(readout_link(2), 0, 1),
+                                            ComponentRequest(readout_link(1), 2, 3) };
+  ConcurrentTriggerRecordBuilder builder(TriggerRecordHeader{ components });
+  builder.add_fragment(make_fragment(readout_link(1), 10));
+  builder.add_fragment(make_fragment(readout_link(1), 11));
+  BOOST_REQUIRE(builder.add_fragment(make_fragment(readout_link(1))) ==
+                ConcurrentTriggerRecordBuilder::AddResult::kDuplicate);
+  BOOST_REQUIRE(builder.add_fragment(make_fragment(readout_link(2), 12)) ==
+                ConcurrentTriggerRecordBuilder::AddResult::kCompleted);
+
+  auto record = builder.finalize();
+  std::vector<run_number_t> run_numbers;
+  for (auto const& fragment : record.get_fragments_ref())
+    run_numbers.push_back(fragment->get_run_number());
+  BOOST_REQUIRE(run_numbers == (std::vector<run_number_t>{ 10, 12, 11 }));
+}
+
+/**
+ * @brief Check that the builder deletes the Fragments that were not finalized
+ */
+BOOST_AUTO_TEST_CASE(Destruction)
+{
+  ConcurrentTriggerRecordBuilder builder(TriggerRecordHeader(make_components(4)));
+  builder.add_fragment(make_fragment(readout_link(0)));
+  builder.add_fragment(make_fragment(readout_link(3)));
+  BOOST_REQUIRE_EQUAL(builder.get_num_missing(), 2);
+}
+
+/**
+ * @brief Check many producers, with one link per producer and, at the same time, a finalize racing with them
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentProducers)
+{
+  const size_t num_links = 500;
+  const size_t num_threads = 8;
+
+  ConcurrentTriggerRecordBuilder builder(TriggerRecordHeader(make_components(num_links)));
+  std::atomic<size_t> completions{ 0 };
+  std::vector<std::thread> producers;
+  for (size_t t = 0; t < num_threads; ++t)
+    producers.emplace_back([&, t]() {
+      for (size_t i = t; i < num_links; i += num_threads)
+        if (builder.add_fragment(make_fragment(readout_link(i))) ==
+            ConcurrentTriggerRecordBuilder::AddResult::kCompleted)
+          ++completions;
+    });
+  for (auto& producer : producers)
+    producer.join();
+  BOOST_REQUIRE_EQUAL(completions.load(), 1);
+  auto record = builder.finalize();
+  BOOST_REQUIRE_EQUAL(record.get_fragments_ref().size(), num_links);
+  for (size_t i = 0; i < num_links; ++i)
+    BOOST_REQUIRE_EQUAL(record.get_fragments_ref()[i]->get_element_id(), readout_link(i));
+
+  // Every Fragment ends up either in the TriggerRecord or back with its producer
+  ConcurrentTriggerRecordBuilder racing(TriggerRecordHeader(make_components(num_links)));
+  std::atomic<size_t> refused{ 0 };
+  producers.clear();
+  for (size_t t = 0; t < num_threads; ++t)
+    producers.emplace_back([&, t]() {
+      for (size_t i = t; i < num_links; i += num_threads) {
+        auto fragment = make_fragment(readout_link(i));
+        // Boost.Test assertions are not thread-safe, so a refused Fragment is only counted if it is still there
+        if (racing.add_fragment(std::move(fragment)) == ConcurrentTriggerRecordBuilder::AddResult::kFinalized &&
+            fragment != nullptr)
+          ++refused;
+      }
+    });
+  std::this_thread::yield();
+  auto partial = racing.finalize();
+  for (auto& producer : producers)
+    producer.join();
+  BOOST_REQUIRE_EQUAL(partial.get_fragments_ref().size() + refused.load(), num_links);
+  BOOST_REQUIRE(std::is_sorted(
+    partial.get_fragments_ref().begin(), partial.get_fragments_ref().end(), [](auto const& a, auto const& b) {
+      return a->get_element_id() < b->get_element_id();
+    }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
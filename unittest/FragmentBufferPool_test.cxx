@@ -0,0 +1,185 @@
+/**
+ * @file FragmentBufferPool_test.cxx FragmentBufferPool class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/FragmentBufferPool.hpp"
+#include "daqdataformats/Fragment.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE FragmentBufferPool_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+BOOST_AUTO_TEST_SUITE(FragmentBufferPool_test)
+
+/**
+ * @brief Check the mapping of allocation sizes to size classes
+ */
+BOOST_AUTO_TEST_CASE(SizeClasses)
+{
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(1), 0);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(FragmentBufferPool::s_min_block_size), 0);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(FragmentBufferPool::s_min_block_size + 1), 1);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(1000), 3);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(1024), 3);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(1025), 4);
+
+  auto largest = FragmentBufferPool::block_size(FragmentBufferPool::s_num_size_classes - 1);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(largest), FragmentBufferPool::s_num_size_classes - 1);
+  BOOST_REQUIRE_EQUAL(FragmentBufferPool::size_class_for(largest + 1), FragmentBufferPool::s_num_size_classes);
+
+  for (size_t bytes = 1; bytes < 100000; bytes += 37) {
+    auto size_class = FragmentBufferPool::size_class_for(bytes);
+    BOOST_REQUIRE(FragmentBufferPool::block_size(size_class) >= bytes);
+    BOOST_REQUIRE(size_class == 0 || FragmentBufferPool::block_size(size_class - 1) < bytes);
+  }
+}
+
+/**
+ * @brief Check that freed blocks are reused by the same thread
+ */
+BOOST_AUTO_TEST_CASE(BlockReuse)
+{
+  FragmentBufferPool pool;
+
+  void* first = pool.allocate(500);
+  std::memset(first, 0xAB, 500);
+  pool.deallocate(first, 500);
+
+  // Any size in the same class gets the cached block back
+  void* second = pool.allocate(400);
+  BOOST_REQUIRE_EQUAL(first, second);
+  pool.deallocate(second, 400);
+
+  // Oversized requests bypass the pool
+  auto large = FragmentBufferPool::block_size(FragmentBufferPool::s_num_size_classes - 1) + 1;
+  void* big = pool.allocate(large);
+  BOOST_REQUIRE(big != nullptr);
+  pool.deallocate(big, large);
+}
+
+/**
+ * @brief Check that Fragments return their buffer to the pool on destruction
+ */
+BOOST_AUTO_TEST_CASE(FragmentBuffers)
+{
+  FragmentBufferPool pool;
+  std::vector<uint8_t> payload(1000, 7); // NOLINT(build/unsigned)
+
+  const void* storage = nullptr;
+  {
+    Fragment frag(payload.data(), payload.size(), &pool);
+    BOOST_REQUIRE_EQUAL(frag.get_memory_resource(), &pool);
+    BOOST_REQUIRE_EQUAL(frag.get_data_size(), payload.size());
+    BOOST_REQUIRE_EQUAL(*static_cast<uint8_t*>(frag.get_data()), 7); // NOLINT(build/unsigned)
+    storage = frag.get_storage_location();
+  }
+
+  Fragment frag(payload.data(), payload.size(), &pool);
+  BOOST_REQUIRE_EQUAL(frag.get_storage_location(), storage);
+}
+
+/**
+ * @brief Check that blocks move between thread caches and the shared depot in batches
+ */
+BOOST_AUTO_TEST_CASE(DepotExchange)
+{
+  FragmentBufferPool pool(4);
+  const size_t size_class = FragmentBufferPool::size_class_for(2000);
+  const size_t batch = pool.batch_size(size_class);
+  BOOST_REQUIRE_EQUAL(batch, 4);
+
+  std::vector<void*> blocks;
+  std::thread producer([&]() {
+    for (size_t i = 0; i < 3 * batch; ++i)
+      blocks.push_back(pool.allocate(2000));
+  });
+  producer.join();
+
+  // Deallocating from another thread drains whole batches to the depot
+  size_t depot_count_before_exit = 0;
+  std::thread consumer([&]() {
+    for (auto block : blocks)
+      pool.deallocate(block, 2000);
+    depot_count_before_exit = pool.get_depot_block_count(size_class);
+  });
+  consumer.join();
+  BOOST_REQUIRE_EQUAL(depot_count_before_exit, 2 * batch);
+
+  // The consumer's remaining cached blocks go to the depot when it exits
+  BOOST_REQUIRE_EQUAL(pool.get_depot_block_count(size_class), 3 * batch);
+
+  void* block = pool.allocate(2000);
+  BOOST_REQUIRE_EQUAL(pool.get_depot_block_count(size_class), 2 * batch);
+  pool.deallocate(block, 2000);
+
+  pool.flush_thread_cache();
+  BOOST_REQUIRE_EQUAL(pool.get_depot_block_count(size_class), 3 * batch);
+
+  pool.release();
+  BOOST_REQUIRE_EQUAL(pool.get_depot_block_count(size_class), 0);
+}
+
+/**
+ * @brief Check that the depot does not grow beyond its configured capacity
+ */
+BOOST_AUTO_TEST_CASE(DepotCapacity)
+{
+  const size_t size_class = FragmentBufferPool::size_class_for(1024);
+  FragmentBufferPool pool(2, 3 * FragmentBufferPool::block_size(size_class));
+
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < 20; ++i)
+    blocks.push_back(pool.allocate(1024));
+  for (auto block : blocks)
+    pool.deallocate(block, 1024);
+  pool.flush_thread_cache();
+
+  BOOST_REQUIRE(pool.get_depot_block_count(size_class) <= 3 + 2 * pool.batch_size(size_class));
+}
+
+/**
+ * @brief Check concurrent use of one pool from several threads
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentChurn)
+{
+  auto pool = std::make_unique<FragmentBufferPool>();
+  std::atomic<int> corrupted_fragments{ 0 };
+  std::vector<std::thread> threads;
+  for (int thread_index = 0; thread_index < 4; ++thread_index) {
+    threads.emplace_back([&pool, &corrupted_fragments, thread_index]() {
+      std::vector<uint8_t> payload(100 + 300 * thread_index, thread_index); // NOLINT(build/unsigned)
+      std::vector<std::unique_ptr<Fragment>> window;
+      for (int i = 0; i < 2000; ++i) {
+        window.emplace_back(std::make_unique<Fragment>(payload.data(), payload.size(), pool.get()));
+        if (window.size() > 16)
+          window.erase(window.begin());
+      }
+      for (auto const& frag : window)
+        if (*static_cast<uint8_t*>(frag->get_data()) != thread_index) // NOLINT(build/unsigned)
+          ++corrupted_fragments;
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  BOOST_REQUIRE_EQUAL(corrupted_fragments, 0);
+
+  // Destroying the pool with blocks in the depot must not leak or crash
+  pool.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/**
+ * @file FragmentBuilder_test.cxx FragmentBuilder class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/FragmentBuilder.hpp"
+#include "daqdataformats/FragmentBufferPool.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE FragmentBuilder_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+BOOST_AUTO_TEST_SUITE(FragmentBuilder_test)
+
+/**
+ * @brief Check that a Fragment built in place matches the one built from pieces
+ */
+BOOST_AUTO_TEST_CASE(BuildInPlace)
+{
+  std::vector<uint8_t> first_piece(100);  // NOLINT(build/unsigned)
+  std::vector<uint8_t> second_piece(200); // NOLINT(build/unsigned)
+  std::iota(first_piece.begin(), first_piece.end(), 0);
+  std::iota(second_piece.begin(), second_piece.end(), 100);
+
+  FragmentBuilder builder(first_piece.size() + second_piece.size());
+  builder.get_header().run_number = 3;
+  builder.get_header().element_id = SourceID{ SourceID::Subsystem::kDetectorReadout, 5 };
+
+  // Write in place, as a DMA or decoder would
+  void* region = builder.prepare(first_piece.size());
+  std::memcpy(region, first_piece.data(), first_piece.size());
+  builder.commit(first_piece.size());
+  builder.append(second_piece.data(), second_piece.size());
+  BOOST_REQUIRE_EQUAL(builder.get_data_size(), first_piece.size() + second_piece.size());
+
+  void* buffer = builder.get_data();
+  Fragment built = builder.finalize();
+  Fragment reference({ { first_piece.data(), first_piece.size() }, { second_piece.data(), second_piece.size() } });
+
+  BOOST_REQUIRE_EQUAL(built.get_data(), buffer);
+  BOOST_REQUIRE_EQUAL(built.get_size(), reference.get_size());
+  BOOST_REQUIRE_EQUAL(built.get_run_number(), 3);
+  BOOST_REQUIRE_EQUAL(built.get_element_id().id, 5);
+  BOOST_REQUIRE_EQUAL(built.get_header().fragment_header_marker, FragmentHeader::s_fragment_header_marker);
+  BOOST_REQUIRE_EQUAL(std::memcmp(built.get_data(), reference.get_data(), reference.get_data_size()), 0);
+}
+
+/**
+ * @brief Check that the buffer grows geometrically and keeps its contents
+ */
+BOOST_AUTO_TEST_CASE(Growth)
+{
+  FragmentBuilder builder(16);
+  BOOST_REQUIRE_EQUAL(builder.get_payload_capacity(), 16);
+  builder.get_header().trigger_number = 42;
+
+  for (uint32_t i = 0; i < 1000; ++i) // NOLINT(build/unsigned)
+    builder.append(&i, sizeof(i));
+
+  BOOST_REQUIRE(builder.get_payload_capacity() >= 1000 * sizeof(uint32_t)); // NOLINT(build/unsigned)
+  BOOST_REQUIRE(builder.get_payload_capacity() < 4 * 1000 * sizeof(uint32_t)); // NOLINT(build/unsigned)
+
+  auto fragment = builder.finalize();
+  BOOST_REQUIRE_EQUAL(fragment.get_trigger_number(), 42);
+  BOOST_REQUIRE_EQUAL(fragment.get_data_size(), 1000 * sizeof(uint32_t)); // NOLINT(build/unsigned)
+  auto values = static_cast<uint32_t*>(fragment.get_data()); // NOLINT(build/unsigned)
+  for (uint32_t i = 0; i < 1000; ++i) // NOLINT(build/unsigned)
+    BOOST_REQUIRE_EQUAL(values[i], i);
+
+  builder.reserve(10000);
+  BOOST_REQUIRE(builder.get_payload_capacity() >= 10000);
+  BOOST_REQUIRE_THROW(builder.commit(builder.get_payload_capacity() + 1), std::length_error);
+}
+
+/**
+ * @brief Check that the builder can be reused and that buffers come from the given memory_resource
+ */
+BOOST_AUTO_TEST_CASE(ReuseWithMemoryResource)
+{
+  FragmentBufferPool pool;
+  FragmentBuilder builder(100, &pool);
+
+  const void* first_storage = nullptr;
+  {
+    builder.prepare(50);
+    builder.commit(50);
+    auto fragment = builder.finalize();
+    BOOST_REQUIRE_EQUAL(fragment.get_memory_resource(), &pool);
+    BOOST_REQUIRE_EQUAL(fragment.get_size(), sizeof(FragmentHeader) + 50);
+    first_storage = fragment.get_storage_location();
+  }
+
+  // The default header is restored for the next Fragment, and the released buffer is reused
+  BOOST_REQUIRE_EQUAL(builder.get_data_size(), 0);
+  BOOST_REQUIRE_EQUAL(builder.get_header().run_number, TypeDefaults::s_invalid_run_number);
+  builder.prepare(500);
+  builder.commit(500);
+  auto fragment = builder.finalize();
+  BOOST_REQUIRE_EQUAL(fragment.get_data_size(), 500);
+  BOOST_REQUIRE(fragment.get_storage_location() != nullptr);
+  BOOST_REQUIRE(first_storage != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
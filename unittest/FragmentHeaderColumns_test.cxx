@@ -0,0 +1,163 @@
+/**
+ * @file FragmentHeaderColumns_test.cxx FragmentHeaderColumns class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/FragmentHeaderColumns.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE FragmentHeaderColumns_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+std::unique_ptr<Fragment>
+make_fragment(size_t index)
+{
+  std::vector<uint8_t> payload(1 + index % 5, 0xEE); // NOLINT(build/unsigned)
+  auto fragment = std::make_unique<Fragment>(payload.data(), payload.size());
+  fragment->set_window_begin(1000 + 3 * index);
+  fragment->set_window_end(2000 + (index * 7) % 11);
+  fragment->set_error_bits(std::bitset<32>(index % 3 == 0 ? 0 : (1u << (index % 32)) | 1u));
+  fragment->set_type(index % 2 == 0 ? FragmentType::kWIBEth : FragmentType::kDAPHNE);
+  fragment->set_element_id(SourceID(SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(index)));
+  return fragment;
+}
+
+TriggerRecord
+make_record(size_t num_fragments)
+{
+  TriggerRecord record(std::vector<ComponentRequest>{});
+  for (size_t i = 0; i < num_fragments; ++i)
+    record.add_fragment(make_fragment(i));
+  return record;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(FragmentHeaderColumns_test)
+
+/**
+ * @brief Test that the columns hold the header fields of each Fragment, in order
+ */
+BOOST_AUTO_TEST_CASE(Gather)
+{
+  auto record = make_record(10);
+  FragmentHeaderColumns columns(record);
+  BOOST_REQUIRE_EQUAL(columns.size(), 10);
+
+  for (size_t i = 0; i < columns.size(); ++i) {
+    auto header = record.get_fragments_ref()[i]->get_header();
+    BOOST_REQUIRE_EQUAL(columns.get_size()[i], header.size);
+    BOOST_REQUIRE_EQUAL(columns.get_window_begin()[i], header.window_begin);
+    BOOST_REQUIRE_EQUAL(columns.get_window_end()[i], header.window_end);
+    BOOST_REQUIRE_EQUAL(columns.get_error_bits()[i], header.error_bits);
+    BOOST_REQUIRE_EQUAL(columns.get_fragment_type()[i], header.fragment_type);
+    BOOST_REQUIRE_EQUAL(columns.get_element_id()[i], header.element_id);
+  }
+
+  TimeSlice timeslice(1, 2);
+  timeslice.add_fragment(make_fragment(4));
+  columns.append(timeslice);
+  BOOST_REQUIRE_EQUAL(columns.size(), 11);
+  BOOST_REQUIRE_EQUAL(columns.get_window_begin().back(), 1012);
+
+  columns.clear();
+  BOOST_REQUIRE(columns.empty());
+  BOOST_REQUIRE_EQUAL(columns.min_window_begin(), TypeDefaults::s_invalid_timestamp);
+  BOOST_REQUIRE_EQUAL(columns.max_window_end(), 0);
+  BOOST_REQUIRE_EQUAL(columns.total_size(), 0);
+  BOOST_REQUIRE_EQUAL(columns.error_bits_or(), 0);
+}
+
+/**
+ * @brief Test the reductions against straightforward loops, for sizes around the unrolling factor
+ */
+BOOST_AUTO_TEST_CASE(Reductions)
+{
+  for (size_t num_fragments : { 1, 3, 4, 5, 37 }) {
+    auto record = make_record(num_fragments);
+    FragmentHeaderColumns columns(record);
+
+    timestamp_t min_begin = TypeDefaults::s_invalid_timestamp;
+    timestamp_t max_end = 0;
+    uint64_t total_size = 0;  // NOLINT(build/unsigned)
+    uint32_t error_or = 0;    // NOLINT(build/unsigned)
+    uint64_t popcount = 0;    // NOLINT(build/unsigned)
+    size_t with_errors = 0;
+    size_t wibeth = 0;
+    std::array<size_t, 32> bit_counts{};
+    for (auto const& fragment : record.get_fragments_ref()) {
+      auto header = fragment->get_header();
+      min_begin = std::min(min_begin, header.window_begin);
+      max_end = std::max(max_end, header.window_end);
+      total_size += header.size;
+      error_or |= header.error_bits;
+      popcount += std::bitset<32>(header.error_bits).count();
+      with_errors += header.error_bits != 0;
+      wibeth += header.fragment_type == static_cast<fragment_type_t>(FragmentType::kWIBEth);
+      for (size_t bit = 0; bit < 32; ++bit)
+        bit_counts[bit] += (header.error_bits >> bit) & 1;
+    }
+
+    BOOST_REQUIRE_EQUAL(columns.min_window_begin(), min_begin);
+    BOOST_REQUIRE_EQUAL(columns.max_window_end(), max_end);
+    BOOST_REQUIRE_EQUAL(columns.total_size(), total_size);
+    BOOST_REQUIRE_EQUAL(columns.total_size(),
+                        record.get_total_size_bytes() - record.get_header_ref().get_total_size_bytes());
+    BOOST_REQUIRE_EQUAL(columns.error_bits_or(), error_or);
+    BOOST_REQUIRE_EQUAL(columns.error_bits_popcount(), popcount);
+    BOOST_REQUIRE_EQUAL(columns.count_with_errors(), with_errors);
+    BOOST_REQUIRE_EQUAL(columns.count_of_type(FragmentType::kWIBEth), wibeth);
+    BOOST_REQUIRE(columns.error_bit_counts() == bit_counts);
+  }
+}
+
+/**
+ * @brief Test gathering from back-to-back Fragment flat arrays, and rejecting invalid buffers
+ */
+BOOST_AUTO_TEST_CASE(FromBuffer)
+{
+  auto record = make_record(6);
+  std::vector<uint8_t> buffer(1); // Misalign the Fragments // NOLINT(build/unsigned)
+  for (auto const& fragment : record.get_fragments_ref()) {
+    auto data = static_cast<const uint8_t*>(fragment->get_storage_location()); // NOLINT(build/unsigned)
+    buffer.insert(buffer.end(), data, data + fragment->get_size());
+  }
+
+  auto columns = FragmentHeaderColumns::from_buffer(buffer.data() + 1, buffer.size() - 1);
+  FragmentHeaderColumns expected(record);
+  BOOST_REQUIRE_EQUAL(columns.size(), expected.size());
+  BOOST_REQUIRE(columns.get_window_begin() == expected.get_window_begin());
+  BOOST_REQUIRE(columns.get_size() == expected.get_size());
+  BOOST_REQUIRE(columns.get_element_id() == expected.get_element_id());
+
+  BOOST_REQUIRE(FragmentHeaderColumns::from_buffer(buffer.data(), 0).empty());
+  BOOST_REQUIRE_THROW(FragmentHeaderColumns::from_buffer(buffer.data() + 1, buffer.size() - 2), std::length_error);
+  BOOST_REQUIRE_THROW(FragmentHeaderColumns::from_buffer(buffer.data() + 1, sizeof(FragmentHeader) - 1),
+                      std::length_error);
+  BOOST_REQUIRE_THROW(FragmentHeaderColumns::from_buffer(buffer.data(), buffer.size()), std::invalid_argument);
+
+  auto bad_size = buffer;
+  fragment_size_t too_small = sizeof(FragmentHeader) - 1;
+  std::memcpy(bad_size.data() + 1 + offsetof(FragmentHeader, size), &too_small, sizeof(too_small));
+  BOOST_REQUIRE_THROW(FragmentHeaderColumns::from_buffer(bad_size.data() + 1, bad_size.size() - 1),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,7 +15,11 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <cstring>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <system_error>
 #include <vector>
 
 using namespace dunedaq::daqdataformats;
@@ -42,6 +46,26 @@ BOOST_AUTO_TEST_CASE(FragmentTypeConversion)
   BOOST_REQUIRE_EQUAL(fragment_type_to_string(static_cast<FragmentType>(-10)), "Unknown");
 }
 
+/**
+ * @brief Test the allocation-free FragmentType name conversions
+ */
+BOOST_AUTO_TEST_CASE(FragmentTypeName)
+{
+  static_assert(get_fragment_type_name(FragmentType::kFW_TriggerPrimitive) == "FW_Trigger_Primitive");
+  static_assert(find_fragment_type("DAPHNEStream") == FragmentType::kDAPHNEStream);
+
+  for (fragment_type_t code = 0; code <= static_cast<fragment_type_t>(FragmentType::kTDEEth); ++code) {
+    auto type = static_cast<FragmentType>(code);
+    auto name = get_fragment_type_name(type);
+    BOOST_REQUIRE(name != "Unknown" || type == FragmentType::kUnknown);
+    BOOST_REQUIRE(find_fragment_type(name) == type);
+  }
+
+  BOOST_REQUIRE_EQUAL(get_fragment_type_name(static_cast<FragmentType>(16)), "Unknown");
+  BOOST_REQUIRE(find_fragment_type("WIBEth2") == FragmentType::kUnknown);
+  BOOST_REQUIRE(find_fragment_type("") == FragmentType::kUnknown);
+}
+
 /**
  * @brief Test that FragmentHeader::operator<< functions as expected
  */
@@ -80,4 +104,90 @@ BOOST_AUTO_TEST_CASE(StreamOperator)
   BOOST_REQUIRE_EQUAL(header_from_stream.element_id, header.element_id);
 }
 
+/**
+ * @brief Test that to_chars writes the same text as operator<<
+ */
+BOOST_AUTO_TEST_CASE(ToChars)
+{
+  FragmentHeader header;
+  header.size = 0xFFFFFFFFFFFFFFFFULL;
+  header.trigger_number = 1;
+  header.run_number = 0xFFFFFFFF;
+  header.trigger_timestamp = 1234567890123ULL;
+  header.window_begin = 0;
+  header.window_end = 10;
+  header.error_bits = 0x80000001;
+  header.fragment_type = static_cast<fragment_type_t>(FragmentType::kWIBEth);
+  header.sequence_number = 65535;
+  header.detector_id = 3;
+  header.element_id = SourceID(SourceID::Subsystem::kDetectorReadout, 0xFFFFFFFF);
+
+  std::ostringstream ostr;
+  ostr << header;
+  std::string expected = ostr.str();
+
+  char buffer[s_to_chars_max_size];
+  auto result = to_chars(buffer, buffer + sizeof(buffer), header);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE_EQUAL(std::string(buffer, result.ptr), expected);
+
+  // Exactly enough room, then one byte short
+  result = to_chars(buffer, buffer + expected.size(), header);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE(result.ptr == buffer + expected.size());
+  result = to_chars(buffer, buffer + expected.size() - 1, header);
+  BOOST_REQUIRE(result.ec == std::errc::value_too_large);
+  BOOST_REQUIRE(result.ptr == buffer + expected.size() - 1);
+}
+
+/**
+ * @brief Test that from_chars parses the text written by to_chars, and reports where invalid text starts
+ */
+BOOST_AUTO_TEST_CASE(FromChars)
+{
+  FragmentHeader header;
+  header.size = 1234;
+  header.trigger_number = 0xFFFFFFFFFFFFFFFFULL;
+  header.run_number = 7;
+  header.trigger_timestamp = 1234567890123ULL;
+  header.window_begin = 1;
+  header.window_end = 2;
+  header.error_bits = 0x80000001;
+  header.fragment_type = static_cast<fragment_type_t>(FragmentType::kCRT);
+  header.sequence_number = 65535;
+  header.detector_id = 3;
+  header.element_id = SourceID(SourceID::Subsystem::kDetectorReadout, 0xFFFFFFFF);
+
+  char buffer[s_to_chars_max_size];
+  auto end = to_chars(buffer, buffer + sizeof(buffer), header).ptr;
+
+  FragmentHeader parsed;
+  auto result = from_chars(buffer, end, parsed);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE(result.ptr == end);
+  BOOST_REQUIRE_EQUAL(std::memcmp(&parsed, &header, sizeof(FragmentHeader)), 0);
+
+  // Every prefix that stops before the last number is rejected, leaving the output untouched
+  FragmentHeader untouched;
+  FragmentHeader original = untouched;
+  auto last_number = end;
+  while (last_number[-1] >= '0' && last_number[-1] <= '9')
+    --last_number;
+  for (auto last = buffer; last < last_number; ++last)
+    BOOST_REQUIRE(from_chars(buffer, last, untouched).ec != std::errc());
+  BOOST_REQUIRE_EQUAL(std::memcmp(&untouched, &original, sizeof(FragmentHeader)), 0);
+
+  std::string text(buffer, end);
+  auto position = text.find("sequence_number: 65535") + 17;
+  text[position] = '7'; // 75535 does not fit in sequence_number_t
+  result = from_chars(text.data(), text.data() + text.size(), parsed);
+  BOOST_REQUIRE(result.ec == std::errc::result_out_of_range);
+  BOOST_REQUIRE(result.ptr == text.data() + position);
+
+  text = "check_word: 11112222, version: 5, sizes: 1";
+  result = from_chars(text.data(), text.data() + text.size(), parsed);
+  BOOST_REQUIRE(result.ec == std::errc::invalid_argument);
+  BOOST_REQUIRE(result.ptr == text.data() + text.find("sizes"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,12 +26,41 @@
 #include "boost/test/unit_test.hpp"
 
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <utility>
 #include <vector>
 
 using namespace dunedaq::daqdataformats;
 
+namespace {
+/**
+ * @brief memory_resource which counts the allocations and deallocations it serves
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  size_t allocations{ 0 };
+  size_t deallocations{ 0 };
+  size_t bytes_outstanding{ 0 };
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    ++allocations;
+    bytes_outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override
+  {
+    ++deallocations;
+    bytes_outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+} // namespace
+
 BOOST_AUTO_TEST_SUITE(Fragment_test)
 
 /**
@@ -107,6 +136,7 @@ BOOST_AUTO_TEST_CASE(ExistingFragmentConstructor)
     Fragment test_frag(frag, Fragment::BufferAdoptionMode::kReadOnlyMode);
 
     BOOST_REQUIRE_EQUAL(test_frag.get_storage_location(), frag);
+    BOOST_REQUIRE(!test_frag.owns_buffer());
 
     BOOST_REQUIRE_EQUAL(test_frag.get_trigger_number(), 1);
     BOOST_REQUIRE_EQUAL(test_frag.get_trigger_timestamp(), 2);
@@ -130,6 +160,7 @@ BOOST_AUTO_TEST_CASE(ExistingFragmentConstructor)
     Fragment test_frag(frag, Fragment::BufferAdoptionMode::kCopyFromBuffer);
 
     BOOST_REQUIRE(test_frag.get_storage_location() != frag);
+    BOOST_REQUIRE(test_frag.owns_buffer());
     BOOST_REQUIRE_EQUAL(test_frag.get_trigger_number(), 1);
     BOOST_REQUIRE_EQUAL(test_frag.get_trigger_timestamp(), 2);
     BOOST_REQUIRE_EQUAL(test_frag.get_run_number(), 3);
@@ -207,6 +238,72 @@ BOOST_AUTO_TEST_CASE(MoveAssignment)
   BOOST_REQUIRE_EQUAL(another_frag.get_size(), sizeof(FragmentHeader) + 10);
 }
 
+/**
+ * @brief Check that Fragments allocate from, and return their buffer to, a user-supplied memory_resource
+ */
+BOOST_AUTO_TEST_CASE(MemoryResource)
+{
+  CountingResource resource;
+  std::vector<uint8_t> buf1(10); // NOLINT(build/unsigned)
+  buf1[3] = 42;
+
+  {
+    Fragment frag(buf1.data(), buf1.size(), &resource);
+    BOOST_REQUIRE_EQUAL(frag.get_memory_resource(), &resource);
+    BOOST_REQUIRE_EQUAL(frag.get_size(), sizeof(FragmentHeader) + buf1.size());
+    BOOST_REQUIRE_EQUAL(*(static_cast<uint8_t*>(frag.get_data()) + 3), 42); // NOLINT(build/unsigned)
+    BOOST_REQUIRE_EQUAL(resource.allocations, 1);
+    BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, frag.get_size());
+
+    Fragment copy_frag(const_cast<void*>(frag.get_storage_location()), // NOLINT
+                       Fragment::BufferAdoptionMode::kCopyFromBuffer,
+                       &resource);
+    BOOST_REQUIRE_EQUAL(resource.allocations, 2);
+    BOOST_REQUIRE_EQUAL(copy_frag.get_size(), frag.get_size());
+
+    Fragment moved_frag(std::move(copy_frag));
+    BOOST_REQUIRE_EQUAL(moved_frag.get_memory_resource(), &resource);
+  }
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 2);
+  BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, 0);
+
+  {
+    Fragment source_frag(buf1.data(), buf1.size());
+    BOOST_REQUIRE(source_frag.get_memory_resource() == nullptr);
+
+    auto size = source_frag.get_size();
+    void* buffer = resource.allocate(size, alignof(std::max_align_t));
+    memcpy(buffer, source_frag.get_storage_location(), size);
+    Fragment taken_frag(buffer, Fragment::BufferAdoptionMode::kTakeOverBuffer, &resource);
+    BOOST_REQUIRE_EQUAL(taken_frag.get_size(), size);
+  }
+  BOOST_REQUIRE_EQUAL(resource.allocations, 3);
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 3);
+  BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, 0);
+
+  {
+    Fragment source_frag(buf1.data(), buf1.size());
+    auto size = source_frag.get_size();
+    void* buffer = resource.allocate(2 * size, alignof(std::max_align_t));
+    memcpy(buffer, source_frag.get_storage_location(), size);
+    BOOST_REQUIRE_THROW(Fragment(buffer, Fragment::BufferAdoptionMode::kTakeOverBuffer, &resource, size - 1),
+                        std::invalid_argument);
+    Fragment taken_frag(buffer, Fragment::BufferAdoptionMode::kTakeOverBuffer, &resource, 2 * size);
+    BOOST_REQUIRE_EQUAL(taken_frag.get_size(), size);
+  }
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 4);
+  BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, 0);
+
+  {
+    Fragment first_frag(buf1.data(), buf1.size(), &resource);
+    Fragment second_frag(buf1.data(), buf1.size(), &resource);
+    first_frag = std::move(second_frag);
+    BOOST_REQUIRE_EQUAL(resource.deallocations, 5);
+  }
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 6);
+  BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, 0);
+}
+
 /**
  * @brief Test header field manipulation methods
  */
@@ -0,0 +1,164 @@
+/**
+ * @file IndexedRecordFileWriter_test.cxx IndexedRecordFileWriter class and footer index Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/IndexedRecordFileWriter.hpp"
+#include "daqdataformats/MappedRecordFile.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE IndexedRecordFileWriter_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief Temporary file name, removed at the end of the test
+ */
+struct TemporaryPath
+{
+  TemporaryPath()
+  {
+    char name[] = "/tmp/IndexedRecordFileWriter_test_XXXXXX";
+    ::close(::mkstemp(name));
+    path = name;
+  }
+  ~TemporaryPath() { ::unlink(path.c_str()); }
+  std::string path;
+};
+
+/**
+ * @brief Make TriggerRecords with shuffled keys and Fragments of odd sizes
+ */
+std::vector<std::unique_ptr<TriggerRecord>>
+make_records()
+{
+  std::vector<std::unique_ptr<TriggerRecord>> records;
+  for (trigger_number_t trigger_number : { 5, 3, 9, 1, 7 }) {
+    for (sequence_number_t sequence_number = 0; sequence_number < 2; ++sequence_number) {
+      auto record = std::make_unique<TriggerRecord>(std::vector<ComponentRequest>(1));
+      record->get_header_ref().set_run_number(trigger_number == 9 ? 2 : 1);
+      record->get_header_ref().set_trigger_number(trigger_number);
+      record->get_header_ref().set_sequence_number(sequence_number);
+      for (size_t i = 0; i < trigger_number % 4; ++i) {
+        std::vector<uint8_t> payload(3 + i, static_cast<uint8_t>(trigger_number)); // NOLINT(build/unsigned)
+        record->add_fragment(std::make_unique<Fragment>(payload.data(), payload.size()));
+      }
+      records.push_back(std::move(record));
+    }
+  }
+  return records;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(IndexedRecordFileWriter_test)
+
+/**
+ * @brief Check the index and trailer structs
+ */
+BOOST_AUTO_TEST_CASE(IndexStructs)
+{
+  RecordIndexEntry first, second;
+  first.run_number = 1;
+  first.trigger_number = 10;
+  second.run_number = 2;
+  second.trigger_number = 1;
+  BOOST_REQUIRE(first < second);
+  second.run_number = 1;
+  BOOST_REQUIRE(second < first);
+
+  RecordFileTrailer trailer;
+  BOOST_REQUIRE_EQUAL(trailer.record_file_trailer_marker, RecordFileTrailer::s_record_file_trailer_marker);
+  BOOST_REQUIRE_EQUAL(trailer.version, RecordFileTrailer::s_record_file_trailer_version);
+}
+
+/**
+ * @brief Check that a closed file is opened from its footer index and searched by key
+ */
+BOOST_AUTO_TEST_CASE(IndexedLookup)
+{
+  TemporaryPath file;
+  auto records = make_records();
+  {
+    IndexedRecordFileWriter writer(file.path);
+    for (auto const& record : records)
+      writer.append(*record);
+    BOOST_REQUIRE_EQUAL(writer.get_num_records(), records.size());
+    writer.close();
+    writer.close();
+  }
+
+  MappedRecordFile mapped(file.path);
+  BOOST_REQUIRE(mapped.has_index());
+  BOOST_REQUIRE(!mapped.is_truncated());
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), records.size());
+
+  for (auto const& record : records) {
+    auto const& header = record->get_header_ref();
+    auto idx =
+      mapped.find_trigger_record(header.get_run_number(), header.get_trigger_number(), header.get_sequence_number());
+    BOOST_REQUIRE(idx < mapped.get_num_records());
+    auto read = mapped.get_trigger_record(idx);
+    BOOST_REQUIRE_EQUAL(read->get_header_ref().get_trigger_number(), header.get_trigger_number());
+    BOOST_REQUIRE_EQUAL(read->get_header_ref().get_sequence_number(), header.get_sequence_number());
+    BOOST_REQUIRE_EQUAL(read->get_total_size_bytes(), record->get_total_size_bytes());
+  }
+  BOOST_REQUIRE_EQUAL(mapped.find_trigger_record(1, 9, 0), mapped.get_num_records());
+  BOOST_REQUIRE_EQUAL(mapped.find_trigger_record(1, 4, 0), mapped.get_num_records());
+
+  // Records are listed in key order
+  auto first = mapped.get_trigger_record(0);
+  auto last = mapped.get_trigger_record(mapped.get_num_records() - 1);
+  BOOST_REQUIRE_EQUAL(first->get_header_ref().get_trigger_number(), 1);
+  BOOST_REQUIRE_EQUAL(last->get_header_ref().get_run_number(), 2);
+}
+
+/**
+ * @brief Check that a file without a complete trailer is read sequentially
+ */
+BOOST_AUTO_TEST_CASE(SequentialFallback)
+{
+  TemporaryPath file;
+  auto records = make_records();
+  size_t records_size = 0;
+  {
+    IndexedRecordFileWriter writer(file.path);
+    for (auto const& record : records) {
+      writer.append(*record);
+      records_size += record->get_total_size_bytes();
+    }
+    writer.close();
+  }
+
+  // Remove the last byte of the trailer, as if the writer had been interrupted
+  {
+    MappedRecordFile complete(file.path);
+    BOOST_REQUIRE_EQUAL(::truncate(file.path.c_str(), complete.get_size() - 1), 0);
+  }
+
+  MappedRecordFile mapped(file.path);
+  BOOST_REQUIRE(!mapped.has_index());
+  BOOST_REQUIRE(mapped.is_truncated());
+  BOOST_REQUIRE_EQUAL(mapped.get_valid_size(), records_size);
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), records.size());
+
+  // Records are listed in file order
+  auto idx = mapped.find_trigger_record(1, 7, 1);
+  BOOST_REQUIRE_EQUAL(idx, records.size() - 1);
+  BOOST_REQUIRE_EQUAL(mapped.get_trigger_record(idx)->get_fragments_ref().size(), 3);
+  BOOST_REQUIRE_EQUAL(mapped.find_trigger_record(3, 1, 0), mapped.get_num_records());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
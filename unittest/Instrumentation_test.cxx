@@ -0,0 +1,169 @@
+/**
+ * @file Instrumentation_test.cxx Instrumentation counters Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// The counters are always tested, whether or not the build enables them
+#ifndef DAQDATAFORMATS_ENABLE_INSTRUMENTATION
+#define DAQDATAFORMATS_ENABLE_INSTRUMENTATION 1
+#endif
+
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentBuilder.hpp"
+#include "daqdataformats/Instrumentation.hpp"
+#include "daqdataformats/SharedFragment.hpp"
+#include "daqdataformats/TriggerRecord.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE Instrumentation_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+using namespace dunedaq::daqdataformats::instrumentation;
+
+BOOST_AUTO_TEST_SUITE(Instrumentation_test)
+
+/**
+ * @brief Check that Fragment allocations, copies and frees are counted, by class and by FragmentType
+ */
+BOOST_AUTO_TEST_CASE(FragmentCounters)
+{
+  BOOST_REQUIRE(s_enabled);
+  std::vector<char> payload(100, 'x');
+  auto before = snapshot();
+  {
+    Fragment fragment(payload.data(), payload.size());
+    auto size = fragment.get_size();
+    auto counters = (snapshot() - before).get(InstrumentedClass::kFragment);
+    BOOST_REQUIRE_EQUAL(counters.allocations, 1);
+    BOOST_REQUIRE_EQUAL(counters.bytes_allocated, size);
+    BOOST_REQUIRE_EQUAL(counters.bytes_copied, size);
+    BOOST_REQUIRE_EQUAL(counters.live_bytes(), static_cast<int64_t>(size));
+    BOOST_REQUIRE_EQUAL((snapshot() - before).get(FragmentType::kUnknown).live_bytes(), static_cast<int64_t>(size));
+
+    // Setting the type moves the live buffer to the new FragmentType
+    fragment.set_type(FragmentType::kWIBEth);
+    auto delta = snapshot() - before;
+    BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kUnknown).live_bytes(), 0);
+    BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).live_bytes(), static_cast<int64_t>(size));
+    BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).live_allocations(), 1);
+
+    Fragment copy(const_cast<void*>(fragment.get_storage_location()), Fragment::BufferAdoptionMode::kCopyFromBuffer);
+    Fragment view(const_cast<void*>(fragment.get_storage_location()), Fragment::BufferAdoptionMode::kReadOnlyMode);
+    copy.get_header();
+    delta = snapshot() - before;
+    BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).allocations, 2);
+    BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).bytes_copied, 2 * size + sizeof(FragmentHeader));
+    BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).bytes_copied, size + sizeof(FragmentHeader));
+  }
+  auto delta = snapshot() - before;
+  BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).frees, 2);
+  BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).live_bytes(), 0);
+  BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).live_bytes(), 0);
+  BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).live_allocations(), 0);
+}
+
+/**
+ * @brief Check that a Fragment finalized by a FragmentBuilder counts its allocation as well as its free
+ */
+BOOST_AUTO_TEST_CASE(FragmentBuilderCounters)
+{
+  std::vector<char> payload(100, 'x');
+  auto before = snapshot();
+  {
+    FragmentBuilder builder;
+    builder.append(payload.data(), payload.size());
+    builder.get_header().fragment_type = static_cast<fragment_type_t>(FragmentType::kWIBEth);
+    auto capacity = sizeof(FragmentHeader) + builder.get_payload_capacity();
+    auto fragment = builder.finalize();
+    auto delta = snapshot() - before;
+    BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).allocations, 1);
+    BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).bytes_allocated, capacity);
+    BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).live_bytes(), static_cast<int64_t>(capacity));
+  }
+  auto delta = snapshot() - before;
+  BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).frees, 1);
+  BOOST_REQUIRE_EQUAL(delta.get(InstrumentedClass::kFragment).live_bytes(), 0);
+  BOOST_REQUIRE_EQUAL(delta.get(FragmentType::kWIBEth).live_allocations(), 0);
+}
+
+/**
+ * @brief Check that a SharedFragment is allocated and copied once, however many handles share it
+ */
+BOOST_AUTO_TEST_CASE(SharedFragmentCounters)
+{
+  std::vector<char> payload(100, 'x');
+  Fragment fragment(payload.data(), payload.size());
+  auto before = snapshot();
+  {
+    SharedFragment shared(fragment);
+    std::vector<SharedFragment> consumers(10, shared);
+    auto counters = (snapshot() - before).get(InstrumentedClass::kFragment);
+    BOOST_REQUIRE_EQUAL(counters.allocations, 1);
+    BOOST_REQUIRE_EQUAL(counters.bytes_copied, fragment.get_size());
+    BOOST_REQUIRE_GT(counters.bytes_allocated, fragment.get_size());
+  }
+  auto counters = (snapshot() - before).get(InstrumentedClass::kFragment);
+  BOOST_REQUIRE_EQUAL(counters.frees, 1);
+  BOOST_REQUIRE_EQUAL(counters.live_bytes(), 0);
+}
+
+/**
+ * @brief Check that TriggerRecordHeader copies and TriggerRecord serialization are counted
+ */
+BOOST_AUTO_TEST_CASE(TriggerRecordCounters)
+{
+  std::vector<ComponentRequest> components(3);
+  auto before = snapshot();
+  {
+    TriggerRecordHeader header(components);
+    auto size = header.get_total_size_bytes();
+    TriggerRecordHeader copy(header);
+    copy = header;
+    header.get_header();
+    auto counters = (snapshot() - before).get(InstrumentedClass::kTriggerRecordHeader);
+    BOOST_REQUIRE_EQUAL(counters.allocations, 3);
+    BOOST_REQUIRE_EQUAL(counters.frees, 1);
+    BOOST_REQUIRE_EQUAL(counters.live_bytes(), static_cast<int64_t>(2 * size));
+    BOOST_REQUIRE_EQUAL(counters.bytes_copied, 3 * size + sizeof(TriggerRecordHeaderData));
+
+    TriggerRecord record(TriggerRecord::s_adopt_header, std::move(copy));
+    std::vector<char> image(record.serialized_size());
+    auto written = record.serialize_into(image.data(), image.size());
+    BOOST_REQUIRE_EQUAL((snapshot() - before).get(InstrumentedClass::kTriggerRecord).bytes_copied, written);
+  }
+  BOOST_REQUIRE_EQUAL((snapshot() - before).get(InstrumentedClass::kTriggerRecordHeader).live_bytes(), 0);
+}
+
+/**
+ * @brief Check that the counters of exited threads are kept
+ */
+BOOST_AUTO_TEST_CASE(ThreadCounters)
+{
+  std::vector<char> payload(10, 'x');
+  auto before = snapshot();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 100; ++j)
+        Fragment fragment(payload.data(), payload.size());
+    });
+  for (auto& thread : threads)
+    thread.join();
+  auto counters = (snapshot() - before).get(InstrumentedClass::kFragment);
+  BOOST_REQUIRE_EQUAL(counters.allocations, 400);
+  BOOST_REQUIRE_EQUAL(counters.frees, 400);
+  BOOST_REQUIRE_EQUAL(counters.bytes_allocated, 400 * (sizeof(FragmentHeader) + payload.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
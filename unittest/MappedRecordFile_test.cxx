@@ -0,0 +1,218 @@
+/**
+ * @file MappedRecordFile_test.cxx MappedRecordFile class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/MappedRecordFile.hpp"
+#include "daqdataformats/VectoredWriter.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE MappedRecordFile_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief Temporary file removed at the end of the test
+ */
+struct TemporaryFile
+{
+  TemporaryFile()
+  {
+    char name[] = "/tmp/MappedRecordFile_test_XXXXXX";
+    fd = ::mkstemp(name);
+    path = name;
+  }
+  ~TemporaryFile()
+  {
+    ::close(fd);
+    ::unlink(path.c_str());
+  }
+  int fd;
+  std::string path;
+};
+
+/**
+ * @brief Make a Fragment with a payload of the given size
+ */
+std::unique_ptr<Fragment>
+make_fragment(size_t size, uint8_t fill) // NOLINT(build/unsigned)
+{
+  std::vector<uint8_t> payload(size, fill); // NOLINT(build/unsigned)
+  auto fragment = std::make_unique<Fragment>(payload.data(), payload.size());
+  fragment->set_sequence_number(fill);
+  return fragment;
+}
+
+/**
+ * @brief Make a TriggerRecord with the given trigger number and number of Fragments
+ */
+std::unique_ptr<TriggerRecord>
+make_record(trigger_number_t trigger_number, size_t num_fragments)
+{
+  auto record = std::make_unique<TriggerRecord>(std::vector<ComponentRequest>(2));
+  record->get_header_ref().set_trigger_number(trigger_number);
+  for (size_t i = 0; i < num_fragments; ++i)
+    record->add_fragment(make_fragment(8 * (i + 1), static_cast<uint8_t>(i))); // NOLINT(build/unsigned)
+  return record;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(MappedRecordFile_test)
+
+/**
+ * @brief Check that records written by VectoredWriter are read back in place
+ */
+BOOST_AUTO_TEST_CASE(ReadBack)
+{
+  TemporaryFile file;
+  BOOST_REQUIRE(file.fd >= 0);
+
+  auto first = make_record(1, 3);
+  TimeSlice timeslice(7, 8);
+  timeslice.add_fragment(make_fragment(16, 9));
+  auto second = make_record(2, 0);
+
+  VectoredWriter writer(file.fd);
+  writer.add(*first);
+  writer.add(timeslice);
+  writer.add(*second);
+  writer.flush();
+
+  MappedRecordFile mapped(file.path);
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), 3);
+  BOOST_REQUIRE(!mapped.is_truncated());
+  BOOST_REQUIRE_EQUAL(mapped.get_size(), first->get_total_size_bytes() + sizeof(TimeSliceHeader) +
+                                           timeslice.get_fragments_ref()[0]->get_size() +
+                                           second->get_total_size_bytes());
+
+  auto const& entries = mapped.get_record_entries();
+  BOOST_REQUIRE(entries[1].type == MappedRecordFile::RecordType::kTimeSlice);
+  BOOST_REQUIRE_EQUAL(entries[0].num_fragments, 3);
+  BOOST_REQUIRE_EQUAL(entries[2].num_fragments, 0);
+
+  auto record = mapped.get_trigger_record(0);
+  BOOST_REQUIRE_EQUAL(record->get_header_ref().get_trigger_number(), 1);
+  BOOST_REQUIRE_EQUAL(record->get_header_ref().get_num_requested_components(), 2);
+  BOOST_REQUIRE_EQUAL(record->get_total_size_bytes(), first->get_total_size_bytes());
+  for (size_t i = 0; i < 3; ++i) {
+    auto const& fragment = record->get_fragments_ref()[i];
+    BOOST_REQUIRE_EQUAL(fragment->get_sequence_number(), i);
+    BOOST_REQUIRE_EQUAL(fragment->get_data_size(), 8 * (i + 1));
+    BOOST_REQUIRE_EQUAL(
+      std::memcmp(fragment->get_storage_location(), first->get_fragments_ref()[i]->get_storage_location(), 8 * (i + 1)),
+      0);
+  }
+
+  // Fragments point into the mapping, one after the other
+  auto base = static_cast<const uint8_t*>(record->get_header_ref().get_storage_location()); // NOLINT(build/unsigned)
+  BOOST_REQUIRE_EQUAL(record->get_fragments_ref()[0]->get_storage_location(),
+                      base + record->get_header_ref().get_total_size_bytes());
+
+  auto read_slice = mapped.get_timeslice(1);
+  BOOST_REQUIRE_EQUAL(read_slice->get_header().timeslice_number, 7);
+  BOOST_REQUIRE_EQUAL(read_slice->get_fragments_ref().size(), 1);
+  BOOST_REQUIRE_EQUAL(read_slice->get_fragments_ref()[0]->get_sequence_number(), 9);
+
+  BOOST_REQUIRE_EQUAL(mapped.get_trigger_record(2)->get_header_ref().get_trigger_number(), 2);
+  BOOST_REQUIRE_THROW(mapped.get_trigger_record(1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(mapped.get_timeslice(3), std::range_error);
+
+  // Writing through a handed-out object does not modify the file
+  record->get_fragments_ref()[0]->set_run_number(12345);
+  MappedRecordFile reopened(file.path);
+  BOOST_REQUIRE(reopened.get_trigger_record(0)->get_fragments_ref()[0]->get_run_number() != 12345);
+}
+
+/**
+ * @brief Check that records and Fragments at misaligned offsets are copied out of the mapping
+ */
+BOOST_AUTO_TEST_CASE(MisalignedRecords)
+{
+  TemporaryFile file;
+  BOOST_REQUIRE(file.fd >= 0);
+
+  auto first = std::make_unique<TriggerRecord>(std::vector<ComponentRequest>(1));
+  first->add_fragment(make_fragment(3, 1));
+  first->add_fragment(make_fragment(8, 2));
+  auto second = make_record(2, 1);
+  VectoredWriter writer(file.fd);
+  writer.add(*first);
+  writer.add(*second);
+  writer.flush();
+
+  MappedRecordFile mapped(file.path);
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), 2);
+
+  // The first Fragment is aligned and pointed into, the second one follows a 3-byte payload and is copied
+  auto record = mapped.get_trigger_record(0);
+  BOOST_REQUIRE(!record->get_fragments_ref()[0]->owns_buffer());
+  BOOST_REQUIRE(record->get_fragments_ref()[1]->owns_buffer());
+  BOOST_REQUIRE_EQUAL(record->get_fragments_ref()[1]->get_sequence_number(), 2);
+  BOOST_REQUIRE_EQUAL(record->get_fragments_ref()[1]->get_data_size(), 8);
+  BOOST_REQUIRE_EQUAL(
+    std::memcmp(record->get_fragments_ref()[1]->get_storage_location(),
+                first->get_fragments_ref()[1]->get_storage_location(),
+                first->get_fragments_ref()[1]->get_size()),
+    0);
+
+  // The second record starts at a misaligned offset, so its header is copied too
+  BOOST_REQUIRE_NE(mapped.get_record_entries()[1].offset % alignof(TriggerRecordHeaderData), 0);
+  auto misaligned = mapped.get_trigger_record(1);
+  BOOST_REQUIRE_EQUAL(misaligned->get_header_ref().get_trigger_number(), 2);
+  BOOST_REQUIRE_EQUAL(misaligned->get_header_ref().get_num_requested_components(), 2);
+  BOOST_REQUIRE(misaligned->get_fragments_ref()[0]->owns_buffer());
+  BOOST_REQUIRE_EQUAL(misaligned->get_fragments_ref()[0]->get_data_size(), 8);
+}
+
+/**
+ * @brief Check that a partially written record at the end of the file is reported and skipped
+ */
+BOOST_AUTO_TEST_CASE(Truncated)
+{
+  TemporaryFile file;
+  BOOST_REQUIRE(file.fd >= 0);
+
+  auto complete = make_record(1, 2);
+  auto partial = make_record(2, 2);
+  VectoredWriter(file.fd).write(*complete);
+  VectoredWriter(file.fd).write(*partial);
+  BOOST_REQUIRE_EQUAL(::ftruncate(file.fd, complete->get_total_size_bytes() + partial->get_total_size_bytes() - 1), 0);
+
+  MappedRecordFile mapped(file.path);
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), 1);
+  BOOST_REQUIRE(mapped.is_truncated());
+  BOOST_REQUIRE_EQUAL(mapped.get_valid_size(), complete->get_total_size_bytes());
+
+  MappedRecordFile moved(std::move(mapped));
+  BOOST_REQUIRE_EQUAL(moved.get_trigger_record(0)->get_fragments_ref().size(), 2);
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), 0); // NOLINT(bugprone-use-after-move)
+}
+
+/**
+ * @brief Check empty and missing files
+ */
+BOOST_AUTO_TEST_CASE(EmptyAndMissing)
+{
+  TemporaryFile file;
+  MappedRecordFile mapped(file.path);
+  BOOST_REQUIRE_EQUAL(mapped.get_num_records(), 0);
+  BOOST_REQUIRE(!mapped.is_truncated());
+
+  BOOST_REQUIRE_THROW(MappedRecordFile("/nonexistent/MappedRecordFile_test"), std::system_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+/**
+ * @file MarkerScanner_test.cxx MarkerScanner class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/MarkerScanner.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/TriggerRecordHeader.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE MarkerScanner_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief Append a buffer to a byte vector
+ */
+void
+append(std::vector<uint8_t>& bytes, const void* data, size_t size) // NOLINT(build/unsigned)
+{
+  auto base = static_cast<const uint8_t*>(data); // NOLINT(build/unsigned)
+  bytes.insert(bytes.end(), base, base + size);
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(MarkerScanner_test)
+
+/**
+ * @brief Check that the vector and scalar searches agree at every alignment
+ */
+BOOST_AUTO_TEST_CASE(CandidateSearch)
+{
+  std::mt19937 generator(1234);
+  std::vector<uint8_t> bytes(1000); // NOLINT(build/unsigned)
+  for (auto& byte : bytes)
+    byte = static_cast<uint8_t>(generator()); // NOLINT(build/unsigned)
+
+  // Near misses: first and last marker bytes without the middle ones
+  for (size_t i = 0; i < 200; i += 7) {
+    bytes[i] = 0x22;
+    bytes[i + 3] = 0x11;
+  }
+
+  for (auto marker : { FragmentHeader::s_fragment_header_marker,
+                       TriggerRecordHeaderData::s_trigger_record_header_magic,
+                       TimeSliceHeader::s_timeslice_header_marker }) {
+    for (size_t position = 200; position < 300; ++position) {
+      auto planted = bytes;
+      std::memcpy(planted.data() + position, &marker, sizeof(marker));
+      auto expected = detail::find_marker_scalar(planted.data(), planted.size(), 0);
+      BOOST_REQUIRE(expected <= position);
+      BOOST_REQUIRE_EQUAL(MarkerScanner::find_candidate(planted.data(), planted.size(), 0), expected);
+#if defined(__x86_64__)
+      BOOST_REQUIRE_EQUAL(detail::find_marker_sse2(planted.data(), planted.size(), 0), expected);
+      if (__builtin_cpu_supports("avx2"))
+        BOOST_REQUIRE_EQUAL(detail::find_marker_avx2(planted.data(), planted.size(), 0), expected);
+#endif
+    }
+  }
+
+  // A marker in the last four bytes is found, one that does not fit is not
+  std::vector<uint8_t> tail(100, 0); // NOLINT(build/unsigned)
+  auto marker = TimeSliceHeader::s_timeslice_header_marker;
+  std::memcpy(tail.data() + 96, &marker, sizeof(marker));
+  BOOST_REQUIRE_EQUAL(MarkerScanner::find_candidate(tail.data(), tail.size(), 0), 96);
+  BOOST_REQUIRE_EQUAL(MarkerScanner::find_candidate(tail.data(), tail.size() - 1, 0), tail.size() - 1);
+}
+
+/**
+ * @brief Check that headers are found in a corrupted stream and that invalid candidates are rejected
+ */
+BOOST_AUTO_TEST_CASE(Resynchronize)
+{
+  std::vector<uint8_t> stream(13, 0xAB); // NOLINT(build/unsigned)
+
+  TriggerRecordHeader record_header(std::vector<ComponentRequest>(2));
+  size_t record_offset = stream.size();
+  append(stream, record_header.get_storage_location(), record_header.get_total_size_bytes());
+
+  // Fragment whose payload holds a valid-looking header, which must be skipped
+  std::vector<uint8_t> payload(80, 0); // NOLINT(build/unsigned)
+  TriggerRecordHeaderData fake;
+  fake.num_requested_components = 0;
+  std::memcpy(payload.data() + 5, &fake, sizeof(fake));
+  Fragment fragment(payload.data(), payload.size());
+  size_t fragment_offset = stream.size();
+  append(stream, fragment.get_storage_location(), fragment.get_size());
+
+  // Fragment with a wrong version, which must be rejected
+  size_t bad_offset = stream.size();
+  append(stream, fragment.get_storage_location(), 30);
+  uint32_t bad_version = FragmentHeader::s_fragment_header_version + 1; // NOLINT(build/unsigned)
+  std::memcpy(stream.data() + bad_offset + offsetof(FragmentHeader, version), &bad_version, sizeof(bad_version));
+
+  TimeSliceHeader slice_header;
+  size_t slice_offset = stream.size();
+  append(stream, &slice_header, sizeof(slice_header));
+
+  // Truncated Fragment at the end of the stream
+  std::vector<uint8_t> zeros(50, 0); // NOLINT(build/unsigned)
+  Fragment truncated(zeros.data(), zeros.size());
+  size_t truncated_offset = stream.size();
+  append(stream, truncated.get_storage_location(), truncated.get_size() - 1);
+
+  MarkerScanner scanner(stream.data(), stream.size());
+  auto boundaries = scanner.scan_all();
+  BOOST_REQUIRE_EQUAL(boundaries.size(), 4);
+
+  BOOST_REQUIRE(boundaries[0].type == RecordBoundary::Type::kTriggerRecordHeader);
+  BOOST_REQUIRE_EQUAL(boundaries[0].offset, record_offset);
+  BOOST_REQUIRE_EQUAL(boundaries[0].size, record_header.get_total_size_bytes());
+  BOOST_REQUIRE(boundaries[1].type == RecordBoundary::Type::kFragment);
+  BOOST_REQUIRE_EQUAL(boundaries[1].offset, fragment_offset);
+  BOOST_REQUIRE_EQUAL(boundaries[1].size, fragment.get_size());
+  BOOST_REQUIRE(boundaries[2].type == RecordBoundary::Type::kTimeSliceHeader);
+  BOOST_REQUIRE_EQUAL(boundaries[2].offset, slice_offset);
+  BOOST_REQUIRE(boundaries[2].complete);
+  BOOST_REQUIRE(boundaries[3].type == RecordBoundary::Type::kFragment);
+  BOOST_REQUIRE_EQUAL(boundaries[3].offset, truncated_offset);
+  BOOST_REQUIRE(!boundaries[3].complete);
+
+  BOOST_REQUIRE_EQUAL(scanner.get_num_rejected_candidates(), 1);
+
+  // Scanning from inside the first Fragment's payload finds the fake header
+  MarkerScanner rescanner(stream.data(), stream.size());
+  rescanner.set_position(fragment_offset + sizeof(FragmentHeader));
+  RecordBoundary boundary;
+  BOOST_REQUIRE(rescanner.next(boundary));
+  BOOST_REQUIRE(boundary.type == RecordBoundary::Type::kTriggerRecordHeader);
+  BOOST_REQUIRE_EQUAL(boundary.offset, fragment_offset + sizeof(FragmentHeader) + 5);
+  BOOST_REQUIRE_EQUAL(boundary.size, sizeof(TriggerRecordHeaderData));
+}
+
+/**
+ * @brief Check that implausible sizes are rejected
+ */
+BOOST_AUTO_TEST_CASE(PlausibleSize)
+{
+  std::vector<uint8_t> payload(100, 0); // NOLINT(build/unsigned)
+  Fragment fragment(payload.data(), payload.size());
+
+  MarkerScanner strict(fragment.get_storage_location(), fragment.get_size(), 64);
+  RecordBoundary boundary;
+  BOOST_REQUIRE(!strict.next(boundary));
+  BOOST_REQUIRE_EQUAL(strict.get_num_rejected_candidates(), 1);
+  BOOST_REQUIRE_EQUAL(strict.get_position(), fragment.get_size());
+
+  MarkerScanner lenient(fragment.get_storage_location(), fragment.get_size());
+  BOOST_REQUIRE(lenient.next(boundary));
+  BOOST_REQUIRE(boundary.complete);
+  BOOST_REQUIRE(!lenient.next(boundary));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
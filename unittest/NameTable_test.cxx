@@ -0,0 +1,77 @@
+/**
+ * @file NameTable_test.cxx NameTable class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/NameTable.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE NameTable_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+enum class Color : int
+{
+  kRed = 0,
+  kGreen = 1,
+  kBlue = 2
+};
+
+constexpr NameTable<Color, 3> s_color_names{ { "Red", "Green", "Blue" } };
+
+static_assert(s_color_names.get_name(Color::kGreen) == "Green");
+static_assert(s_color_names.find("Blue") == Color::kBlue);
+static_assert(!s_color_names.find("Purple").has_value());
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NameTable_test)
+
+/**
+ * @brief Test that names and values convert both ways
+ */
+BOOST_AUTO_TEST_CASE(Lookup)
+{
+  BOOST_REQUIRE_EQUAL(s_color_names.size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    auto color = static_cast<Color>(i);
+    auto found = s_color_names.find(s_color_names.get_name(color));
+    BOOST_REQUIRE(found.has_value());
+    BOOST_REQUIRE(*found == color);
+  }
+
+  // Names are matched exactly
+  BOOST_REQUIRE(!s_color_names.find("").has_value());
+  BOOST_REQUIRE(!s_color_names.find("red").has_value());
+  BOOST_REQUIRE(!s_color_names.find("Re").has_value());
+  BOOST_REQUIRE(!s_color_names.find("Redd").has_value());
+  std::string green = "Green";
+  BOOST_REQUIRE(s_color_names.find(green) == Color::kGreen);
+
+  BOOST_REQUIRE(s_color_names.get_name(static_cast<Color>(3)).empty());
+  BOOST_REQUIRE(s_color_names.get_name(static_cast<Color>(-1)).empty());
+}
+
+/**
+ * @brief Test that invalid name lists are rejected
+ */
+BOOST_AUTO_TEST_CASE(InvalidNames)
+{
+  using Table = NameTable<Color, 3>;
+  BOOST_REQUIRE_THROW(Table(std::array<std::string_view, 3>{ "Red", "Green", "Red" }), std::invalid_argument);
+  BOOST_REQUIRE_THROW(Table(std::array<std::string_view, 3>{ "Red", "", "Blue" }), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
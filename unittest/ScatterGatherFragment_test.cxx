@@ -0,0 +1,202 @@
+/**
+ * @file ScatterGatherFragment_test.cxx ScatterGatherFragment class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/ScatterGatherFragment.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE ScatterGatherFragment_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief Concatenate the buffers described by an iovec array
+ */
+std::vector<uint8_t> // NOLINT(build/unsigned)
+gather(const std::vector<iovec>& iovecs)
+{
+  std::vector<uint8_t> bytes; // NOLINT(build/unsigned)
+  for (auto const& iov : iovecs) {
+    auto base = static_cast<uint8_t*>(iov.iov_base); // NOLINT(build/unsigned)
+    bytes.insert(bytes.end(), base, base + iov.iov_len);
+  }
+  return bytes;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ScatterGatherFragment_test)
+
+/**
+ * @brief Check that the iovec export is byte-identical to the equivalent contiguous Fragment
+ */
+BOOST_AUTO_TEST_CASE(IovecExport)
+{
+  std::vector<uint8_t> borrowed(1000); // NOLINT(build/unsigned)
+  std::vector<uint8_t> copied(300);    // NOLINT(build/unsigned)
+  std::iota(borrowed.begin(), borrowed.end(), 0);
+  std::iota(copied.begin(), copied.end(), 17);
+  auto owned = static_cast<uint8_t*>(malloc(50)); // NOLINT(build/unsigned)
+  std::memset(owned, 0x5A, 50);
+
+  ScatterGatherFragment sg_frag;
+  sg_frag.set_run_number(7);
+  sg_frag.set_trigger_number(8);
+  sg_frag.add_chunk(borrowed.data(), borrowed.size());
+  sg_frag.add_chunk(copied.data(), copied.size(), Fragment::BufferAdoptionMode::kCopyFromBuffer);
+  sg_frag.add_chunk(owned, 50, Fragment::BufferAdoptionMode::kTakeOverBuffer);
+  copied.assign(copied.size(), 0); // The copy must not depend on the original
+
+  BOOST_REQUIRE_EQUAL(sg_frag.get_num_chunks(), 3);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_size(), sizeof(FragmentHeader) + 1350);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_iovecs().size(), 4);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_iovecs()[1].iov_base, borrowed.data());
+
+  std::vector<uint8_t> expected_payload(borrowed); // NOLINT(build/unsigned)
+  for (int i = 0; i < 300; ++i)
+    expected_payload.push_back(17 + i);
+  expected_payload.insert(expected_payload.end(), 50, 0x5A);
+
+  auto contiguous = sg_frag.to_fragment();
+  BOOST_REQUIRE_EQUAL(contiguous.get_size(), sg_frag.get_size());
+  BOOST_REQUIRE_EQUAL(contiguous.get_run_number(), 7);
+  BOOST_REQUIRE_EQUAL(contiguous.get_trigger_number(), 8);
+  BOOST_REQUIRE_EQUAL(std::memcmp(contiguous.get_data(), expected_payload.data(), expected_payload.size()), 0);
+
+  auto bytes = gather(sg_frag.get_iovecs());
+  BOOST_REQUIRE_EQUAL(bytes.size(), contiguous.get_size());
+  BOOST_REQUIRE_EQUAL(std::memcmp(bytes.data(), contiguous.get_storage_location(), bytes.size()), 0);
+}
+
+/**
+ * @brief Check that writev of the iovec array writes the same bytes as the contiguous Fragment
+ */
+BOOST_AUTO_TEST_CASE(Writev)
+{
+  std::vector<uint8_t> first(4096, 1);  // NOLINT(build/unsigned)
+  std::vector<uint8_t> second(4096, 2); // NOLINT(build/unsigned)
+  ScatterGatherFragment sg_frag;
+  sg_frag.add_chunk(first.data(), first.size());
+  sg_frag.add_chunk(second.data(), second.size());
+
+  FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  auto const& iovecs = sg_frag.get_iovecs();
+  auto written = ::writev(fileno(file), iovecs.data(), iovecs.size());
+  BOOST_REQUIRE_EQUAL(written, static_cast<ssize_t>(sg_frag.get_size()));
+
+  std::vector<uint8_t> read_back(sg_frag.get_size()); // NOLINT(build/unsigned)
+  std::rewind(file);
+  BOOST_REQUIRE_EQUAL(std::fread(read_back.data(), 1, read_back.size(), file), read_back.size());
+  std::fclose(file);
+
+  auto contiguous = sg_frag.to_fragment();
+  BOOST_REQUIRE_EQUAL(std::memcmp(read_back.data(), contiguous.get_storage_location(), read_back.size()), 0);
+}
+
+/**
+ * @brief Check that get_data only flattens when there is more than one chunk
+ */
+BOOST_AUTO_TEST_CASE(LazyFlatten)
+{
+  ScatterGatherFragment sg_frag;
+  BOOST_REQUIRE(sg_frag.get_data() == nullptr);
+
+  std::vector<uint8_t> first(10, 1);  // NOLINT(build/unsigned)
+  std::vector<uint8_t> second(20, 2); // NOLINT(build/unsigned)
+  sg_frag.add_chunk(first.data(), first.size());
+  BOOST_REQUIRE_EQUAL(sg_frag.get_data(), first.data());
+
+  sg_frag.add_chunk(second.data(), second.size());
+  auto data = static_cast<uint8_t*>(sg_frag.get_data()); // NOLINT(build/unsigned)
+  BOOST_REQUIRE(data != first.data());
+  BOOST_REQUIRE_EQUAL(sg_frag.get_num_chunks(), 1);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_data_size(), 30);
+  BOOST_REQUIRE_EQUAL(data[9], 1);
+  BOOST_REQUIRE_EQUAL(data[10], 2);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_iovecs().size(), 2);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_data(), data);
+}
+
+/**
+ * @brief Check that empty chunks are neither stored nor allocated
+ */
+BOOST_AUTO_TEST_CASE(EmptyChunks)
+{
+  ScatterGatherFragment sg_frag;
+  std::vector<uint8_t> empty(1); // NOLINT(build/unsigned)
+  sg_frag.add_chunk(empty.data(), 0);
+  sg_frag.add_chunk(empty.data(), 0, Fragment::BufferAdoptionMode::kCopyFromBuffer);
+  sg_frag.add_chunk(malloc(1), 0, Fragment::BufferAdoptionMode::kTakeOverBuffer); // NOLINT(build/unsigned)
+  BOOST_REQUIRE_EQUAL(sg_frag.get_num_chunks(), 0);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_iovecs().size(), 1);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_size(), sizeof(FragmentHeader));
+  BOOST_REQUIRE(sg_frag.get_data() == nullptr);
+  BOOST_REQUIRE_EQUAL(sg_frag.to_fragment().get_size(), sizeof(FragmentHeader));
+}
+
+/**
+ * @brief Check that header fields can be set without desynchronizing the size from the chunks
+ */
+BOOST_AUTO_TEST_CASE(HeaderFields)
+{
+  std::vector<uint8_t> chunk(10, 3); // NOLINT(build/unsigned)
+  ScatterGatherFragment sg_frag;
+  sg_frag.add_chunk(chunk.data(), chunk.size());
+
+  FragmentHeader header;
+  header.size = 1;
+  header.run_number = 5;
+  header.element_id = SourceID{ SourceID::Subsystem::kDetectorReadout, 6 };
+  sg_frag.set_header_fields(header);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_size(), sizeof(FragmentHeader) + 10);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_header().run_number, 5);
+  BOOST_REQUIRE_EQUAL(sg_frag.get_header().element_id, header.element_id);
+
+  sg_frag.set_type(FragmentType::kWIB);
+  sg_frag.set_window_begin(100);
+  sg_frag.set_window_end(200);
+  auto contiguous = sg_frag.to_fragment();
+  BOOST_REQUIRE(contiguous.get_fragment_type() == FragmentType::kWIB);
+  BOOST_REQUIRE_EQUAL(contiguous.get_window_begin(), 100);
+  BOOST_REQUIRE_EQUAL(contiguous.get_window_end(), 200);
+  BOOST_REQUIRE_EQUAL(contiguous.get_size(), sg_frag.get_size());
+}
+
+/**
+ * @brief Check that moving keeps chunks and header consistent
+ */
+BOOST_AUTO_TEST_CASE(MoveSemantics)
+{
+  std::vector<uint8_t> chunk(10, 3); // NOLINT(build/unsigned)
+  ScatterGatherFragment sg_frag;
+  sg_frag.set_run_number(11);
+  sg_frag.add_chunk(chunk.data(), chunk.size(), Fragment::BufferAdoptionMode::kCopyFromBuffer);
+
+  ScatterGatherFragment moved(std::move(sg_frag));
+  BOOST_REQUIRE_EQUAL(moved.get_size(), sizeof(FragmentHeader) + 10);
+  BOOST_REQUIRE_EQUAL(moved.get_iovecs().front().iov_base, &moved.get_header());
+  BOOST_REQUIRE_EQUAL(moved.get_header().run_number, 11);
+
+  ScatterGatherFragment assigned;
+  assigned = std::move(moved);
+  BOOST_REQUIRE_EQUAL(assigned.get_num_chunks(), 1);
+  BOOST_REQUIRE_EQUAL(assigned.get_iovecs().front().iov_base, &assigned.get_header());
+  BOOST_REQUIRE_EQUAL(*static_cast<uint8_t*>(assigned.get_data()), 3); // NOLINT(build/unsigned)
+}
+
+BOOST_AUTO_TEST_SUITE_END()
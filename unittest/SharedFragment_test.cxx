@@ -0,0 +1,177 @@
+/**
+ * @file SharedFragment_test.cxx SharedFragment class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/SharedFragment.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE SharedFragment_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief memory_resource which counts the allocations and deallocations it serves
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  size_t allocations{ 0 };
+  size_t deallocations{ 0 };
+  size_t bytes_outstanding{ 0 };
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    ++allocations;
+    bytes_outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override
+  {
+    ++deallocations;
+    bytes_outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(SharedFragment_test)
+
+/**
+ * @brief Check that the handle gives read-only access only
+ */
+BOOST_AUTO_TEST_CASE(ReadOnlyAccess)
+{
+  BOOST_REQUIRE((std::is_same_v<decltype(*std::declval<SharedFragment>()), const Fragment&>));
+  BOOST_REQUIRE((std::is_same_v<decltype(std::declval<SharedFragment>().get()), const Fragment*>));
+  BOOST_REQUIRE(std::is_nothrow_copy_constructible_v<SharedFragment>);
+  BOOST_REQUIRE(std::is_nothrow_move_constructible_v<SharedFragment>);
+}
+
+/**
+ * @brief Check constructing a SharedFragment from a Fragment and from a header and payload pieces
+ */
+BOOST_AUTO_TEST_CASE(Construction)
+{
+  std::vector<char> payload(1000);
+  for (size_t i = 0; i < payload.size(); ++i)
+    payload[i] = static_cast<char>(i);
+  Fragment fragment(payload.data(), payload.size());
+  fragment.set_run_number(7);
+  fragment.set_element_id(SourceID(SourceID::Subsystem::kDetectorReadout, 3));
+
+  SharedFragment shared(fragment);
+  BOOST_REQUIRE(shared);
+  BOOST_REQUIRE_EQUAL(shared.use_count(), 1);
+  BOOST_REQUIRE(shared->get_storage_location() != fragment.get_storage_location());
+  BOOST_REQUIRE(!shared->owns_buffer());
+  BOOST_REQUIRE_EQUAL(shared->get_size(), fragment.get_size());
+  BOOST_REQUIRE_EQUAL(std::memcmp(shared->get_storage_location(), fragment.get_storage_location(), fragment.get_size()),
+                      0);
+  BOOST_REQUIRE_EQUAL(reinterpret_cast<uintptr_t>(shared->get_storage_location()) % alignof(std::max_align_t), 0);
+
+  FragmentHeader header = fragment.get_header();
+  header.size = 0;
+  std::vector<std::pair<void*, size_t>> pieces{ { payload.data(), 600 }, { payload.data() + 600, 400 } };
+  SharedFragment from_pieces(header, pieces);
+  BOOST_REQUIRE_EQUAL(from_pieces->get_size(), fragment.get_size());
+  BOOST_REQUIRE_EQUAL(from_pieces->get_run_number(), 7);
+  BOOST_REQUIRE_EQUAL(from_pieces->get_element_id(), fragment.get_element_id());
+  BOOST_REQUIRE_EQUAL(std::memcmp(from_pieces->get_data(), payload.data(), payload.size()), 0);
+
+  pieces.emplace_back(nullptr, 10);
+  BOOST_REQUIRE_THROW(SharedFragment(header, pieces), std::invalid_argument);
+
+  SharedFragment empty;
+  BOOST_REQUIRE(!empty);
+  BOOST_REQUIRE(empty.get() == nullptr);
+  BOOST_REQUIRE_EQUAL(empty.use_count(), 0);
+}
+
+/**
+ * @brief Check that copies share the array, which is released with the last handle
+ */
+BOOST_AUTO_TEST_CASE(SharedOwnership)
+{
+  CountingResource resource;
+  std::vector<char> payload(100, 'x');
+  {
+    SharedFragment shared(Fragment(payload.data(), payload.size()), &resource);
+    BOOST_REQUIRE_EQUAL(resource.allocations, 1);
+
+    SharedFragment copy(shared);
+    SharedFragment assigned;
+    assigned = copy;
+    BOOST_REQUIRE_EQUAL(shared.use_count(), 3);
+    BOOST_REQUIRE(copy.get() == shared.get());
+    BOOST_REQUIRE(assigned->get_storage_location() == shared->get_storage_location());
+
+    SharedFragment moved(std::move(copy));
+    BOOST_REQUIRE(!copy); // NOLINT(bugprone-use-after-move)
+    BOOST_REQUIRE_EQUAL(shared.use_count(), 3);
+
+    assigned = assigned; // NOLINT
+    BOOST_REQUIRE_EQUAL(shared.use_count(), 3);
+
+    shared.reset();
+    moved.reset();
+    BOOST_REQUIRE_EQUAL(assigned.use_count(), 1);
+    BOOST_REQUIRE_EQUAL(resource.deallocations, 0);
+    BOOST_REQUIRE_EQUAL(assigned->get_data_size(), payload.size());
+  }
+  BOOST_REQUIRE_EQUAL(resource.allocations, 1);
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 1);
+  BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, 0);
+}
+
+/**
+ * @brief Check copying and releasing handles from several threads
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentHandles)
+{
+  CountingResource resource;
+  std::vector<char> payload(100, 'x');
+  {
+    SharedFragment shared(Fragment(payload.data(), payload.size()), &resource);
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < 8; ++t)
+      consumers.emplace_back([shared]() {
+        for (int i = 0; i < 10000; ++i) {
+          SharedFragment copy(shared);
+          SharedFragment other = copy;
+          other.reset();
+        }
+      });
+    for (auto& consumer : consumers)
+      consumer.join();
+    BOOST_REQUIRE_EQUAL(shared.use_count(), 1);
+  }
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 1);
+
+  // The last handle may be released on any thread
+  SharedFragment shared(Fragment(payload.data(), payload.size()), &resource);
+  std::thread releaser([handle = std::move(shared)]() mutable { handle.reset(); });
+  releaser.join();
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 2);
+  BOOST_REQUIRE_EQUAL(resource.bytes_outstanding, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
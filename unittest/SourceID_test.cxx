@@ -16,9 +16,12 @@
 #include "boost/test/unit_test.hpp"
 
 #include <functional>
+#include <iomanip>
 #include <limits>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <unordered_set>
 #include <vector>
 
 using namespace dunedaq::daqdataformats;
@@ -43,6 +46,20 @@ BOOST_AUTO_TEST_CASE(SubsystemConversion)
   BOOST_REQUIRE_EQUAL(SourceID::string_to_subsystem("TR_Builder"), SourceID::Subsystem::kTRBuilder);
 }
 
+/**
+ * @brief Test the allocation-free Subsystem name conversions
+ */
+BOOST_AUTO_TEST_CASE(SubsystemName)
+{
+  static_assert(SourceID::get_subsystem_name(SourceID::Subsystem::kHwSignalsInterface) == "HW_Signals_Interface");
+  static_assert(SourceID::find_subsystem("TR_Builder") == SourceID::Subsystem::kTRBuilder);
+
+  BOOST_REQUIRE_EQUAL(SourceID::get_subsystem_name(static_cast<SourceID::Subsystem>(100)), "Unknown");
+  BOOST_REQUIRE_EQUAL(SourceID::subsystem_to_string(static_cast<SourceID::Subsystem>(100)), "Unknown");
+  BOOST_REQUIRE_EQUAL(SourceID::find_subsystem("Triggers"), SourceID::Subsystem::kUnknown);
+  BOOST_REQUIRE_EQUAL(SourceID::string_to_subsystem("trigger"), SourceID::Subsystem::kUnknown);
+}
+
 /**
  * @brief Test that SourceID::operator<< functions as expected
  */
@@ -78,6 +95,73 @@ BOOST_AUTO_TEST_CASE(StreamOperator)
   BOOST_REQUIRE_EQUAL(cat, cat2);
 }
 
+/**
+ * @brief Test that to_chars writes the same text as operator<< and SourceID::to_string
+ */
+BOOST_AUTO_TEST_CASE(ToChars)
+{
+  char buffer[s_to_chars_max_size];
+  for (auto id : { SourceID::ID_t(0), SourceID::ID_t(42), SourceID::ID_t(0xABCDEF), SourceID::s_invalid_id }) {
+    for (auto subsystem : { SourceID::Subsystem::kUnknown,
+                            SourceID::Subsystem::kHwSignalsInterface,
+                            static_cast<SourceID::Subsystem>(77) }) {
+      SourceID source_id{ subsystem, id };
+
+      std::ostringstream ostr;
+      ostr << source_id;
+      auto result = to_chars(buffer, buffer + sizeof(buffer), source_id);
+      BOOST_REQUIRE(result.ec == std::errc());
+      BOOST_REQUIRE_EQUAL(std::string(buffer, result.ptr), ostr.str());
+
+      std::ostringstream name;
+      name << SourceID::subsystem_to_string(subsystem) << "_0x" << std::hex << std::setfill('0')
+           << std::setw(2 * sizeof(id)) << id;
+      result = source_id.to_string_chars(buffer, buffer + sizeof(buffer));
+      BOOST_REQUIRE(result.ec == std::errc());
+      BOOST_REQUIRE_EQUAL(std::string(buffer, result.ptr), name.str());
+      BOOST_REQUIRE_EQUAL(source_id.to_string(), name.str());
+    }
+  }
+
+  SourceID source_id{ SourceID::Subsystem::kTrigger, 0x2a };
+  BOOST_REQUIRE_EQUAL(source_id.to_string(), "Trigger_0x0000002a");
+  auto result = source_id.to_string_chars(buffer, buffer + 17);
+  BOOST_REQUIRE(result.ec == std::errc::value_too_large);
+  BOOST_REQUIRE(result.ptr == buffer + 17);
+}
+
+/**
+ * @brief Test that from_chars parses the text written by to_chars and rejects unknown subsystems
+ */
+BOOST_AUTO_TEST_CASE(FromChars)
+{
+  for (auto subsystem : { SourceID::Subsystem::kUnknown, SourceID::Subsystem::kTRBuilder }) {
+    SourceID source_id{ subsystem, 31415 };
+    char buffer[s_to_chars_max_size];
+    auto end = to_chars(buffer, buffer + sizeof(buffer), source_id).ptr;
+
+    SourceID parsed;
+    parsed.version = 9;
+    auto result = from_chars(buffer, end, parsed);
+    BOOST_REQUIRE(result.ec == std::errc());
+    BOOST_REQUIRE(result.ptr == end);
+    BOOST_REQUIRE_EQUAL(parsed, source_id);
+    BOOST_REQUIRE_EQUAL(parsed.version, 9);
+  }
+
+  std::string text = "subsystem: Readout id: 1";
+  SourceID parsed;
+  auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+  BOOST_REQUIRE(result.ec == std::errc::invalid_argument);
+  BOOST_REQUIRE(result.ptr == text.data() + 11);
+  BOOST_REQUIRE_EQUAL(parsed, SourceID());
+
+  text = "subsystem: Trigger id: 4294967296";
+  result = from_chars(text.data(), text.data() + text.size(), parsed);
+  BOOST_REQUIRE(result.ec == std::errc::result_out_of_range);
+  BOOST_REQUIRE(result.ptr == text.data() + 23);
+}
+
 /**
  * @brief Test that SourceID::operator< functions as expected
  */
@@ -93,6 +177,78 @@ BOOST_AUTO_TEST_CASE(ComparisonOperator)
   BOOST_REQUIRE(!(greater < lesser));
 }
 
+BOOST_AUTO_TEST_CASE(PackedKey)
+{
+  SourceID source_id{ SourceID::Subsystem::kTrigger, 0x12345678 };
+  BOOST_REQUIRE_EQUAL(source_id.packed_key(), 0x0000000312345678ULL);
+
+  SourceID other_version = source_id;
+  other_version.version = 1;
+  BOOST_REQUIRE_EQUAL(other_version.packed_key(), source_id.packed_key());
+  BOOST_REQUIRE(SourceID(SourceID::Subsystem::kTrigger, 1).packed_key() !=
+                SourceID(SourceID::Subsystem::kDetectorReadout, 1).packed_key());
+}
+
+/**
+ * @brief Test that comparisons and hashing ignore the version and order by subsystem then id
+ */
+BOOST_AUTO_TEST_CASE(VersionIgnored)
+{
+  SourceID source_id{ SourceID::Subsystem::kTrigger, 7 };
+  SourceID other_version = source_id;
+  other_version.version = 42;
+
+  BOOST_REQUIRE(source_id == other_version);
+  BOOST_REQUIRE(!(source_id != other_version));
+  BOOST_REQUIRE(!(source_id < other_version) && !(other_version < source_id));
+  BOOST_REQUIRE_EQUAL(std::hash<SourceID>()(source_id), std::hash<SourceID>()(other_version));
+
+  // Subsystem takes precedence over id
+  BOOST_REQUIRE(SourceID(SourceID::Subsystem::kDetectorReadout, 1000) < SourceID(SourceID::Subsystem::kTrigger, 1));
+  BOOST_REQUIRE(SourceID(SourceID::Subsystem::kTrigger, 1) < SourceID(SourceID::Subsystem::kTrigger, 0xFFFFFFF0));
+
+  std::unordered_set<SourceID> set;
+  for (uint32_t id = 0; id < 1000; ++id) { // NOLINT(build/unsigned)
+    set.insert(SourceID(SourceID::Subsystem::kDetectorReadout, id));
+    set.insert(SourceID(SourceID::Subsystem::kTrigger, id));
+  }
+  BOOST_REQUIRE_EQUAL(set.size(), 2000);
+  BOOST_REQUIRE_EQUAL(set.count(other_version), 1);
+  BOOST_REQUIRE_EQUAL(set.count(SourceID(SourceID::Subsystem::kHwSignalsInterface, 7)), 0);
+}
+
+/**
+ * @brief Test match_any and find_match against every array length and match position
+ */
+BOOST_AUTO_TEST_CASE(BatchMatch)
+{
+  BOOST_REQUIRE(!match_any(SourceID(SourceID::Subsystem::kTrigger, 1), nullptr, 0));
+
+  for (size_t count = 1; count < 24; ++count) {
+    std::vector<SourceID> source_ids;
+    for (size_t i = 0; i < count; ++i) {
+      source_ids.emplace_back(SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(i));
+      source_ids.back().version = static_cast<SourceID::Version_t>(i);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      SourceID needle{ SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(i) };
+      BOOST_REQUIRE(match_any(needle, source_ids.data(), count));
+      BOOST_REQUIRE_EQUAL(find_match(needle, source_ids.data(), count), i);
+    }
+
+    // Same id in another subsystem, and an id past the end of the array
+    BOOST_REQUIRE(!match_any(SourceID(SourceID::Subsystem::kTrigger, 0), source_ids.data(), count));
+    SourceID missing{ SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(count) };
+    BOOST_REQUIRE_EQUAL(find_match(missing, source_ids.data(), count), count);
+  }
+
+  // The first occurrence is returned
+  std::vector<SourceID> duplicates(13, SourceID(SourceID::Subsystem::kTrigger, 5));
+  duplicates[0] = SourceID(SourceID::Subsystem::kTrigger, 4);
+  BOOST_REQUIRE_EQUAL(find_match(SourceID(SourceID::Subsystem::kTrigger, 5), duplicates.data(), duplicates.size()), 1);
+}
+
 BOOST_AUTO_TEST_CASE(Validity)
 {
   SourceID test;
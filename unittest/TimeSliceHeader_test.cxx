@@ -15,7 +15,11 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <cstring>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <system_error>
 #include <vector>
 
 using namespace dunedaq::daqdataformats;
@@ -52,4 +56,69 @@ BOOST_AUTO_TEST_CASE(StreamOperator)
   BOOST_REQUIRE_EQUAL(reconstituted_header.element_id.id, 55);
 }
 
+/**
+ * @brief Test that to_chars writes the same text as operator<<
+ */
+BOOST_AUTO_TEST_CASE(ToChars)
+{
+  TimeSliceHeader header;
+  header.timeslice_number = 0xFFFFFFFFFFFFFFFFULL;
+  header.run_number = 2;
+  header.element_id = SourceID(SourceID::Subsystem::kHwSignalsInterface, 55);
+
+  std::ostringstream ostr;
+  ostr << header;
+  std::string expected = ostr.str();
+
+  char buffer[s_to_chars_max_size];
+  auto result = to_chars(buffer, buffer + sizeof(buffer), header);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE_EQUAL(std::string(buffer, result.ptr), expected);
+
+  // Exactly enough room, then one byte short
+  result = to_chars(buffer, buffer + expected.size(), header);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE(result.ptr == buffer + expected.size());
+  result = to_chars(buffer, buffer + expected.size() - 1, header);
+  BOOST_REQUIRE(result.ec == std::errc::value_too_large);
+  BOOST_REQUIRE(result.ptr == buffer + expected.size() - 1);
+}
+
+/**
+ * @brief Test that from_chars parses the text written by to_chars, and reports where invalid text starts
+ */
+BOOST_AUTO_TEST_CASE(FromChars)
+{
+  TimeSliceHeader header;
+  header.timeslice_number = 5;
+  header.run_number = 2;
+  header.element_id = SourceID(SourceID::Subsystem::kHwSignalsInterface, 55);
+
+  char buffer[s_to_chars_max_size];
+  auto end = to_chars(buffer, buffer + sizeof(buffer), header).ptr;
+
+  TimeSliceHeader parsed;
+  auto result = from_chars(buffer, end, parsed);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE(result.ptr == end);
+  BOOST_REQUIRE_EQUAL(std::memcmp(&parsed, &header, sizeof(TimeSliceHeader)), 0);
+
+  // Every prefix that stops before the last number is rejected, leaving the output untouched
+  TimeSliceHeader untouched;
+  TimeSliceHeader original = untouched;
+  auto last_number = end;
+  while (last_number[-1] >= '0' && last_number[-1] <= '9')
+    --last_number;
+  for (auto last = buffer; last < last_number; ++last)
+    BOOST_REQUIRE(from_chars(buffer, last, untouched).ec != std::errc());
+  BOOST_REQUIRE_EQUAL(std::memcmp(&untouched, &original, sizeof(TimeSliceHeader)), 0);
+
+  std::string text(buffer, end);
+  text.pop_back();
+  text += ")";
+  result = from_chars(text.data(), text.data() + text.size(), parsed);
+  BOOST_REQUIRE(result.ec == std::errc::invalid_argument);
+  BOOST_REQUIRE(result.ptr == text.data() + text.size() - 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -15,7 +15,11 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <cstring>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <system_error>
 #include <vector>
 
 using namespace dunedaq::daqdataformats;
@@ -66,4 +70,80 @@ BOOST_AUTO_TEST_CASE(StreamOperator)
   BOOST_REQUIRE_EQUAL(reconstituted_header.element_id.id, 99);
 }
 
+/**
+ * @brief Test that to_chars writes the same text as operator<<
+ */
+BOOST_AUTO_TEST_CASE(ToChars)
+{
+  TriggerRecordHeaderData header;
+  header.trigger_number = 0xFFFFFFFFFFFFFFFFULL;
+  header.run_number = 9;
+  header.trigger_timestamp = 1234567890123ULL;
+  header.trigger_type = 4;
+  header.error_bits = 0x80000001;
+  header.num_requested_components = 17;
+  header.sequence_number = 1;
+  header.max_sequence_number = 65535;
+  header.element_id = SourceID(SourceID::Subsystem::kTRBuilder, 0);
+
+  std::ostringstream ostr;
+  ostr << header;
+  std::string expected = ostr.str();
+
+  char buffer[s_to_chars_max_size];
+  auto result = to_chars(buffer, buffer + sizeof(buffer), header);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE_EQUAL(std::string(buffer, result.ptr), expected);
+
+  // Exactly enough room, then one byte short
+  result = to_chars(buffer, buffer + expected.size(), header);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE(result.ptr == buffer + expected.size());
+  result = to_chars(buffer, buffer + expected.size() - 1, header);
+  BOOST_REQUIRE(result.ec == std::errc::value_too_large);
+  BOOST_REQUIRE(result.ptr == buffer + expected.size() - 1);
+}
+
+/**
+ * @brief Test that from_chars parses the text written by to_chars, and reports where invalid text starts
+ */
+BOOST_AUTO_TEST_CASE(FromChars)
+{
+  TriggerRecordHeaderData header;
+  header.trigger_number = 12;
+  header.run_number = 9;
+  header.trigger_timestamp = 1234567890123ULL;
+  header.trigger_type = 4;
+  header.num_requested_components = 17;
+  header.sequence_number = 1;
+  header.max_sequence_number = 2;
+  header.element_id = SourceID(SourceID::Subsystem::kTRBuilder, 3);
+
+  char buffer[s_to_chars_max_size];
+  auto end = to_chars(buffer, buffer + sizeof(buffer), header).ptr;
+
+  TriggerRecordHeaderData parsed;
+  auto result = from_chars(buffer, end, parsed);
+  BOOST_REQUIRE(result.ec == std::errc());
+  BOOST_REQUIRE(result.ptr == end);
+  BOOST_REQUIRE_EQUAL(std::memcmp(&parsed, &header, sizeof(TriggerRecordHeaderData)), 0);
+
+  // Every prefix that stops before the last number is rejected, leaving the output untouched
+  TriggerRecordHeaderData untouched;
+  TriggerRecordHeaderData original = untouched;
+  auto last_number = end;
+  while (last_number[-1] >= '0' && last_number[-1] <= '9')
+    --last_number;
+  for (auto last = buffer; last < last_number; ++last)
+    BOOST_REQUIRE(from_chars(buffer, last, untouched).ec != std::errc());
+  BOOST_REQUIRE_EQUAL(std::memcmp(&untouched, &original, sizeof(TriggerRecordHeaderData)), 0);
+
+  std::string text(buffer, end);
+  auto position = text.find("TR_Builder");
+  text.replace(position, 10, "TR_Builders");
+  result = from_chars(text.data(), text.data() + text.size(), parsed);
+  BOOST_REQUIRE(result.ec == std::errc::invalid_argument);
+  BOOST_REQUIRE(result.ptr == text.data() + position);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,16 +26,44 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <atomic>
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 using namespace dunedaq::daqdataformats;
 
+namespace {
+/**
+ * @brief memory_resource which counts the allocations and deallocations it serves
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  size_t allocations{ 0 };
+  size_t deallocations{ 0 };
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override
+  {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+} // namespace
+
 BOOST_AUTO_TEST_SUITE(TriggerRecordHeader_test)
 
 /**
@@ -180,6 +208,46 @@ BOOST_AUTO_TEST_CASE(MoveAssignment)
   BOOST_REQUIRE_EQUAL(another_header.get_num_requested_components(), 2);
 }
 
+/**
+ * @brief Check that TriggerRecordHeaders allocate from, and return their buffer to, a user-supplied memory_resource
+ */
+BOOST_AUTO_TEST_CASE(MemoryResource)
+{
+  std::vector<ComponentRequest> components;
+  components.emplace_back(SourceID{ SourceID::Subsystem::kDetectorReadout, 12 }, 3, 4);
+  components.emplace_back(SourceID{ SourceID::Subsystem::kDetectorReadout, 56 }, 7, 8);
+
+  CountingResource resource;
+  {
+    TriggerRecordHeader header(components, &resource);
+    header.set_run_number(9);
+    BOOST_REQUIRE_EQUAL(header.get_memory_resource(), &resource);
+    BOOST_REQUIRE_EQUAL(resource.allocations, 1);
+
+    // Copies stay in the memory_resource of the original
+    TriggerRecordHeader copy_header(header);
+    BOOST_REQUIRE_EQUAL(copy_header.get_memory_resource(), &resource);
+    BOOST_REQUIRE_EQUAL(copy_header.get_run_number(), 9);
+    BOOST_REQUIRE_EQUAL(resource.allocations, 2);
+
+    // Copy assignment re-allocates from the destination's memory_resource
+    TriggerRecordHeader malloc_header(components);
+    malloc_header = header;
+    BOOST_REQUIRE(malloc_header.get_memory_resource() == nullptr);
+    BOOST_REQUIRE_EQUAL(malloc_header.get_run_number(), 9);
+    BOOST_REQUIRE_EQUAL(resource.allocations, 2);
+
+    copy_header = malloc_header;
+    BOOST_REQUIRE_EQUAL(resource.allocations, 3);
+    BOOST_REQUIRE_EQUAL(resource.deallocations, 1);
+
+    TriggerRecordHeader buffer_copy(const_cast<void*>(header.get_storage_location()), true, &resource); // NOLINT
+    BOOST_REQUIRE_EQUAL(buffer_copy.at(1).window_begin, 7);
+    BOOST_REQUIRE_EQUAL(resource.allocations, 4);
+  }
+  BOOST_REQUIRE_EQUAL(resource.deallocations, 4);
+}
+
 BOOST_AUTO_TEST_CASE(BadConstructors)
 {
   TriggerRecordHeaderData header_data;
@@ -284,6 +352,70 @@ BOOST_AUTO_TEST_CASE(HeaderFields)
   BOOST_REQUIRE_EQUAL(header_ptr->error_bits, 0x11111111);
 }
 
+/**
+ * @brief Test SourceID lookup, with and without the hash index
+ */
+BOOST_AUTO_TEST_CASE(FindComponent)
+{
+  for (size_t num_components : { size_t(5), size_t(2000) }) {
+    std::vector<ComponentRequest> components;
+    for (size_t idx = 0; idx < num_components; ++idx) {
+      components.emplace_back();
+      auto subsystem = idx % 2 ? SourceID::Subsystem::kDetectorReadout : SourceID::Subsystem::kTrigger;
+      components.back().component = { subsystem, static_cast<SourceID::ID_t>(idx / 2) };
+      components.back().window_begin = idx;
+    }
+    // Duplicated SourceID: the first ComponentRequest wins
+    components.push_back(components[3]);
+    components.back().window_begin = 12345;
+
+    TriggerRecordHeader header(components);
+    for (size_t idx = 0; idx < num_components; ++idx) {
+      auto component = header.find_component(components[idx].component);
+      BOOST_REQUIRE(component != nullptr);
+      BOOST_REQUIRE_EQUAL(component->window_begin, idx);
+    }
+    BOOST_REQUIRE(header.find_component({ SourceID::Subsystem::kTRBuilder, 0 }) == nullptr);
+    BOOST_REQUIRE(header.find_component({ SourceID::Subsystem::kTrigger, 1000000 }) == nullptr);
+    BOOST_REQUIRE_THROW(header.get_component_for_source_id({ SourceID::Subsystem::kTRBuilder, 0 }),
+                        std::invalid_argument);
+
+    // Modifying a SourceID through operator[] is seen by later lookups
+    header[1].component = { SourceID::Subsystem::kTRBuilder, 7 };
+    BOOST_REQUIRE(header.find_component(components[1].component) == nullptr);
+    BOOST_REQUIRE_EQUAL(header.find_component({ SourceID::Subsystem::kTRBuilder, 7 })->window_begin, 1);
+
+    // Copies and moved-to headers answer lookups too
+    TriggerRecordHeader copy(header);
+    BOOST_REQUIRE_EQUAL(copy.find_component(components[2].component)->window_begin, 2);
+    TriggerRecordHeader moved(std::move(header));
+    BOOST_REQUIRE_EQUAL(moved.find_component(components[2].component)->window_begin, 2);
+  }
+}
+
+/**
+ * @brief Test that concurrent lookups share one index
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentFindComponent)
+{
+  std::vector<ComponentRequest> components(1000);
+  for (size_t idx = 0; idx < components.size(); ++idx)
+    components[idx].component = { SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(idx) };
+  const TriggerRecordHeader header(components);
+
+  std::atomic<size_t> found{ 0 };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&]() {
+      for (auto const& component : components)
+        if (header.find_component(component.component) != nullptr)
+          ++found;
+    });
+  for (auto& thread : threads)
+    thread.join();
+  BOOST_REQUIRE_EQUAL(found.load(), 4 * components.size());
+}
+
 BOOST_AUTO_TEST_CASE(StreamOperator)
 {
   std::vector<ComponentRequest> components;
@@ -0,0 +1,158 @@
+/**
+ * @file TriggerRecordView_test.cxx TriggerRecord serialization and TriggerRecordView class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/TriggerRecordView.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE TriggerRecordView_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief Build a TriggerRecord with two components and Fragments of odd sizes
+ */
+std::unique_ptr<TriggerRecord>
+make_record()
+{
+  std::vector<ComponentRequest> components;
+  components.emplace_back(SourceID{ SourceID::Subsystem::kDetectorReadout, 12 }, 3, 4);
+  components.emplace_back(SourceID{ SourceID::Subsystem::kDetectorReadout, 56 }, 7, 8);
+
+  auto record = std::make_unique<TriggerRecord>(components);
+  record->get_header_ref().set_trigger_number(1234);
+  record->get_header_ref().set_run_number(5);
+
+  for (size_t size : { 13, 1, 101 }) {
+    std::vector<uint8_t> payload(size); // NOLINT(build/unsigned)
+    std::iota(payload.begin(), payload.end(), size);
+    auto frag = std::make_unique<Fragment>(std::vector<std::pair<void*, size_t>>{ { payload.data(), size } });
+    frag->set_element_id(SourceID{ SourceID::Subsystem::kDetectorReadout, static_cast<SourceID::ID_t>(size) });
+    record->add_fragment(std::move(frag));
+  }
+  return record;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(TriggerRecordView_test)
+
+/**
+ * @brief Check that a serialized TriggerRecord is read back unchanged
+ */
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  auto record = make_record();
+  auto size = record->serialized_size();
+  BOOST_REQUIRE(size >= record->get_total_size_bytes());
+
+  std::vector<uint64_t> storage(size / sizeof(uint64_t) + 1); // NOLINT(build/unsigned)
+  BOOST_REQUIRE_EQUAL(record->serialize_into(storage.data(), size), size);
+
+  TriggerRecordView view(storage.data(), size);
+  BOOST_REQUIRE_EQUAL(view.get_size(), size);
+  BOOST_REQUIRE_EQUAL(view.get_header_data().trigger_number, 1234);
+  BOOST_REQUIRE_EQUAL(view.get_header().get_num_requested_components(), 2);
+  BOOST_REQUIRE_EQUAL(view.get_header().at(1).window_begin, 7);
+  BOOST_REQUIRE_EQUAL(view.get_num_fragments(), record->get_fragments_ref().size());
+
+  for (size_t idx = 0; idx < view.get_num_fragments(); ++idx) {
+    auto const& original = record->get_fragments_ref()[idx];
+    auto fragment = view.get_fragment(idx);
+    BOOST_REQUIRE_EQUAL(reinterpret_cast<uintptr_t>(fragment.get_storage_location()) % // NOLINT
+                          TriggerRecord::s_serialized_alignment,
+                        0);
+    BOOST_REQUIRE_EQUAL(fragment.get_size(), original->get_size());
+    BOOST_REQUIRE_EQUAL(view.get_fragment_header(idx).element_id.id, original->get_element_id().id);
+    BOOST_REQUIRE_EQUAL(
+      std::memcmp(fragment.get_storage_location(), original->get_storage_location(), original->get_size()), 0);
+  }
+  BOOST_REQUIRE_THROW(view.get_fragment(view.get_num_fragments()), std::range_error);
+
+  auto copy = view.make_trigger_record();
+  BOOST_REQUIRE_EQUAL(copy->get_total_size_bytes(), record->get_total_size_bytes());
+  BOOST_REQUIRE_EQUAL(copy->get_header_ref().get_run_number(), 5);
+  BOOST_REQUIRE(copy->get_header_ref().get_storage_location() != storage.data());
+
+  auto in_place = view.make_trigger_record(false);
+  BOOST_REQUIRE_EQUAL(in_place->get_header_ref().get_storage_location(), storage.data());
+  BOOST_REQUIRE_EQUAL(in_place->get_fragments_ref()[2]->get_storage_location(),
+                      view.get_fragment(2).get_storage_location());
+}
+
+/**
+ * @brief Check serialization of a TriggerRecord without Fragments and into a too-small buffer
+ */
+BOOST_AUTO_TEST_CASE(EdgeCases)
+{
+  TriggerRecord empty(std::vector<ComponentRequest>{});
+  std::vector<uint64_t> storage(empty.serialized_size() / sizeof(uint64_t)); // NOLINT(build/unsigned)
+  BOOST_REQUIRE_EQUAL(empty.serialized_size(), sizeof(TriggerRecordHeaderData) + sizeof(uint64_t));
+  empty.serialize_into(storage.data(), empty.serialized_size());
+  TriggerRecordView view(storage.data(), empty.serialized_size());
+  BOOST_REQUIRE_EQUAL(view.get_num_fragments(), 0);
+
+  auto record = make_record();
+  std::vector<uint8_t> small(record->serialized_size() - 1); // NOLINT(build/unsigned)
+  BOOST_REQUIRE_THROW(record->serialize_into(small.data(), small.size()), std::length_error);
+}
+
+/**
+ * @brief Check that corrupted or truncated images are rejected
+ */
+BOOST_AUTO_TEST_CASE(Validation)
+{
+  auto record = make_record();
+  auto size = record->serialized_size();
+  std::vector<uint64_t> storage(size / sizeof(uint64_t) + 1); // NOLINT(build/unsigned)
+  record->serialize_into(storage.data(), size);
+  auto image = reinterpret_cast<uint8_t*>(storage.data()); // NOLINT
+
+  BOOST_REQUIRE_THROW(TriggerRecordView(image, size - 1), std::length_error);
+  BOOST_REQUIRE_THROW(TriggerRecordView(image, 16), std::length_error);
+
+  TriggerRecordView view(image, size);
+  auto fragment_offset =
+    static_cast<size_t>(static_cast<const uint8_t*>(view.get_fragment(1).get_storage_location()) - image); // NOLINT
+
+  image[fragment_offset] ^= 0xFF;
+  BOOST_REQUIRE_THROW(TriggerRecordView(image, size), std::invalid_argument);
+  image[fragment_offset] ^= 0xFF;
+
+  image[0] ^= 0xFF;
+  BOOST_REQUIRE_THROW(TriggerRecordView(image, size), std::invalid_argument);
+  image[0] ^= 0xFF;
+
+  // Fragment offsets must keep the Fragment headers aligned
+  auto table_offset = record->get_header_ref().get_total_size_bytes();
+  uint64_t offset_entry; // NOLINT(build/unsigned)
+  std::memcpy(&offset_entry, image + table_offset + 2 * sizeof(uint64_t), sizeof(offset_entry));
+  uint64_t misaligned_entry = offset_entry + 1; // NOLINT(build/unsigned)
+  std::memcpy(image + table_offset + 2 * sizeof(uint64_t), &misaligned_entry, sizeof(misaligned_entry));
+  BOOST_REQUIRE_THROW(TriggerRecordView(image, size), std::invalid_argument);
+  std::memcpy(image + table_offset + 2 * sizeof(uint64_t), &offset_entry, sizeof(offset_entry));
+
+  std::memmove(image + 1, image, size);
+  BOOST_REQUIRE_THROW(TriggerRecordView(image + 1, size), std::invalid_argument);
+  std::memmove(image, image + 1, size);
+  BOOST_REQUIRE_NO_THROW(TriggerRecordView(image, size));
+
+  uint64_t huge_count = 1ULL << 60; // NOLINT(build/unsigned)
+  std::memcpy(image + table_offset, &huge_count, sizeof(huge_count));
+  BOOST_REQUIRE_THROW(TriggerRecordView(image, size), std::length_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
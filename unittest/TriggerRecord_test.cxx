@@ -15,8 +15,12 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -77,6 +81,25 @@ BOOST_AUTO_TEST_CASE(HeaderConstructor)
   delete header; // NOLINT(build/raw_ownership)
 }
 
+/**
+ * @brief Check that a temporary TriggerRecordHeader is copied, unless the AdoptHeader constructor is used
+ */
+BOOST_AUTO_TEST_CASE(AdoptHeader)
+{
+  TriggerRecordHeader header(std::vector<ComponentRequest>(2));
+  header.set_trigger_number(12);
+  std::vector<uint8_t> buffer(header.get_total_size_bytes()); // NOLINT(build/unsigned)
+  std::memcpy(buffer.data(), header.get_storage_location(), buffer.size());
+
+  TriggerRecord copied(TriggerRecordHeader(buffer.data(), false));
+  BOOST_REQUIRE(copied.get_header_ref().get_storage_location() != buffer.data());
+  BOOST_REQUIRE_EQUAL(copied.get_header_ref().get_trigger_number(), 12);
+
+  TriggerRecord adopted(TriggerRecord::s_adopt_header, TriggerRecordHeader(buffer.data(), false));
+  BOOST_REQUIRE_EQUAL(adopted.get_header_ref().get_storage_location(), buffer.data());
+  BOOST_REQUIRE_EQUAL(adopted.get_header_ref().get_num_requested_components(), 2);
+}
+
 /**
  * @brief Test TR move constroctor
  */
@@ -168,4 +191,104 @@ BOOST_AUTO_TEST_CASE(FragmentManipulation)
   BOOST_REQUIRE_EQUAL(record.get_fragments_ref().size(), 0);
 }
 
+/**
+ * @brief Test SourceID-indexed Fragment access
+ */
+BOOST_AUTO_TEST_CASE(FragmentLookup)
+{
+  TriggerRecord record(std::vector<ComponentRequest>{});
+  BOOST_REQUIRE(record.find_fragment({ SourceID::Subsystem::kDetectorReadout, 1 }) == nullptr);
+  BOOST_REQUIRE(record.fragments_for_subsystem(SourceID::Subsystem::kDetectorReadout).empty());
+
+  std::vector<std::unique_ptr<Fragment>> fragments;
+  for (SourceID::ID_t id : { 30, 10, 20 }) {
+    for (auto subsystem : { SourceID::Subsystem::kTrigger, SourceID::Subsystem::kDetectorReadout }) {
+      auto fragment = std::make_unique<Fragment>(std::vector<std::pair<void*, size_t>>());
+      fragment->set_element_id({ subsystem, id });
+      fragment->set_sequence_number(static_cast<sequence_number_t>(fragments.size()));
+      fragments.push_back(std::move(fragment));
+    }
+  }
+  record.set_fragments(std::move(fragments));
+
+  auto fragment = record.find_fragment({ SourceID::Subsystem::kDetectorReadout, 20 });
+  BOOST_REQUIRE(fragment != nullptr);
+  BOOST_REQUIRE_EQUAL(fragment->get_sequence_number(), 5);
+  BOOST_REQUIRE(record.find_fragment({ SourceID::Subsystem::kDetectorReadout, 40 }) == nullptr);
+
+  auto readout = record.fragments_for_subsystem(SourceID::Subsystem::kDetectorReadout);
+  BOOST_REQUIRE_EQUAL(readout.size(), 3);
+  BOOST_REQUIRE_EQUAL(readout[0]->get_element_id().id, 10);
+  BOOST_REQUIRE_EQUAL(readout[2]->get_element_id().id, 30);
+  for (auto frag : readout)
+    BOOST_REQUIRE(frag->get_element_id().subsystem == SourceID::Subsystem::kDetectorReadout);
+  BOOST_REQUIRE(record.fragments_for_subsystem(SourceID::Subsystem::kTRBuilder).empty());
+
+  // The index follows add_fragment, keeping the first Fragment of duplicated SourceIDs
+  auto duplicate = std::make_unique<Fragment>(std::vector<std::pair<void*, size_t>>());
+  duplicate->set_element_id({ SourceID::Subsystem::kDetectorReadout, 20 });
+  duplicate->set_sequence_number(100);
+  record.add_fragment(std::move(duplicate));
+  auto added = std::make_unique<Fragment>(std::vector<std::pair<void*, size_t>>());
+  added->set_element_id({ SourceID::Subsystem::kTRBuilder, 1 });
+  record.add_fragment(std::move(added));
+  BOOST_REQUIRE_EQUAL(record.find_fragment({ SourceID::Subsystem::kDetectorReadout, 20 })->get_sequence_number(), 5);
+  BOOST_REQUIRE_EQUAL(record.fragments_for_subsystem(SourceID::Subsystem::kDetectorReadout).size(), 4);
+  BOOST_REQUIRE_EQUAL(record.fragments_for_subsystem(SourceID::Subsystem::kTRBuilder).size(), 1);
+
+  // Modifications through get_fragments_ref are seen after reindex_fragments, and the index moves with the
+  // TriggerRecord
+  auto range = record.fragments_for_subsystem(SourceID::Subsystem::kDetectorReadout);
+  record.get_fragments_ref().front()->set_element_id({ SourceID::Subsystem::kTRBuilder, 2 });
+  BOOST_REQUIRE_EQUAL(range.size(), 4);
+  record.reindex_fragments();
+  TriggerRecord moved(std::move(record));
+  BOOST_REQUIRE_EQUAL(moved.fragments_for_subsystem(SourceID::Subsystem::kTRBuilder).size(), 2);
+  BOOST_REQUIRE(moved.find_fragment({ SourceID::Subsystem::kTrigger, 30 }) == nullptr);
+}
+
+/**
+ * @brief Check that the index is updated in place as Fragments are added, in and out of id order
+ */
+BOOST_AUTO_TEST_CASE(IncrementalFragmentIndex)
+{
+  TriggerRecord record(std::vector<ComponentRequest>{});
+  const SourceID::ID_t num_links = 1000;
+  for (SourceID::ID_t i = 0; i < num_links; ++i) {
+    // Ids are added in order, except for every tenth one, which comes before all the others
+    auto id = i % 10 == 0 ? num_links - i : num_links + i;
+    auto fragment = std::make_unique<Fragment>(std::vector<std::pair<void*, size_t>>());
+    fragment->set_element_id({ SourceID::Subsystem::kDetectorReadout, id });
+    fragment->set_sequence_number(i);
+    record.add_fragment(std::move(fragment));
+    BOOST_REQUIRE(record.find_fragment({ SourceID::Subsystem::kDetectorReadout, id }) ==
+                  record.get_fragments_ref().back().get());
+  }
+  record.add_fragment(nullptr);
+
+  auto readout = record.fragments_for_subsystem(SourceID::Subsystem::kDetectorReadout);
+  BOOST_REQUIRE_EQUAL(readout.size(), num_links);
+  BOOST_REQUIRE(std::is_sorted(readout.begin(), readout.end(), [](auto const& lhs, auto const& rhs) {
+    return lhs->get_element_id() < rhs->get_element_id();
+  }));
+  BOOST_REQUIRE_EQUAL(record.find_fragment({ SourceID::Subsystem::kDetectorReadout, 2 * num_links - 1 })
+                        ->get_sequence_number(),
+                      num_links - 1);
+
+  // Lookups only read the index, also while other threads read the Fragments vector
+  std::atomic<size_t> misses{ 0 };
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t)
+    readers.emplace_back([&]() {
+      for (SourceID::ID_t i = 1; i < num_links; ++i)
+        if (record.find_fragment({ SourceID::Subsystem::kDetectorReadout, num_links + i }) == nullptr &&
+            i % 10 != 0)
+          ++misses;
+      misses += record.get_fragments_ref().size() - (num_links + 1);
+    });
+  for (auto& reader : readers)
+    reader.join();
+  BOOST_REQUIRE_EQUAL(misses.load(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
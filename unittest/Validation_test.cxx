@@ -0,0 +1,209 @@
+/**
+ * @file Validation_test.cxx Header validation Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/TriggerRecordHeader.hpp"
+#include "daqdataformats/Validation.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE Validation_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+
+FragmentHeader
+make_valid_header()
+{
+  FragmentHeader header;
+  header.size = sizeof(FragmentHeader) + 100;
+  header.window_begin = 1000;
+  header.window_end = 2000;
+  return header;
+}
+
+/**
+ * @brief Break header i in one of several ways, or leave it valid
+ */
+FragmentHeader
+make_header(size_t i)
+{
+  auto header = make_valid_header();
+  switch (i % 7) {
+    case 1:
+      header.fragment_header_marker = 0xDEADBEEF;
+      break;
+    case 2:
+      header.version = FragmentHeader::s_fragment_header_version - 1;
+      break;
+    case 3:
+      header.size = sizeof(FragmentHeader) - 1;
+      break;
+    case 4:
+      header.window_begin = header.window_end + 1;
+      break;
+    case 5:
+      // Values with the top bit set, which a signed comparison would get wrong
+      header.size = ~fragment_size_t(0);
+      header.window_begin = ~timestamp_t(0) - 1;
+      header.window_end = ~timestamp_t(0);
+      break;
+    default:
+      break;
+  }
+  return header;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Validation_test)
+
+/**
+ * @brief Check each failure of a FragmentHeader
+ */
+BOOST_AUTO_TEST_CASE(FragmentHeaderValidation)
+{
+  auto header = make_valid_header();
+  BOOST_REQUIRE(validate(header).none());
+  BOOST_REQUIRE(validate(header, header.size).none());
+  BOOST_REQUIRE(has_failure(validate(header, header.size - 1), ValidationFailure::kSizeExceedsBuffer));
+
+  for (size_t i = 1; i < 5; ++i) {
+    auto result = validate(make_header(i));
+    BOOST_REQUIRE_EQUAL(result.count(), 1);
+  }
+  BOOST_REQUIRE(has_failure(validate(make_header(1)), ValidationFailure::kBadMarker));
+  BOOST_REQUIRE(has_failure(validate(make_header(2)), ValidationFailure::kBadVersion));
+  BOOST_REQUIRE(has_failure(validate(make_header(3)), ValidationFailure::kSizeTooSmall));
+  BOOST_REQUIRE(has_failure(validate(make_header(4)), ValidationFailure::kReversedWindow));
+  BOOST_REQUIRE(validate(make_header(5)).none());
+}
+
+/**
+ * @brief Check the TriggerRecordHeaderData, TimeSliceHeader, ComponentRequest and SourceID checks
+ */
+BOOST_AUTO_TEST_CASE(OtherHeaderValidation)
+{
+  TriggerRecordHeaderData record_header;
+  record_header.num_requested_components = 3;
+  auto record_size = sizeof(TriggerRecordHeaderData) + 3 * sizeof(ComponentRequest);
+  BOOST_REQUIRE(validate(record_header, record_size).none());
+  BOOST_REQUIRE(has_failure(validate(record_header, record_size - 1), ValidationFailure::kSizeExceedsBuffer));
+  record_header.num_requested_components = TriggerRecordHeaderData::s_invalid_number_components;
+  BOOST_REQUIRE(has_failure(validate(record_header, record_size), ValidationFailure::kSizeExceedsBuffer));
+  record_header.trigger_record_header_marker = 0;
+  BOOST_REQUIRE(has_failure(validate(record_header), ValidationFailure::kBadMarker));
+
+  TimeSliceHeader slice_header;
+  BOOST_REQUIRE(validate(slice_header).none());
+  slice_header.version = 0;
+  BOOST_REQUIRE(has_failure(validate(slice_header), ValidationFailure::kBadVersion));
+
+  ComponentRequest request(SourceID(SourceID::Subsystem::kDetectorReadout, 1), 10, 20);
+  BOOST_REQUIRE(validate(request).none());
+  request.window_begin = 30;
+  BOOST_REQUIRE(has_failure(validate(request), ValidationFailure::kReversedWindow));
+  request.window_begin = 10;
+  request.component.version = 1;
+  BOOST_REQUIRE(has_failure(validate(request), ValidationFailure::kBadVersion));
+  BOOST_REQUIRE(has_failure(validate(request.component), ValidationFailure::kBadVersion));
+}
+
+/**
+ * @brief Check validating headers in raw, unaligned buffers
+ */
+BOOST_AUTO_TEST_CASE(BufferValidation)
+{
+  std::vector<ComponentRequest> components(4, ComponentRequest(SourceID(SourceID::Subsystem::kTrigger, 2), 1, 2));
+  TriggerRecordHeader record_header(components);
+  auto size = record_header.get_total_size_bytes();
+  std::vector<char> buffer(size + 1);
+  std::memcpy(buffer.data() + 1, record_header.get_storage_location(), size);
+
+  BOOST_REQUIRE(validate_buffer<TriggerRecordHeaderData>(buffer.data() + 1, size).none());
+  BOOST_REQUIRE(has_failure(validate_buffer<TriggerRecordHeaderData>(buffer.data() + 1, size - 1),
+                            ValidationFailure::kSizeExceedsBuffer));
+  BOOST_REQUIRE(
+    has_failure(validate_buffer<TriggerRecordHeaderData>(buffer.data() + 1, 10), ValidationFailure::kTruncated));
+
+  components[2].window_begin = 3;
+  TriggerRecordHeader bad_header(components);
+  BOOST_REQUIRE(has_failure(validate_buffer<TriggerRecordHeaderData>(bad_header.get_storage_location(), size),
+                            ValidationFailure::kBadComponent));
+
+  auto fragment_header = make_valid_header();
+  std::memcpy(buffer.data() + 1, &fragment_header, sizeof(fragment_header));
+  BOOST_REQUIRE(validate_buffer<FragmentHeader>(buffer.data() + 1, fragment_header.size).none());
+  BOOST_REQUIRE(has_failure(validate_buffer<FragmentHeader>(buffer.data() + 1, sizeof(fragment_header)),
+                            ValidationFailure::kSizeExceedsBuffer));
+  BOOST_REQUIRE(has_failure(validate_buffer<TimeSliceHeader>(buffer.data() + 1, size), ValidationFailure::kBadMarker));
+}
+
+/**
+ * @brief Check the batched validation against the single-header one, at unaligned addresses and odd counts
+ */
+BOOST_AUTO_TEST_CASE(BatchValidation)
+{
+  const size_t count = 1003;
+  std::vector<char> storage(count * sizeof(FragmentHeader) + 1);
+  std::vector<const void*> headers(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto header = make_header(i * 13 % 11);
+    auto address = storage.data() + 1 + i * sizeof(FragmentHeader);
+    std::memcpy(address, &header, sizeof(header));
+    headers[i] = address;
+  }
+
+  auto bitmap = validate_fragments(headers.data(), count);
+  BOOST_REQUIRE_EQUAL(bitmap.size(), count);
+  BOOST_REQUIRE_EQUAL(bitmap.words().size(), 16);
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < count; ++i)
+    if (validate_buffer<FragmentHeader>(headers[i], s_unknown_buffer_size).any())
+      expected.push_back(i);
+  BOOST_REQUIRE(bitmap.failures() == expected);
+  BOOST_REQUIRE_EQUAL(bitmap.count(), expected.size());
+  for (size_t i = 0; i < count; ++i)
+    BOOST_REQUIRE_EQUAL(bitmap.test(i), validate_buffer<FragmentHeader>(headers[i], s_unknown_buffer_size).any());
+
+  std::vector<uint64_t> scalar(bitmap.words().size(), 0); // NOLINT(build/unsigned)
+  detail::validate_fragments_scalar(headers.data(), 0, count, scalar.data());
+  BOOST_REQUIRE(scalar == bitmap.words());
+
+  BOOST_REQUIRE(validate_fragments(headers.data(), 0).none());
+}
+
+/**
+ * @brief Check the batched validation of the Fragments of a TriggerRecord and a TimeSlice
+ */
+BOOST_AUTO_TEST_CASE(RecordValidation)
+{
+  TriggerRecord record(std::vector<ComponentRequest>{});
+  TimeSlice slice(1, 1);
+  std::vector<char> payload(10, 'x');
+  for (size_t i = 0; i < 600; ++i) {
+    auto fragment = std::make_unique<Fragment>(payload.data(), payload.size());
+    fragment->set_window_begin(i == 300 || i == 599 ? 5 : 0);
+    fragment->set_window_end(1);
+    slice.add_fragment(std::make_unique<Fragment>(const_cast<void*>(fragment->get_storage_location()),
+                                                  Fragment::BufferAdoptionMode::kCopyFromBuffer));
+    record.add_fragment(std::move(fragment));
+  }
+  BOOST_REQUIRE(validate_fragments(record).failures() == (std::vector<size_t>{ 300, 599 }));
+  BOOST_REQUIRE(validate_fragments(slice).failures() == (std::vector<size_t>{ 300, 599 }));
+  BOOST_REQUIRE(validate_fragments(TriggerRecord(std::vector<ComponentRequest>{})).none());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
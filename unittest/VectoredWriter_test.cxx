@@ -0,0 +1,140 @@
+/**
+ * @file VectoredWriter_test.cxx VectoredWriter class Unit Tests
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "daqdataformats/VectoredWriter.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE VectoredWriter_test // NOLINT
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace dunedaq::daqdataformats;
+
+namespace {
+/**
+ * @brief Append a buffer to a byte vector
+ */
+void
+append(std::vector<uint8_t>& bytes, const void* data, size_t size) // NOLINT(build/unsigned)
+{
+  auto base = static_cast<const uint8_t*>(data); // NOLINT(build/unsigned)
+  bytes.insert(bytes.end(), base, base + size);
+}
+
+/**
+ * @brief Read the whole content of a file
+ */
+std::vector<uint8_t> // NOLINT(build/unsigned)
+read_all(FILE* file)
+{
+  std::vector<uint8_t> bytes; // NOLINT(build/unsigned)
+  std::rewind(file);
+  int c;
+  while ((c = std::fgetc(file)) != EOF)
+    bytes.push_back(static_cast<uint8_t>(c)); // NOLINT(build/unsigned)
+  return bytes;
+}
+
+/**
+ * @brief Make a Fragment with a payload of the given size
+ */
+std::unique_ptr<Fragment>
+make_fragment(size_t size, uint8_t fill) // NOLINT(build/unsigned)
+{
+  std::vector<uint8_t> payload(size, fill); // NOLINT(build/unsigned)
+  auto fragment = std::make_unique<Fragment>(payload.data(), payload.size());
+  fragment->set_sequence_number(fill);
+  return fragment;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(VectoredWriter_test)
+
+/**
+ * @brief Check that a TriggerRecord with more Fragments than IOV_MAX is written as its concatenated storage
+ */
+BOOST_AUTO_TEST_CASE(ManyFragments)
+{
+  std::vector<ComponentRequest> components(3);
+  TriggerRecord record(components);
+  record.get_header_ref().set_trigger_number(99);
+  for (size_t i = 0; i < VectoredWriter::s_max_iovecs + 10; ++i)
+    record.add_fragment(make_fragment(1 + i % 7, static_cast<uint8_t>(i))); // NOLINT(build/unsigned)
+
+  std::vector<uint8_t> expected; // NOLINT(build/unsigned)
+  append(expected, record.get_header_ref().get_storage_location(), record.get_header_ref().get_total_size_bytes());
+  for (auto const& fragment : record.get_fragments_ref())
+    append(expected, fragment->get_storage_location(), fragment->get_size());
+  BOOST_REQUIRE_EQUAL(expected.size(), record.get_total_size_bytes());
+
+  FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  VectoredWriter writer(fileno(file));
+  writer.add(record);
+  BOOST_REQUIRE_EQUAL(writer.get_pending_bytes(), expected.size());
+  BOOST_REQUIRE_EQUAL(writer.flush(), expected.size());
+  BOOST_REQUIRE_EQUAL(writer.get_pending_bytes(), 0);
+  BOOST_REQUIRE_EQUAL(writer.flush(), 0);
+
+  auto bytes = read_all(file);
+  std::fclose(file);
+  BOOST_REQUIRE_EQUAL(bytes.size(), expected.size());
+  BOOST_REQUIRE(bytes == expected);
+}
+
+/**
+ * @brief Check that several objects are batched into one flush and that pwritev honours the offset
+ */
+BOOST_AUTO_TEST_CASE(BatchedAtOffset)
+{
+  TimeSlice timeslice(5, 6);
+  timeslice.add_fragment(make_fragment(10, 1));
+  timeslice.add_fragment(make_fragment(20, 2));
+  auto loose = make_fragment(30, 3);
+
+  std::vector<uint8_t> expected(100, 0); // NOLINT(build/unsigned)
+  auto header = timeslice.get_header();
+  append(expected, &header, sizeof(header));
+  for (auto const& fragment : timeslice.get_fragments_ref())
+    append(expected, fragment->get_storage_location(), fragment->get_size());
+  append(expected, loose->get_storage_location(), loose->get_size());
+
+  FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  VectoredWriter writer(fileno(file), 100);
+  writer.add(timeslice);
+  writer.add(*loose);
+  auto written = writer.flush();
+  BOOST_REQUIRE_EQUAL(written, expected.size() - 100);
+  BOOST_REQUIRE_EQUAL(writer.get_offset(), static_cast<off_t>(expected.size()));
+  BOOST_REQUIRE_EQUAL(writer.get_bytes_written(), written);
+
+  auto bytes = read_all(file);
+  std::fclose(file);
+  BOOST_REQUIRE(bytes == expected);
+}
+
+/**
+ * @brief Check that write errors are reported as std::system_error
+ */
+BOOST_AUTO_TEST_CASE(WriteError)
+{
+  VectoredWriter writer(-1);
+  auto fragment = make_fragment(10, 1);
+  BOOST_REQUIRE_THROW(writer.write(*fragment), std::system_error);
+  BOOST_REQUIRE_EQUAL(writer.get_pending_bytes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()